@@ -73,6 +73,11 @@ template<typename... Args> void log_debug(spdlog::format_string_t<Args...> log,
     spdlog::get(logging_details::global_logger_name)->debug(std::move(log), std::forward<Args>(packs)...);
 }
 
+/**
+ * @return true if the debug messages are logged : used to skip the formatting of costly debug messages (on hot paths)
+ */
+inline bool is_debug_logged() { return spdlog::get(logging_details::global_logger_name)->should_log(spdlog::level::debug); }
+
 /**
  * log a warning
  *
@@ -0,0 +1,173 @@
+// Dual Licensing Either :
+// - AGPL
+// or
+// - Subscription license for commercial usage (without requirement of licensing propagation).
+//   please contact ballandfys@protonmail.com for additional information about this subscription commercial licensing.
+//
+// Created by FyS on 18/10/26. License 2022-2026
+//
+// In the case no license has been purchased for the use (modification or distribution in any way) of the software stack
+// the APGL license is applying.
+//
+
+#include <algorithm>
+#include <cstring>
+
+#include "clause_cache.hh"
+
+namespace fabko::compiler::sat {
+
+namespace {
+
+constexpr std::uint64_t cached_state_version = 1;
+
+enum constraint_tag : std::uint64_t {
+    clause_tag      = 1,
+    cardinality_tag = 2,
+    xor_tag         = 3,
+};
+
+/**
+ * @return splitmix64 finalizer : avalanche of the bits of the value
+ */
+constexpr std::uint64_t mix(std::uint64_t value) {
+    value += 0x9e3779b97f4a7c15ULL;
+    value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+    return value ^ (value >> 31);
+}
+
+std::int64_t signed_value(const literal& lit) { return lit.is_off() ? -lit.value() : lit.value(); }
+
+/**
+ * @return hash of a set of literals (independent of their order) combined with the provided seed values
+ */
+std::uint64_t hash_literals(std::span<const literal> literals, std::initializer_list<std::uint64_t> seeds) {
+    auto values = literals | std::views::transform(signed_value) | std::ranges::to<std::vector>();
+    std::ranges::sort(values);
+    values.erase(std::ranges::unique(values).begin(), values.end());
+
+    std::uint64_t hash = 0;
+    for (const auto seed : seeds) {
+        hash = mix(hash ^ seed);
+    }
+    for (const auto value : values) {
+        hash = mix(hash ^ static_cast<std::uint64_t>(value));
+    }
+    return hash;
+}
+
+/**
+ * @brief reader of a sequence of 64 bits words, reading out of bounds is reported instead of being undefined
+ */
+class word_reader {
+  public:
+    explicit word_reader(std::string_view data)
+        : data_(data) {}
+
+    std::optional<std::uint64_t> next() {
+        if (data_.size() - position_ < sizeof(std::uint64_t)) {
+            return std::nullopt;
+        }
+        std::uint64_t word {};
+        std::memcpy(&word, data_.data() + position_, sizeof(std::uint64_t));
+        position_ += sizeof(std::uint64_t);
+        return word;
+    }
+
+    [[nodiscard]] bool can_read(std::uint64_t words) const { return words <= (data_.size() - position_) / sizeof(std::uint64_t); }
+
+  private:
+    std::string_view data_;
+    std::size_t position_ {0};
+};
+
+} // namespace
+
+model_fingerprint make_fingerprint(const model& m) {
+    model_fingerprint fingerprint;
+    fingerprint.constraints.reserve(m.clauses.size() + m.cardinalities.size() + m.xors.size());
+    for (const auto& clause : m.clauses) {
+        fingerprint.constraints.push_back(hash_literals(clause, {clause_tag}));
+    }
+    for (const auto& [literals, at_most, at_least] : m.cardinalities) {
+        fingerprint.constraints.push_back(hash_literals(literals, {cardinality_tag, at_most, at_least.value_or(0)}));
+    }
+    for (const auto& [literals, parity] : m.xors) {
+        fingerprint.constraints.push_back(hash_literals(literals, {xor_tag, parity ? 1U : 0U}));
+    }
+    std::ranges::sort(fingerprint.constraints);
+    fingerprint.constraints.erase(std::ranges::unique(fingerprint.constraints).begin(), fingerprint.constraints.end());
+
+    fingerprint.hash = std::ranges::fold_left(fingerprint.constraints, mix(fingerprint.constraints.size()), [](std::uint64_t res, std::uint64_t h) { //
+        return mix(res ^ h);
+    });
+    return fingerprint;
+}
+
+std::string serialize(const cached_solver_state& state) {
+    std::vector<std::uint64_t> words;
+    words.push_back(cached_state_version);
+    words.push_back(state.fingerprint.hash);
+    words.push_back(state.fingerprint.constraints.size());
+    words.insert(words.end(), state.fingerprint.constraints.begin(), state.fingerprint.constraints.end());
+    words.push_back(state.learned.size());
+    for (const auto& [literals, lbd] : state.learned) {
+        words.push_back(lbd);
+        words.push_back(literals.size());
+        std::ranges::transform(literals, std::back_inserter(words), [](const literal& l) { return static_cast<std::uint64_t>(signed_value(l)); });
+    }
+    words.push_back(state.phases.size());
+    std::ranges::transform(state.phases, std::back_inserter(words), [](const literal& l) { return static_cast<std::uint64_t>(signed_value(l)); });
+
+    return std::string {reinterpret_cast<const char*>(words.data()), words.size() * sizeof(std::uint64_t)};
+}
+
+std::optional<cached_solver_state> deserialize_cached_state(std::string_view data) {
+    word_reader reader {data};
+    if (reader.next() != cached_state_version) {
+        return std::nullopt;
+    }
+
+    cached_solver_state state;
+    const auto hash  = reader.next();
+    const auto count = reader.next();
+    if (!hash.has_value() || !count.has_value() || !reader.can_read(count.value())) {
+        return std::nullopt;
+    }
+    state.fingerprint.hash = hash.value();
+    state.fingerprint.constraints.reserve(count.value());
+    for (std::uint64_t i = 0; i < count.value(); ++i) {
+        state.fingerprint.constraints.push_back(reader.next().value());
+    }
+
+    const auto learned_count = reader.next();
+    if (!learned_count.has_value()) {
+        return std::nullopt;
+    }
+    for (std::uint64_t i = 0; i < learned_count.value(); ++i) {
+        const auto lbd  = reader.next();
+        const auto size = reader.next();
+        if (!lbd.has_value() || !size.has_value() || !reader.can_read(size.value())) {
+            return std::nullopt;
+        }
+        lbd_clause learned {.lbd = static_cast<std::uint32_t>(lbd.value())};
+        learned.literals.reserve(size.value());
+        for (std::uint64_t l = 0; l < size.value(); ++l) {
+            learned.literals.emplace_back(static_cast<std::int64_t>(reader.next().value()));
+        }
+        state.learned.push_back(std::move(learned));
+    }
+
+    const auto phase_count = reader.next();
+    if (!phase_count.has_value() || !reader.can_read(phase_count.value())) {
+        return std::nullopt;
+    }
+    state.phases.reserve(phase_count.value());
+    for (std::uint64_t i = 0; i < phase_count.value(); ++i) {
+        state.phases.emplace_back(static_cast<std::int64_t>(reader.next().value()));
+    }
+    return state;
+}
+
+} // namespace fabko::compiler::sat
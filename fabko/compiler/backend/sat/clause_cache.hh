@@ -0,0 +1,186 @@
+// Dual Licensing Either :
+// - AGPL
+// or
+// - Subscription license for commercial usage (without requirement of licensing propagation).
+//   please contact ballandfys@protonmail.com for additional information about this subscription commercial licensing.
+//
+// Created by FyS on 18/10/26. License 2022-2026
+//
+// In the case no license has been purchased for the use (modification or distribution in any way) of the software stack
+// the APGL license is applying.
+//
+
+#ifndef CLAUSE_CACHE_HH
+#define CLAUSE_CACHE_HH
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "common/exception.hh"
+#include "common/logging.hh"
+#include "datastore/key_value_db.hh"
+
+#include "solver.hh"
+
+namespace fabko::compiler::sat {
+
+/**
+ * @brief hashes of the constraints of a model, independent of the order of the constraints and of the literals within a constraint
+ */
+struct model_fingerprint {
+    std::uint64_t hash {};                      //!< hash of the whole set of constraints
+    std::vector<std::uint64_t> constraints {};  //!< sorted (and deduplicated) hash of each constraint (clauses and cardinality constraints)
+
+    /**
+     * @return true if every constraint of this fingerprint is part of the other fingerprint
+     */
+    [[nodiscard]] bool is_subset_of(const model_fingerprint& other) const { return std::ranges::includes(other.constraints, constraints); }
+};
+
+/**
+ * @return fingerprint of the constraints of a model
+ */
+[[nodiscard]] model_fingerprint make_fingerprint(const model& m);
+
+/**
+ * @brief state of a solver cached for a model : what is needed to warm start a new resolution of the same model
+ */
+struct cached_solver_state {
+    model_fingerprint fingerprint;   //!< fingerprint of the model the state comes from
+    std::vector<lbd_clause> learned; //!< learned clauses of low LBD
+    std::vector<literal> phases;     //!< saved phases at the end of the resolution
+};
+
+[[nodiscard]] std::string serialize(const cached_solver_state& state);
+[[nodiscard]] std::optional<cached_solver_state> deserialize_cached_state(std::string_view data);
+
+struct clause_cache_configuration {
+    std::uint32_t max_lbd {6};                //!< only the learned clauses of LBD lower or equal to this value are cached
+    std::size_t max_clauses {10000};          //!< maximum number of learned clauses cached for a model (the lowest LBD are kept)
+    std::size_t max_superset_candidates {16}; //!< number of most recently cached models checked when looking for a subset of a model
+    std::string key_prefix {"fabko/sat/clause_cache/"};
+};
+
+/**
+ * @brief Persistent cache of learned clauses keyed by the fingerprint of the model
+ *
+ * Agents submit near-identical planning queries : the clauses learned (of low LBD) and the phases saved by the resolution of a model are stored
+ * in a key-value datastore (as kv_rocksdb), a new solver on the same model is then seeded with them and starts warm. As learned clauses are
+ * implied by the model they were learned on, they are still valid for any model containing it : a model that is a superset of a cached one is
+ * seeded as well (the most recently cached candidates are checked).
+ *
+ * @note a missing key must be reported by the store either as an empty value or by an exception (it is then a cache miss)
+ * @note with a transactional store the transaction has to be committed by the caller
+ * @tparam Store key-value store (as kv_rocksdb::transaction)
+ */
+template<DbInteractivePolicy Store>
+class clause_cache {
+  public:
+    explicit clause_cache(Store& store, clause_cache_configuration config = {})
+        : store_(store)
+        , config_(std::move(config)) {}
+
+    /**
+     * @brief cache the learned clauses and saved phases of a solver for the model it solved
+     * @param m model solved by the solver (the model provided to the solver, with its additional clauses)
+     * @param s solver to cache the state of
+     */
+    void store(const model& m, const solver& s) {
+        cached_solver_state state {
+            .fingerprint = make_fingerprint(m),
+            .learned     = s.learned_clauses(config_.max_lbd),
+            .phases      = s.saved_phases(),
+        };
+        if (state.learned.size() > config_.max_clauses) {
+            std::ranges::stable_sort(state.learned, {}, &lbd_clause::lbd);
+            state.learned.resize(config_.max_clauses);
+        }
+        const auto key = entry_key(state.fingerprint.hash);
+        store_.set({key, serialize(state)});
+
+        // index of the most recently cached models, candidates of the superset lookup (older entries are still found on an exact match)
+        auto index = read_index();
+        std::erase(index, state.fingerprint.hash);
+        index.push_back(state.fingerprint.hash);
+        if (index.size() > config_.max_superset_candidates) {
+            index.erase(index.begin(), index.end() - static_cast<std::ptrdiff_t>(config_.max_superset_candidates));
+        }
+        write_index(index);
+        log_debug("clause cache :: {} learned clauses stored for model {:016x}", state.learned.size(), state.fingerprint.hash);
+    }
+
+    /**
+     * @return cached state of the model, or of a cached model it is a superset of, std::nullopt if none is found
+     */
+    [[nodiscard]] std::optional<cached_solver_state> lookup(const model& m) {
+        const auto fingerprint = make_fingerprint(m);
+        if (auto state = read_entry(fingerprint.hash); state.has_value() && state->fingerprint.constraints == fingerprint.constraints) {
+            return state;
+        }
+        const auto index = read_index();
+        for (const auto hash : index | std::views::reverse) {
+            if (hash == fingerprint.hash) {
+                continue;
+            }
+            if (auto state = read_entry(hash); state.has_value() && state->fingerprint.is_subset_of(fingerprint)) {
+                return state;
+            }
+        }
+        return std::nullopt;
+    }
+
+    /**
+     * @brief seed a solver with the cached state of its model (or of a subset of it) if any
+     * @return number of learned clauses seeded into the solver
+     */
+    std::size_t seed(const model& m, solver& s) {
+        const auto state = lookup(m);
+        if (!state.has_value()) {
+            return 0;
+        }
+        return s.seed(state->learned, state->phases);
+    }
+
+  private:
+    [[nodiscard]] std::string entry_key(std::uint64_t hash) const { return config_.key_prefix + fmt::format("{:016x}", hash); }
+    [[nodiscard]] std::string index_key() const { return config_.key_prefix + "index"; }
+
+    [[nodiscard]] std::string read(const std::string& key) {
+        try {
+            return store_.get(key);
+        } catch (const fabko::exception&) {
+            return {}; // missing key
+        }
+    }
+
+    [[nodiscard]] std::optional<cached_solver_state> read_entry(std::uint64_t hash) {
+        const auto data = read(entry_key(hash));
+        return data.empty() ? std::nullopt : deserialize_cached_state(data);
+    }
+
+    [[nodiscard]] std::vector<std::uint64_t> read_index() {
+        const auto data = read(index_key());
+        std::vector<std::uint64_t> index(data.size() / sizeof(std::uint64_t));
+        std::memcpy(index.data(), data.data(), index.size() * sizeof(std::uint64_t));
+        return index;
+    }
+
+    void write_index(const std::vector<std::uint64_t>& index) {
+        store_.set({index_key(), std::string {reinterpret_cast<const char*>(index.data()), index.size() * sizeof(std::uint64_t)}});
+    }
+
+    Store& store_;
+    clause_cache_configuration config_;
+};
+
+} // namespace fabko::compiler::sat
+
+#endif // CLAUSE_CACHE_HH
@@ -0,0 +1,220 @@
+// Dual Licensing Either :
+// - AGPL
+// or
+// - Subscription license for commercial usage (without requirement of licensing propagation).
+//   please contact ballandfys@protonmail.com for additional information about this subscription commercial licensing.
+//
+// Created by FyS on 18/10/26. License 2022-2026
+//
+// In the case no license has been purchased for the use (modification or distribution in any way) of the software stack
+// the APGL license is applying.
+//
+
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define FABKO_SIMD_X86
+#endif
+
+#include "common/exception.hh"
+#include "solver.hh"
+
+#include "clause_kernels.hh"
+
+namespace fabko::compiler::sat {
+
+namespace {
+
+// scalar kernels
+
+[[nodiscard]] constexpr std::uint8_t satisfying_bits(std::uint32_t lit) { return static_cast<std::uint8_t>((lit & 1u) + 1u); }
+[[nodiscard]] constexpr std::uint8_t falsifying_bits(std::uint32_t lit) { return static_cast<std::uint8_t>(2u - (lit & 1u)); }
+
+bool any_satisfied_scalar(const std::uint32_t* lits, std::size_t size, const std::uint8_t* values) {
+    return std::any_of(lits, lits + size, [values](std::uint32_t lit) { return (values[lit >> 1] & satisfying_bits(lit)) != 0; });
+}
+
+bool all_falsified_scalar(const std::uint32_t* lits, std::size_t size, const std::uint8_t* values) {
+    return std::all_of(lits, lits + size, [values](std::uint32_t lit) { return (values[lit >> 1] & falsifying_bits(lit)) != 0; });
+}
+
+#ifdef FABKO_SIMD_X86
+
+// SSE4.1 kernels : there is no gather instruction, the 4 assignments are loaded one by one and evaluated together
+
+__attribute__((target("sse4.1"))) inline __m128i load_values_sse4(__m128i variables, const std::uint8_t* values) {
+    return _mm_setr_epi32(values[_mm_extract_epi32(variables, 0)],
+        values[_mm_extract_epi32(variables, 1)],
+        values[_mm_extract_epi32(variables, 2)],
+        values[_mm_extract_epi32(variables, 3)]);
+}
+
+__attribute__((target("sse4.1"))) bool any_satisfied_sse4(const std::uint32_t* lits, std::size_t size, const std::uint8_t* values) {
+    const __m128i one = _mm_set1_epi32(1);
+    std::size_t index = 0;
+    for (; index + 4 <= size; index += 4) {
+        const __m128i packed     = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lits + index));
+        const __m128i satisfying = _mm_add_epi32(_mm_and_si128(packed, one), one);
+        const __m128i assigned   = load_values_sse4(_mm_srli_epi32(packed, 1), values);
+        if (!_mm_testz_si128(assigned, satisfying)) {
+            return true;
+        }
+    }
+    return any_satisfied_scalar(lits + index, size - index, values);
+}
+
+__attribute__((target("sse4.1"))) bool all_falsified_sse4(const std::uint32_t* lits, std::size_t size, const std::uint8_t* values) {
+    const __m128i one = _mm_set1_epi32(1);
+    const __m128i two = _mm_set1_epi32(2);
+    std::size_t index = 0;
+    for (; index + 4 <= size; index += 4) {
+        const __m128i packed     = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lits + index));
+        const __m128i falsifying = _mm_sub_epi32(two, _mm_and_si128(packed, one));
+        const __m128i assigned   = load_values_sse4(_mm_srli_epi32(packed, 1), values);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(assigned, falsifying), _mm_setzero_si128())) != 0) {
+            return false;
+        }
+    }
+    return all_falsified_scalar(lits + index, size - index, values);
+}
+
+// AVX2 kernels : the assignments of 8 literals are gathered at once (4 bytes are read at each address, the assignment is the low byte)
+
+__attribute__((target("avx2"))) inline __m256i gather_values_avx2(__m256i variables, const std::uint8_t* values) {
+    const __m256i gathered = _mm256_i32gather_epi32(reinterpret_cast<const int*>(values), variables, 1);
+    return _mm256_and_si256(gathered, _mm256_set1_epi32(0xFF));
+}
+
+__attribute__((target("avx2"))) bool any_satisfied_avx2(const std::uint32_t* lits, std::size_t size, const std::uint8_t* values) {
+    const __m256i one = _mm256_set1_epi32(1);
+    std::size_t index = 0;
+    for (; index + 8 <= size; index += 8) {
+        const __m256i packed     = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lits + index));
+        const __m256i satisfying = _mm256_add_epi32(_mm256_and_si256(packed, one), one);
+        const __m256i assigned   = gather_values_avx2(_mm256_srli_epi32(packed, 1), values);
+        if (!_mm256_testz_si256(assigned, satisfying)) {
+            return true;
+        }
+    }
+    return any_satisfied_scalar(lits + index, size - index, values);
+}
+
+__attribute__((target("avx2"))) bool all_falsified_avx2(const std::uint32_t* lits, std::size_t size, const std::uint8_t* values) {
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i two = _mm256_set1_epi32(2);
+    std::size_t index = 0;
+    for (; index + 8 <= size; index += 8) {
+        const __m256i packed     = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lits + index));
+        const __m256i falsifying = _mm256_sub_epi32(two, _mm256_and_si256(packed, one));
+        const __m256i assigned   = gather_values_avx2(_mm256_srli_epi32(packed, 1), values);
+        if (_mm256_movemask_epi8(_mm256_cmpeq_epi32(_mm256_and_si256(assigned, falsifying), _mm256_setzero_si256())) != 0) {
+            return false;
+        }
+    }
+    return all_falsified_scalar(lits + index, size - index, values);
+}
+
+#endif // FABKO_SIMD_X86
+
+using clause_kernel = bool (*)(const std::uint32_t*, std::size_t, const std::uint8_t*);
+
+clause_kernel any_satisfied_kernel(simd_level level) {
+#ifdef FABKO_SIMD_X86
+    switch (level) {
+        case simd_level::avx2: return any_satisfied_avx2;
+        case simd_level::sse4: return any_satisfied_sse4;
+        case simd_level::scalar: break;
+    }
+#endif
+    return any_satisfied_scalar;
+}
+
+clause_kernel all_falsified_kernel(simd_level level) {
+#ifdef FABKO_SIMD_X86
+    switch (level) {
+        case simd_level::avx2: return all_falsified_avx2;
+        case simd_level::sse4: return all_falsified_sse4;
+        case simd_level::scalar: break;
+    }
+#endif
+    return all_falsified_scalar;
+}
+
+simd_level detect_simd_level() {
+#ifdef FABKO_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return simd_level::avx2;
+    }
+    if (__builtin_cpu_supports("sse4.1")) {
+        return simd_level::sse4;
+    }
+#endif
+    return simd_level::scalar;
+}
+
+} // namespace
+
+std::string to_string(simd_level level) {
+    switch (level) {
+        case simd_level::avx2: return "avx2";
+        case simd_level::sse4: return "sse4";
+        case simd_level::scalar: break;
+    }
+    return "scalar";
+}
+
+simd_level detected_simd_level() {
+    static const simd_level level = detect_simd_level();
+    return level;
+}
+
+bool any_satisfied(std::span<const std::uint32_t> literals, const std::uint8_t* values, simd_level level) {
+    return any_satisfied_kernel(level)(literals.data(), literals.size(), values);
+}
+
+bool all_falsified(std::span<const std::uint32_t> literals, const std::uint8_t* values, simd_level level) {
+    return all_falsified_kernel(level)(literals.data(), literals.size(), values);
+}
+
+void pack_assignment(const solver_context& ctx, std::vector<std::uint8_t>& values) {
+    values.assign(ctx.vars_soa_.size() + packed_assignment_padding, packed_unassigned);
+    for (const auto& soa_struct : ctx.vars_soa_) {
+        const auto value = get<soa_assignment>(soa_struct);
+        if (value != assignment::not_assigned) {
+            values[soa_struct.struct_id().offset] = value == assignment::on ? packed_on : packed_off;
+        }
+    }
+}
+
+void packed_clauses::sync(const solver_context& ctx) {
+    fabko_assert(ctx.vars_soa_.size() <= (std::size_t {1} << 31), "too many variables to be packed on 32 bits");
+    if (ctx.clause_ids_.size() < size()) {
+        clear(); // the clause storage has been reduced since the last sync
+    }
+    for (std::size_t index = size(); index < ctx.clause_ids_.size(); ++index) {
+        for (const auto& [lit, varid] : get<soa_clause>(ctx.clauses_soa_[ctx.clause_ids_[index]]).get_literals()) {
+            literals_.push_back(static_cast<std::uint32_t>(varid.offset << 1) | (lit.is_off() ? 1u : 0u));
+        }
+        offsets_.push_back(literals_.size());
+    }
+}
+
+void packed_clauses::clear() {
+    literals_.clear();
+    offsets_.assign(1, 0);
+}
+
+bool packed_clauses::all_satisfied(const std::vector<std::uint8_t>& values, simd_level level) const {
+    fabko_assert(values.size() >= packed_assignment_padding, "the packed assignment has to be padded");
+    const auto kernel = any_satisfied_kernel(level);
+    for (std::size_t index = 0; index < size(); ++index) {
+        if (!kernel(literals_.data() + offsets_[index], offsets_[index + 1] - offsets_[index], values.data())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace fabko::compiler::sat
@@ -0,0 +1,110 @@
+// Dual Licensing Either :
+// - AGPL
+// or
+// - Subscription license for commercial usage (without requirement of licensing propagation).
+//   please contact ballandfys@protonmail.com for additional information about this subscription commercial licensing.
+//
+// Created by FyS on 18/10/26. License 2022-2026
+//
+// In the case no license has been purchased for the use (modification or distribution in any way) of the software stack
+// the APGL license is applying.
+//
+
+#ifndef CLAUSE_KERNELS_HH
+#define CLAUSE_KERNELS_HH
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace fabko::compiler::sat {
+
+struct solver_context;
+
+//
+// Packed clause evaluation
+//
+// A packed literal is a 32-bit value (variable << 1 | negated) where the variable is the offset of the variable in the solver variables soa.
+// A packed assignment is a byte per variable : packed_on, packed_off or packed_unassigned. A packed literal is satisfied if the assignment of its
+// variable has the bit (negated + 1) set, it is falsified if it has the bit (2 - negated) set : the evaluation of a literal is branch-free, it
+// is evaluated 8 literals at a time with AVX2 (gathering the assignments) and 4 literals at a time with SSE4.1.
+
+inline constexpr std::uint8_t packed_unassigned = 0;
+inline constexpr std::uint8_t packed_on         = 1;
+inline constexpr std::uint8_t packed_off        = 2;
+
+//! number of bytes a packed assignment has to be padded with : the AVX2 gather reads 4 bytes at the address of the assignment of a variable
+inline constexpr std::size_t packed_assignment_padding = 3;
+
+enum class simd_level {
+    scalar, //!< literal by literal evaluation
+    sse4,   //!< SSE4.1 kernels (4 literals at a time)
+    avx2,   //!< AVX2 gather based kernels (8 literals at a time)
+};
+[[nodiscard]] std::string to_string(simd_level level);
+
+/**
+ * @return highest instruction set supported by the running CPU (detected once), the kernels are dispatched on it
+ */
+[[nodiscard]] simd_level detected_simd_level();
+
+/**
+ * @return true if at least one of the packed literals is satisfied by the packed assignment
+ * @note the packed assignment has to be padded (see packed_assignment_padding)
+ */
+[[nodiscard]] bool any_satisfied(std::span<const std::uint32_t> literals, const std::uint8_t* values, simd_level level = detected_simd_level());
+
+/**
+ * @return true if every packed literal is falsified by the packed assignment (the clause is in conflict)
+ * @note the packed assignment has to be padded (see packed_assignment_padding)
+ */
+[[nodiscard]] bool all_falsified(std::span<const std::uint32_t> literals, const std::uint8_t* values, simd_level level = detected_simd_level());
+
+/**
+ * @brief fill the buffer with the packed assignment of the variables of the solver (indexed by their offset in the variables soa, padded)
+ */
+void pack_assignment(const solver_context& ctx, std::vector<std::uint8_t>& values);
+
+/**
+ * @brief Clause database of a solver packed in a contiguous array, evaluated by the SIMD kernels
+ *
+ * The clauses are stored contiguously (compressed sparse rows) to make a full scan of the database (the verification of a model) bound by the
+ * memory bandwidth. The database follows the clause storage of the solver lazily : the clauses added to the solver since the last scan are
+ * packed on sync.
+ */
+class packed_clauses {
+  public:
+    /**
+     * @brief pack the clauses of the solver (solver_context::clause_ids_) not packed yet
+     * @note if the clause storage of the solver has been reduced, the whole database is packed again
+     */
+    void sync(const solver_context& ctx);
+
+    /**
+     * @brief remove every packed clause (the next sync packs the whole clause storage again)
+     */
+    void clear();
+
+    /**
+     * @return true if every clause has at least a literal satisfied by the packed assignment
+     */
+    [[nodiscard]] bool all_satisfied(const std::vector<std::uint8_t>& values, simd_level level = detected_simd_level()) const;
+
+    [[nodiscard]] std::size_t size() const { return offsets_.size() - 1; }
+
+    /**
+     * @return packed literals of a clause
+     */
+    [[nodiscard]] std::span<const std::uint32_t> literals_of(std::size_t index) const {
+        return std::span {literals_}.subspan(offsets_[index], offsets_[index + 1] - offsets_[index]);
+    }
+
+  private:
+    std::vector<std::uint32_t> literals_ {}; //!< packed literals of every clause, contiguously
+    std::vector<std::size_t> offsets_ {0};   //!< index of the first literal of each clause in literals_ (followed by the end of the last one)
+};
+
+} // namespace fabko::compiler::sat
+
+#endif // CLAUSE_KERNELS_HH
@@ -13,22 +13,60 @@
 #ifndef CLI_HH
 #define CLI_HH
 
+#include <charconv>
+#include <chrono>
 #include <fil/cli/command_line_interface.hh>
 #include <filesystem>
+#include <optional>
 #include <fmt/format.h>
 
 #include "common/logging.hh"
+#include "compiler/backend/sat/local_search.hh"
+#include "compiler/backend/sat/parallel_solver.hh"
 #include "compiler/backend/sat/solver.hh"
 
 namespace fabko::compiler::sat {
 
+struct cli_limits {
+    std::optional<std::chrono::seconds> time_limit {}; //!< time limit applied on the resolution of each file
+    std::optional<std::size_t> conflict_budget {};     //!< conflict budget applied on the resolution of each file
+};
+
+struct cli_proof {
+    std::optional<std::filesystem::path> file {}; //!< file the DRAT proof is written into (suffixed by the CNF file name if several files are processed)
+    proof_format format {proof_format::drat};
+};
+
+enum class cli_local_search {
+    disabled,   //!< CDCL only
+    standalone, //!< local search first, the CDCL is used if no solution is found by the local search
+    rephase,    //!< CDCL with saved phases seeded by the local search
+};
+
+/**
+ * @return value of a numeric option, or std::nullopt if the value is not an unsigned number
+ */
+inline std::optional<std::uint64_t> parse_number_option(const std::string& value) {
+    std::uint64_t res    = 0;
+    const auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), res);
+    if (ec != std::errc {} || end != value.data() + value.size()) {
+        return std::nullopt;
+    }
+    return res;
+}
+
 inline fil::sub_command make_cli() {
 
-    auto files = std::make_shared<std::vector<std::filesystem::path>>();
+    auto files   = std::make_shared<std::vector<std::filesystem::path>>();
+    auto limits  = std::make_shared<cli_limits>();
+    auto ls      = std::make_shared<cli_local_search>(cli_local_search::disabled);
+    auto proof   = std::make_shared<cli_proof>();
+    auto profile = std::make_shared<solver_profile>(solver_profile::dynamic);
+    auto threads = std::make_shared<std::size_t>(1);
 
     fil::sub_command command_sat(
         "sat",
-        [files] { //
+        [files, limits, ls, proof, profile, threads] { //
             log_info("execution of the SAT solver command line interface");
             if (files->empty()) {
                 log_error("no file provided to the SAT solver, please use --cnf-file or -c option to provide a file");
@@ -37,12 +75,76 @@ inline fil::sub_command make_cli() {
             log_info("file to process count : {}", files->size());
             for (const auto& cnf_file : *files) {
                 log_info("processing file: {}", cnf_file.string());
+
+                solve_limits solving_limits = limits->time_limit.has_value() ? solve_limits::with_time_limit(limits->time_limit.value()) : solve_limits {};
+                solving_limits.conflict_budget = limits->conflict_budget;
+
+                solver_context::configuration conf {};
+                conf.local_search_rephasing = (*ls == cli_local_search::rephase);
+                conf.profile                = *profile;
+
+                auto solve_cdcl = [&](solver& solver) {
+                    std::optional<std::filesystem::path> proof_file = proof->file;
+                    if (proof_file.has_value() && files->size() > 1) {
+                        proof_file->concat("." + cnf_file.stem().string());
+                    }
+                    if (proof_file.has_value() && !solver.start_proof(proof_file.value(), proof->format).has_value()) {
+                        log_error("cannot write the proof of {} into {}", cnf_file.string(), proof_file->string());
+                        proof_file.reset();
+                    }
+
+                    auto results = solver.solve(1, solving_limits);
+                    if (results.empty()) {
+                        log_warn("no solution found for {}", cnf_file.string());
+                    }
+                    if (proof_file.has_value()) {
+                        if (solver.close_proof().has_value()) {
+                            log_info("proof of {} written into {}", cnf_file.string(), proof_file->string());
+                        } else {
+                            log_error("failed to write the proof of {} into {}", cnf_file.string(), proof_file->string());
+                        }
+                    }
+                    log_info("statistics for {} :: {}", cnf_file.string(), to_string(solver.statistics()));
+                };
+
+                if (*ls != cli_local_search::standalone && *threads <= 1) {
+                    // the clauses are parsed in parallel chunks straight into the solver
+                    auto solver = make_solver_from_cnf_file(cnf_file, std::move(conf));
+                    solve_cdcl(solver);
+                    continue;
+                }
+
+                // the standalone local search and the parallel solver work on the model of the file
                 auto model = make_model_from_cnf_file(cnf_file);
-                solver solver {std::move(model)};
-                auto results = solver.solve(1);
-                if (results.empty()) {
-                    log_warn("no solution found for {}", cnf_file.string());
+                if (*ls == cli_local_search::standalone) {
+                    local_search search {model};
+                    if (const auto res = search.search({}, solving_limits); res.has_value()) {
+                        log_info("solution found by local search for {} after {} flips : {}", cnf_file.string(), search.flips(), to_string(res.value()));
+                        continue;
+                    }
+                    log_info("local search did not find a solution for {} (best assignment falsifies {} clauses), fallback on CDCL",
+                        cnf_file.string(),
+                        search.best_falsified_count());
+                }
+                model.conf = std::move(conf);
+
+                if (*threads > 1) {
+                    if (proof->file.has_value()) {
+                        log_warn("the proof is not written by the parallel solver");
+                    }
+                    parallel_solver solver {std::move(model), {.threads = *threads}};
+                    if (const auto res = solver.solve(solving_limits); res.has_value()) {
+                        log_info("solution found for {} : {}", cnf_file.string(), to_string(res.value()));
+                    } else {
+                        log_warn("no solution found for {}", cnf_file.string());
+                    }
+                    for (std::size_t worker = 0; worker < solver.worker_count(); ++worker) {
+                        log_info("statistics for {} (worker {}) :: {}", cnf_file.string(), worker, to_string(solver.worker_statistics(worker)));
+                    }
+                    continue;
                 }
+                solver solver {std::move(model)};
+                solve_cdcl(solver);
             }
         },
         "SAT solver cli command");
@@ -58,6 +160,80 @@ inline fil::sub_command make_cli() {
             files->emplace_back(std::move(cnf_file));
         },
         "File in CNF format to be process by the SAT solver"});
+    command_sat.add_option(fil::option {     //
+        "--time-limit",
+        "-t",
+        [limits](const std::string& value) { //
+            const auto seconds = parse_number_option(value);
+            if (!seconds.has_value()) {
+                log_error("invalid time limit {}, expected a number of seconds", value);
+                return;
+            }
+            limits->time_limit = std::chrono::seconds {static_cast<std::chrono::seconds::rep>(seconds.value())};
+        },
+        "Time limit in seconds for the resolution of each CNF file, the result is unknown if reached"});
+    command_sat.add_option(fil::option {     //
+        "--conflict-budget",
+        [limits](const std::string& value) { //
+            const auto budget = parse_number_option(value);
+            if (!budget.has_value()) {
+                log_error("invalid conflict budget {}, expected a number of conflicts", value);
+                return;
+            }
+            limits->conflict_budget = budget.value();
+        },
+        "Maximum number of conflicts for the resolution of each CNF file, the result is unknown if reached"});
+    command_sat.add_option(fil::option { //
+        "--local-search",
+        [ls](const std::string& value) { //
+            if (value == "standalone") {
+                *ls = cli_local_search::standalone;
+            } else if (value == "rephase") {
+                *ls = cli_local_search::rephase;
+            } else {
+                log_error("invalid local search mode {}, expected 'standalone' or 'rephase'", value);
+            }
+        },
+        "Local search mode : 'standalone' (local search first, CDCL as fallback) or 'rephase' (CDCL with phases seeded by the local search)"});
+    command_sat.add_option(fil::option { //
+        "--proof",
+        [proof](const std::string& value) { //
+            proof->file = std::filesystem::path {value};
+        },
+        "File the DRAT proof of the resolution is written into, it certifies an unsatisfiable answer (checkable with drat-trim)"});
+    command_sat.add_option(fil::option { //
+        "--proof-format",
+        [proof](const std::string& value) { //
+            if (value == "drat") {
+                proof->format = proof_format::drat;
+            } else if (value == "binary") {
+                proof->format = proof_format::binary_drat;
+            } else {
+                log_error("invalid proof format {}, expected 'drat' or 'binary'", value);
+            }
+        },
+        "Format of the proof : 'drat' (textual, default) or 'binary' (binary DRAT)"});
+    command_sat.add_option(fil::option { //
+        "--profile",
+        [profile](const std::string& value) { //
+            if (const auto selected = profile_from_name(value); selected.has_value()) {
+                *profile = selected.value();
+            } else {
+                log_error("invalid solver profile {}, expected 'dynamic', 'planning', 'unsat-heavy' or 'minimal'", value);
+            }
+        },
+        "Specialization of the solver : 'dynamic' (runtime configuration, default), 'planning', 'unsat-heavy' or 'minimal'"});
+    command_sat.add_option(fil::option {     //
+        "--threads",
+        [threads](const std::string& value) { //
+            const auto count = parse_number_option(value);
+            if (!count.has_value() || count.value() == 0) {
+                log_error("invalid number of threads {}, expected a positive number", value);
+                return;
+            }
+            *threads = count.value();
+        },
+        "Number of threads of the deterministic parallel solver (1 by default : sequential solver), the answer only depends on this number"});
 
     return command_sat;
 }
@@ -0,0 +1,274 @@
+// Dual Licensing Either :
+// - AGPL
+// or
+// - Subscription license for commercial usage (without requirement of licensing propagation).
+//   please contact ballandfys@protonmail.com for additional information about this subscription commercial licensing.
+//
+// Created by FyS on 18/10/26. License 2022-2026
+//
+// In the case no license has been purchased for the use (modification or distribution in any way) of the software stack
+// the APGL license is applying.
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <ranges>
+
+#include "common/logging.hh"
+
+#include "local_search.hh"
+
+namespace fabko::compiler::sat {
+
+namespace {
+
+constexpr std::uint32_t encode(std::uint32_t var, bool negated) { return (var << 1) | (negated ? 1 : 0); }
+constexpr std::uint32_t var_of(std::uint32_t lit) { return lit >> 1; }
+
+} // namespace
+
+local_search::local_search(const model& m, local_search_configuration config)
+    : model_(m)
+    , config_(config)
+    , random_(config.seed) {
+
+    add_variables(m.literals);
+    add_constraint_variables();
+    clauses_.reserve(m.clauses.size());
+    for (const auto& model_clause : m.clauses) {
+        add_clause(model_clause);
+    }
+    build_occurrences();
+}
+
+local_search::local_search(const solver_context& ctx, local_search_configuration config)
+    : model_(ctx.model_.get())
+    , config_(config)
+    , random_(config.seed) {
+
+    add_variables(model_.literals);
+    add_constraint_variables();
+    const auto learned_mask = ctx.learned_clause_mask();
+    clauses_.reserve(ctx.clause_ids_.size() - ctx.learned_clauses_.size());
+    for (std::size_t clause_index = 0; clause_index < ctx.clause_ids_.size(); ++clause_index) {
+        if (!learned_mask[clause_index]) {
+            add_clause(get<soa_clause>(ctx.clauses_soa_[ctx.clause_ids_[clause_index]]).get_literals() | std::views::keys);
+        }
+    }
+    build_occurrences();
+}
+
+std::uint32_t local_search::index_of(std::int64_t value) {
+    const auto [it, inserted] = indexes_.try_emplace(value, static_cast<std::uint32_t>(variables_.size()));
+    if (inserted) {
+        variables_.push_back(value);
+    }
+    return it->second;
+}
+
+void local_search::add_variables(std::span<const literal> literals) {
+    for (const auto& lit : literals) {
+        index_of(lit.value());
+    }
+}
+
+void local_search::add_constraint_variables() {
+    for (const auto& constraint : model_.cardinalities) {
+        add_variables(constraint.literals);
+    }
+    for (const auto& constraint : model_.xors) {
+        add_variables(constraint.literals);
+    }
+}
+
+void local_search::add_clause(std::ranges::input_range auto&& clause_literals) {
+    std::vector<std::uint32_t> encoded;
+    for (const literal& lit : clause_literals) {
+        encoded.push_back(encode(index_of(lit.value()), lit.is_off()));
+    }
+    std::ranges::sort(encoded);
+    encoded.erase(std::ranges::unique(encoded).begin(), encoded.end());
+
+    // a clause containing a literal and its negation is always satisfied : not part of the search
+    const bool tautology = std::ranges::adjacent_find(encoded, [](std::uint32_t lhs, std::uint32_t rhs) { return var_of(lhs) == var_of(rhs); }) != encoded.end();
+    if (!tautology && !encoded.empty()) {
+        clauses_.push_back(std::move(encoded));
+    }
+}
+
+void local_search::build_occurrences() {
+    occurrences_.resize(variables_.size() * 2);
+    for (std::uint32_t c = 0; c < clauses_.size(); ++c) {
+        for (const auto lit : clauses_[c]) {
+            occurrences_[lit].push_back(c);
+        }
+    }
+
+    values_.resize(variables_.size());
+    break_count_.resize(variables_.size());
+    true_count_.resize(clauses_.size());
+    true_xor_.resize(clauses_.size());
+    falsified_index_.resize(clauses_.size());
+}
+
+std::optional<assignment> local_search::best_phase(const literal& var) const {
+    const auto it = indexes_.find(var.value());
+    if (it == indexes_.end() || best_values_.empty()) {
+        return std::nullopt;
+    }
+    return best_values_[it->second] ? assignment::on : assignment::off;
+}
+
+void local_search::add_falsified(std::uint32_t clause) {
+    falsified_index_[clause] = static_cast<std::uint32_t>(falsified_.size());
+    falsified_.push_back(clause);
+}
+
+void local_search::remove_falsified(std::uint32_t clause) {
+    const auto last                      = falsified_.back();
+    falsified_[falsified_index_[clause]] = last;
+    falsified_index_[last]               = falsified_index_[clause];
+    falsified_.pop_back();
+}
+
+void local_search::initialize_try(std::span<const literal> initial_phases, bool first_try) {
+    std::bernoulli_distribution coin;
+    for (std::size_t v = 0; v < values_.size(); ++v) {
+        values_[v] = (first_try && !best_values_.empty()) ? best_values_[v] : coin(random_);
+    }
+    if (first_try) {
+        for (const auto& phase : initial_phases) {
+            if (const auto it = indexes_.find(phase.value()); it != indexes_.end()) {
+                values_[it->second] = phase.is_on();
+            }
+        }
+    }
+
+    std::ranges::fill(break_count_, 0);
+    falsified_.clear();
+    for (std::uint32_t c = 0; c < clauses_.size(); ++c) {
+        true_count_[c] = 0;
+        true_xor_[c]   = 0;
+        for (const auto lit : clauses_[c]) {
+            if (is_true(lit)) {
+                ++true_count_[c];
+                true_xor_[c] ^= var_of(lit);
+            }
+        }
+        if (true_count_[c] == 0) {
+            add_falsified(c);
+        } else if (true_count_[c] == 1) {
+            ++break_count_[true_xor_[c]];
+        }
+    }
+}
+
+void local_search::flip(std::uint32_t var) {
+    values_[var] = !values_[var];
+    ++flips_;
+
+    const auto became_true  = encode(var, !values_[var]);
+    const auto became_false = encode(var, values_[var]);
+
+    for (const auto c : occurrences_[became_true]) {
+        ++true_count_[c];
+        true_xor_[c] ^= var;
+        if (true_count_[c] == 1) {
+            remove_falsified(c);
+            ++break_count_[var];
+        } else if (true_count_[c] == 2) {
+            --break_count_[true_xor_[c] ^ var]; // the previously critical variable is not alone anymore
+        }
+    }
+    for (const auto c : occurrences_[became_false]) {
+        --true_count_[c];
+        true_xor_[c] ^= var;
+        if (true_count_[c] == 0) {
+            add_falsified(c);
+            --break_count_[var];
+        } else if (true_count_[c] == 1) {
+            ++break_count_[true_xor_[c]]; // the remaining true variable becomes critical
+        }
+    }
+}
+
+std::uint32_t local_search::pick_probsat(std::uint32_t clause) {
+    const auto& lits = clauses_[clause];
+    probabilities_.resize(lits.size());
+    std::ranges::transform(lits, probabilities_.begin(), [this](std::uint32_t lit) { //
+        return std::pow(config_.probsat_eps + static_cast<double>(break_count_[var_of(lit)]), -config_.probsat_cb);
+    });
+    std::discrete_distribution<std::size_t> pick {probabilities_.begin(), probabilities_.end()};
+    return var_of(lits[pick(random_)]);
+}
+
+std::uint32_t local_search::pick_walksat(std::uint32_t clause) {
+    const auto& lits    = clauses_[clause];
+    const auto best_lit = std::ranges::min_element(lits, {}, [this](std::uint32_t lit) { return break_count_[var_of(lit)]; });
+    if (break_count_[var_of(*best_lit)] == 0) {
+        return var_of(*best_lit); // free flip : no clause becomes falsified
+    }
+    if (std::bernoulli_distribution {config_.walksat_noise}(random_)) {
+        return var_of(lits[std::uniform_int_distribution<std::size_t> {0, lits.size() - 1}(random_)]);
+    }
+    return var_of(*best_lit);
+}
+
+bool local_search::satisfies_constraints() const {
+    auto count_true = [this](std::span<const literal> literals) {
+        return static_cast<std::size_t>(std::ranges::count_if(literals, [this](const literal& lit) { //
+            return values_[indexes_.at(lit.value())] == lit.is_on();
+        }));
+    };
+    const bool cardinalities_satisfied = std::ranges::all_of(model_.cardinalities, [&count_true](const cardinality_constraint& constraint) {
+        const auto true_count = count_true(constraint.literals);
+        return true_count <= constraint.at_most && true_count >= constraint.at_least.value_or(0);
+    });
+    return cardinalities_satisfied && std::ranges::all_of(model_.xors, [&count_true](const xor_constraint& constraint) { //
+        return (count_true(constraint.literals) % 2 == 1) == constraint.parity;
+    });
+}
+
+solver::result local_search::make_result() const {
+    solver::result res;
+    res.literals.reserve(variables_.size());
+    for (std::size_t v = 0; v < variables_.size(); ++v) {
+        res.literals.emplace_back(values_[v] ? variables_[v] : -variables_[v]);
+    }
+    return res;
+}
+
+std::expected<solver::result, sat_error> local_search::search(std::span<const literal> initial_phases, const solve_limits& limits) {
+    static constexpr std::size_t CHECK_INTERVAL = 1024;
+
+    for (std::size_t t = 0; t < config_.max_tries; ++t) {
+        initialize_try(initial_phases, t == 0);
+
+        for (std::size_t f = 0; f <= config_.max_flips; ++f) {
+            if (falsified_.size() < best_falsified_) {
+                best_falsified_ = falsified_.size();
+                best_values_    = values_;
+            }
+            if (falsified_.empty()) {
+                if (satisfies_constraints()) {
+                    log_debug("local search :: solution found after {} flips", flips_);
+                    return make_result();
+                }
+                break; // the clauses are satisfied but not the cardinality or XOR constraints : restart from a new assignment
+            }
+            if (f % CHECK_INTERVAL == 0
+                && (limits.stop_token.stop_requested() || (limits.deadline.has_value() && std::chrono::steady_clock::now() >= limits.deadline.value()))) {
+                log_debug("local search :: stopped by the solving limits");
+                return std::unexpected(sat_error::unknown);
+            }
+
+            const auto clause = falsified_[std::uniform_int_distribution<std::size_t> {0, falsified_.size() - 1}(random_)];
+            flip(config_.strategy == local_search_strategy::probsat ? pick_probsat(clause) : pick_walksat(clause));
+        }
+    }
+    log_debug("local search :: no solution found, best assignment falsifies {} clauses", best_falsified_);
+    return std::unexpected(sat_error::unknown);
+}
+
+} // namespace fabko::compiler::sat
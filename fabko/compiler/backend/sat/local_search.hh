@@ -0,0 +1,135 @@
+// Dual Licensing Either :
+// - AGPL
+// or
+// - Subscription license for commercial usage (without requirement of licensing propagation).
+//   please contact ballandfys@protonmail.com for additional information about this subscription commercial licensing.
+//
+// Created by FyS on 18/10/26. License 2022-2026
+//
+// In the case no license has been purchased for the use (modification or distribution in any way) of the software stack
+// the APGL license is applying.
+//
+
+#ifndef LOCAL_SEARCH_HH
+#define LOCAL_SEARCH_HH
+
+#include <cstdint>
+#include <expected>
+#include <limits>
+#include <optional>
+#include <random>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "solver.hh"
+
+namespace fabko::compiler::sat {
+
+enum class local_search_strategy {
+    probsat, //!< pick a variable of a random falsified clause with a probability decreasing polynomially with its break count
+    walksat, //!< pick a free (break count 0) variable of a random falsified clause, else a random one (noise) or the one of minimal break
+};
+
+struct local_search_configuration {
+    local_search_strategy strategy {local_search_strategy::probsat};
+    std::size_t max_flips {100000}; //!< number of flips of a try before restarting from a new assignment
+    std::size_t max_tries {10};     //!< number of tries before giving up
+    double probsat_cb {2.06};       //!< ProbSAT polynomial break exponent (2.06 is the reference value for 3-SAT)
+    double probsat_eps {0.9};       //!< ProbSAT polynomial break offset
+    double walksat_noise {0.567};   //!< WalkSAT probability to pick a random variable when no free variable exists
+    std::uint64_t seed {42};        //!< seed of the random generator, the search is deterministic for a given seed
+};
+
+/**
+ * @brief Stochastic local search engine (ProbSAT / WalkSAT) over the clauses of a model
+ *
+ * The engine flips variables of a complete assignment to reduce the number of falsified clauses. The break count of every variable (number of
+ * clauses that would become falsified by flipping it) is cached and updated incrementally on each flip, as well as the list of falsified clauses.
+ *
+ * It can be used standalone (search for a model of a satisfiable problem, it cannot prove unsatisfiability) or as a phase provider for the
+ * CDCL solver (rephasing) : the best assignment found (least falsified clauses) seeds the saved phases of the solver.
+ *
+ * @note cardinality and XOR constraints of the model are not part of the search, an assignment satisfying all the clauses is only returned as
+ * a solution if it also satisfies the cardinality and XOR constraints (their variables are part of the assignment).
+ */
+class local_search {
+  public:
+    explicit local_search(const model& m, local_search_configuration config = {});
+
+    /**
+     * @brief local search over the clauses stored in a solver context (the learned clauses are not part of the search)
+     */
+    explicit local_search(const solver_context& ctx, local_search_configuration config = {});
+
+    /**
+     * @brief search for an assignment satisfying all the clauses of the model
+     * @param initial_phases literals used as initial assignment of the first try (random assignment for the variables not provided)
+     * @param limits cancellation and deadline of the search
+     * @return a solution if found, sat_error::unknown otherwise (local search cannot prove unsatisfiability)
+     */
+    std::expected<solver::result, sat_error> search(std::span<const literal> initial_phases = {}, const solve_limits& limits = {});
+
+    /**
+     * @return phase of the variable in the best assignment found (least falsified clauses), std::nullopt if the variable is unknown
+     */
+    [[nodiscard]] std::optional<assignment> best_phase(const literal& var) const;
+
+    /**
+     * @return number of clauses falsified by the best assignment found
+     */
+    [[nodiscard]] std::size_t best_falsified_count() const { return best_falsified_; }
+
+    /**
+     * @return number of flips executed over all the searches
+     */
+    [[nodiscard]] std::size_t flips() const { return flips_; }
+
+  private:
+    std::uint32_t index_of(std::int64_t value);
+    void add_variables(std::span<const literal> literals);
+    void add_constraint_variables();
+    void add_clause(std::ranges::input_range auto&& clause_literals);
+    void build_occurrences();
+
+    void initialize_try(std::span<const literal> initial_phases, bool first_try);
+    void flip(std::uint32_t var);
+
+    [[nodiscard]] std::uint32_t pick_probsat(std::uint32_t clause);
+    [[nodiscard]] std::uint32_t pick_walksat(std::uint32_t clause);
+
+    [[nodiscard]] bool is_true(std::uint32_t lit) const { return values_[lit >> 1] != ((lit & 1) == 1); }
+    [[nodiscard]] bool satisfies_constraints() const;
+    [[nodiscard]] solver::result make_result() const;
+
+    void add_falsified(std::uint32_t clause);
+    void remove_falsified(std::uint32_t clause);
+
+    const model& model_;
+    local_search_configuration config_;
+    std::mt19937_64 random_;
+
+    std::vector<std::int64_t> variables_;                     //!< literal value of each (dense) variable index
+    std::unordered_map<std::int64_t, std::uint32_t> indexes_; //!< dense variable index of each literal value
+
+    // literals are encoded as (variable index << 1 | negated)
+    std::vector<std::vector<std::uint32_t>> clauses_;     //!< literals of each clause
+    std::vector<std::vector<std::uint32_t>> occurrences_; //!< clauses in which each literal occurs
+
+    std::vector<bool> values_;                   //!< current assignment of each variable
+    std::vector<std::uint32_t> true_count_;      //!< number of true literals of each clause
+    std::vector<std::uint32_t> true_xor_;        //!< xor of the variables of the true literals of each clause (the critical one if single)
+    std::vector<std::uint32_t> break_count_;     //!< number of clauses in which the variable is the only true literal
+    std::vector<std::uint32_t> falsified_;       //!< clauses currently falsified
+    std::vector<std::uint32_t> falsified_index_; //!< position of each clause in the falsified list
+
+    std::vector<bool> best_values_;
+    std::size_t best_falsified_ {std::numeric_limits<std::size_t>::max()};
+    std::size_t flips_ {0};
+
+    std::vector<double> probabilities_; //!< scratch buffer of the ProbSAT selection
+};
+
+} // namespace fabko::compiler::sat
+
+#endif // LOCAL_SEARCH_HH
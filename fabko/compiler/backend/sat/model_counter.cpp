@@ -0,0 +1,553 @@
+// Dual Licensing Either :
+// - AGPL
+// or
+// - Subscription license for commercial usage (without requirement of licensing propagation).
+//   please contact ballandfys@protonmail.com for additional information about this subscription commercial licensing.
+//
+// Created by FyS on 18/10/26. License 2022-2026
+//
+// In the case no license has been purchased for the use (modification or distribution in any way) of the software stack
+// the APGL license is applying.
+//
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <ranges>
+#include <unordered_map>
+
+#include "common/logging.hh"
+
+#include "model_counter.hh"
+
+namespace fabko::compiler::sat {
+
+namespace {
+
+/**
+ * @brief constraint simplified by the literals assigned on the current branch of the exact counting, on the dense variables of the counter
+ *
+ * Clauses and cardinality constraints are both bounds on the number of true literals (a clause is an at-least-one constraint), the literals
+ * of a XOR constraint are positive (the negated literals flip its parity).
+ */
+struct residual_constraint {
+    bool is_xor {false};
+    std::vector<literal> literals; //!< literals not assigned yet
+    std::int64_t at_least {0};     //!< minimum number of the literals left that have to be true
+    std::int64_t at_most {0};      //!< maximum number of the literals left that can be true
+    bool parity {false};           //!< XOR of the literals left
+};
+
+enum class residual_state {
+    open,
+    satisfied,
+    conflict,
+};
+
+std::optional<std::uint64_t> checked_add(std::uint64_t lhs, std::uint64_t rhs) {
+    if (lhs > std::numeric_limits<std::uint64_t>::max() - rhs) {
+        return std::nullopt;
+    }
+    return lhs + rhs;
+}
+
+std::optional<std::uint64_t> checked_mul(std::uint64_t lhs, std::uint64_t rhs) {
+    if (lhs != 0 && rhs > std::numeric_limits<std::uint64_t>::max() / lhs) {
+        return std::nullopt;
+    }
+    return lhs * rhs;
+}
+
+std::vector<literal> counted_variables(const model& m) {
+    std::vector<literal> variables;
+    auto add = [&variables](const literal& lit) { variables.emplace_back(lit.value()); };
+    std::ranges::for_each(m.literals, add);
+    for (const auto& clause : m.clauses) {
+        std::ranges::for_each(clause, add);
+    }
+    for (const auto& constraint : m.cardinalities) {
+        std::ranges::for_each(constraint.literals, add);
+    }
+    for (const auto& constraint : m.xors) {
+        std::ranges::for_each(constraint.literals, add);
+    }
+    std::ranges::sort(variables, {}, &literal::value);
+    const auto [first, last] = std::ranges::unique(variables, {}, &literal::value);
+    variables.erase(first, last);
+    return variables;
+}
+
+/**
+ * @brief exact counting by DPLL search with component decomposition and caching
+ *
+ * Each node of the search simplifies the residual constraints by the decided literal and propagates the forced literals, the branch is then
+ * checked by the CDCL solver (resolution assuming the literals of the branch) : an unsatisfiable branch has no solution, which avoids to
+ * explore it. The residual constraints left are split into components that do not share any variable : the count of the node is the product
+ * of the count of its components (and of the free variables), each component being counted by branching on its most occurring variable.
+ * The count of a component only depends on its residual constraints : it is cached by them.
+ */
+class component_counter {
+  public:
+    component_counter(solver& s, std::span<const literal> variables, const counting_configuration& config, counting_statistics& statistics,
+        const solve_limits& limits)
+        : solver_(s)
+        , variables_(variables)
+        , config_(config)
+        , statistics_(statistics)
+        , limits_(limits)
+        , values_(variables.size(), 0)
+        , parent_(variables.size(), 0)
+        , occurrences_(variables.size(), 0) {}
+
+    /**
+     * @param constraints residual constraints of the node
+     * @param variables dense variables of the node, the solutions are counted over them
+     * @param decision literal decided on the node (nothing for the root node)
+     * @return number of solutions of the node, or sat_error::unknown if the limits stopped a resolution or if the count overflows (see overflowed())
+     */
+    std::expected<std::uint64_t, sat_error> count(std::vector<residual_constraint> constraints, std::span<const std::uint32_t> variables,
+        std::optional<literal> decision) {
+        const auto path_size = path_.size();
+        std::vector<literal> assigned;
+        const bool consistent = propagate(constraints, decision, assigned);
+        for (const auto& lit : assigned) {
+            path_.push_back(to_external(lit));
+        }
+
+        auto res = consistent ? count_components(std::move(constraints), variables) : std::expected<std::uint64_t, sat_error> {0};
+        for (const auto& lit : assigned) {
+            values_[static_cast<std::size_t>(lit.value() - 1)] = 0;
+        }
+        path_.resize(path_size);
+        return res;
+    }
+
+    [[nodiscard]] bool overflowed() const { return overflowed_; }
+
+  private:
+    [[nodiscard]] std::int8_t value_of(const literal& lit) const {
+        const auto value = values_[static_cast<std::size_t>(lit.value() - 1)];
+        return lit.is_on() ? value : static_cast<std::int8_t>(-value);
+    }
+
+    [[nodiscard]] literal to_external(const literal& lit) const {
+        const auto& var = variables_[static_cast<std::size_t>(lit.value() - 1)];
+        return lit.is_on() ? var : var.negation();
+    }
+
+    std::uint32_t find(std::uint32_t var) {
+        while (parent_[var] != var) {
+            parent_[var] = parent_[parent_[var]];
+            var          = parent_[var];
+        }
+        return var;
+    }
+
+    std::unexpected<sat_error> overflow() {
+        overflowed_ = true;
+        return std::unexpected(sat_error::unknown);
+    }
+
+    /**
+     * @brief remove the assigned literals of the constraint
+     * @param forced literals forced by the constraint (the constraint is then satisfied once they are assigned)
+     */
+    residual_state simplify(residual_constraint& constraint, std::vector<literal>& forced) const {
+        std::erase_if(constraint.literals, [this, &constraint](const literal& lit) {
+            const auto value = value_of(lit);
+            if (value > 0 && constraint.is_xor) {
+                constraint.parity = !constraint.parity;
+            } else if (value > 0) {
+                --constraint.at_least;
+                --constraint.at_most;
+            }
+            return value != 0;
+        });
+
+        const auto size = static_cast<std::int64_t>(constraint.literals.size());
+        if (constraint.is_xor) {
+            if (size == 0) {
+                return constraint.parity ? residual_state::conflict : residual_state::satisfied;
+            }
+            if (size == 1) {
+                forced.push_back(constraint.parity ? constraint.literals.front() : constraint.literals.front().negation());
+                return residual_state::satisfied;
+            }
+            return residual_state::open;
+        }
+        if (constraint.at_most < 0 || constraint.at_least > size) {
+            return residual_state::conflict;
+        }
+        if (constraint.at_least <= 0 && constraint.at_most >= size) {
+            return residual_state::satisfied;
+        }
+        if (constraint.at_most == 0 || constraint.at_least == size) {
+            const bool all_true = constraint.at_least == size;
+            for (const auto& lit : constraint.literals) {
+                forced.push_back(all_true ? lit : lit.negation());
+            }
+            return residual_state::satisfied;
+        }
+        return residual_state::open;
+    }
+
+    /**
+     * @brief assign the decision and the literals it forces, the satisfied constraints are removed
+     * @param assigned literals assigned by the propagation
+     * @return false if a constraint is violated
+     */
+    bool propagate(std::vector<residual_constraint>& constraints, std::optional<literal> decision, std::vector<literal>& assigned) {
+        std::vector<literal> pending;
+        if (decision.has_value()) {
+            pending.push_back(decision.value());
+        }
+        do {
+            for (const auto& lit : pending) {
+                const auto value = value_of(lit);
+                if (value < 0) {
+                    return false;
+                }
+                if (value == 0) {
+                    values_[static_cast<std::size_t>(lit.value() - 1)] = static_cast<std::int8_t>(lit.is_on() ? 1 : -1);
+                    assigned.push_back(lit);
+                }
+            }
+            pending.clear();
+
+            bool conflict = false;
+            std::erase_if(constraints, [&](residual_constraint& constraint) {
+                const auto state = conflict ? residual_state::open : simplify(constraint, pending);
+                conflict         = conflict || state == residual_state::conflict;
+                return state == residual_state::satisfied;
+            });
+            if (conflict) {
+                return false;
+            }
+        } while (!pending.empty());
+        return true;
+    }
+
+    std::expected<std::uint64_t, sat_error> count_components(std::vector<residual_constraint> constraints, std::span<const std::uint32_t> variables) {
+        if (!constraints.empty()) {
+            ++statistics_.resolutions;
+            if (const auto res = solver_.solve_with_assumptions(path_, limits_); !res.has_value()) {
+                return res.error() == sat_error::unsatisfiable ? std::expected<std::uint64_t, sat_error> {0} : std::unexpected(res.error());
+            }
+        }
+
+        for (const auto var : variables) {
+            parent_[var]      = var;
+            occurrences_[var] = 0;
+        }
+        for (const auto& constraint : constraints) {
+            const auto root = find(static_cast<std::uint32_t>(constraint.literals.front().value() - 1));
+            for (const auto& lit : constraint.literals) {
+                const auto var = static_cast<std::uint32_t>(lit.value() - 1);
+                ++occurrences_[var];
+                parent_[find(var)] = root;
+            }
+        }
+
+        // the variables left unassigned that are not part of any constraint can take any value
+        std::size_t free_variables = 0;
+        std::unordered_map<std::uint32_t, std::size_t> component_of_root;
+        std::vector<std::vector<std::uint32_t>> component_variables;
+        std::vector<std::uint32_t> branch_variables; // most occurring variable of each component
+        for (const auto var : variables) {
+            if (values_[var] != 0) {
+                continue;
+            }
+            if (occurrences_[var] == 0) {
+                ++free_variables;
+                continue;
+            }
+            const auto [it, inserted] = component_of_root.try_emplace(find(var), component_variables.size());
+            if (inserted) {
+                component_variables.emplace_back();
+                branch_variables.push_back(var);
+            }
+            component_variables[it->second].push_back(var);
+            if (occurrences_[var] > occurrences_[branch_variables[it->second]]) {
+                branch_variables[it->second] = var;
+            }
+        }
+        std::vector<std::vector<residual_constraint>> component_constraints(component_variables.size());
+        for (auto& constraint : constraints) {
+            const auto root = find(static_cast<std::uint32_t>(constraint.literals.front().value() - 1));
+            component_constraints[component_of_root.at(root)].push_back(std::move(constraint));
+        }
+
+        if (free_variables >= 64) {
+            return overflow();
+        }
+        std::uint64_t count = std::uint64_t {1} << free_variables;
+        for (std::size_t component = 0; component < component_variables.size() && count != 0; ++component) {
+            const auto component_count = count_component(std::move(component_constraints[component]), component_variables[component], branch_variables[component]);
+            if (!component_count.has_value()) {
+                return std::unexpected(component_count.error());
+            }
+            const auto product = checked_mul(count, component_count.value());
+            if (!product.has_value()) {
+                return overflow();
+            }
+            count = product.value();
+        }
+        return count;
+    }
+
+    std::expected<std::uint64_t, sat_error> count_component(std::vector<residual_constraint> constraints, std::span<const std::uint32_t> variables,
+        std::uint32_t branch_variable) {
+        auto key = cache_key(constraints);
+        if (const auto it = cache_.find(key); it != cache_.end()) {
+            ++statistics_.cache_hits;
+            return it->second;
+        }
+        ++statistics_.components;
+        statistics_.decisions += 2;
+
+        const auto branch = literal {static_cast<std::int64_t>(branch_variable) + 1};
+        const auto on     = count(constraints, variables, branch);
+        if (!on.has_value()) {
+            return on;
+        }
+        const auto off = count(std::move(constraints), variables, branch.negation());
+        if (!off.has_value()) {
+            return off;
+        }
+        const auto sum = checked_add(on.value(), off.value());
+        if (!sum.has_value()) {
+            return overflow();
+        }
+
+        if (cache_.size() >= config_.cache_capacity) {
+            cache_.clear();
+        }
+        cache_.emplace(std::move(key), sum.value());
+        return sum.value();
+    }
+
+    /**
+     * @return canonical form of a set of residual constraints : independent of the order of the constraints and of their literals
+     */
+    static std::vector<std::int64_t> cache_key(const std::vector<residual_constraint>& constraints) {
+        std::vector<std::vector<std::int64_t>> serialized;
+        serialized.reserve(constraints.size());
+        for (const auto& constraint : constraints) {
+            std::vector<std::int64_t> values {
+                constraint.is_xor ? 1 : 0,
+                constraint.is_xor ? static_cast<std::int64_t>(constraint.parity) : constraint.at_least,
+                constraint.is_xor ? 0 : constraint.at_most,
+                static_cast<std::int64_t>(constraint.literals.size()),
+            };
+            for (const auto& lit : constraint.literals) {
+                values.push_back(lit.is_on() ? lit.value() : -lit.value());
+            }
+            std::ranges::sort(values.begin() + 4, values.end());
+            serialized.push_back(std::move(values));
+        }
+        std::ranges::sort(serialized);
+        return serialized | std::views::join | std::ranges::to<std::vector>();
+    }
+
+    solver& solver_;
+    std::span<const literal> variables_; //!< external variable of each dense variable
+    const counting_configuration& config_;
+    counting_statistics& statistics_;
+    const solve_limits& limits_;
+
+    std::vector<std::int8_t> values_;        //!< value of each dense variable on the current branch (1 true, -1 false, 0 unassigned)
+    std::vector<literal> path_;              //!< literals assigned on the current branch (external variables), assumptions of the CDCL solver
+    std::vector<std::uint32_t> parent_;      //!< union-find of the variables of a node into components
+    std::vector<std::uint32_t> occurrences_; //!< number of residual constraints of a node each variable occurs in
+
+    std::map<std::vector<std::int64_t>, std::uint64_t> cache_; //!< count of the components by their canonical form
+    bool overflowed_ {false};
+};
+
+} // namespace
+
+model_counter::model_counter(model m, counting_configuration config)
+    : config_(config)
+    , model_([&m] {
+        m.conf.symmetry_breaking = false; // the symmetric solutions would not be counted
+        m.literal_context.clear();
+        return std::move(m);
+    }())
+    , variables_(counted_variables(model_))
+    , indexes_([this] {
+        std::unordered_map<std::int64_t, std::uint32_t> indexes;
+        indexes.reserve(variables_.size());
+        for (std::uint32_t index = 0; index < variables_.size(); ++index) {
+            indexes.emplace(variables_[index].value(), index);
+        }
+        return indexes;
+    }())
+    , next_var_(variables_.empty() ? 1 : variables_.back().value() + 1)
+    , random_(config_.seed)
+    , solver_(model_) {}
+
+std::expected<model_count, sat_error> model_counter::count(const solve_limits& limits) {
+    const bool exact = config_.mode == counting_mode::exact || (config_.mode == counting_mode::automatic && variables_.size() <= config_.exact_max_variables);
+    if (exact) {
+        const auto res = count_exact(limits);
+        if (res.has_value()) {
+            return model_count {.estimate = static_cast<double>(res.value()), .exact = res.value()};
+        }
+        if (config_.mode == counting_mode::exact || !overflowed_) {
+            return std::unexpected(res.error());
+        }
+        log_info("model counter :: the exact count does not fit 64 bits, the model is counted approximately");
+    }
+    return count_approximate(limits);
+}
+
+std::expected<std::uint64_t, sat_error> model_counter::count_exact(const solve_limits& limits) {
+    auto dense = [this](const literal& lit) {
+        const auto var = static_cast<std::int64_t>(indexes_.at(lit.value())) + 1;
+        return lit.is_on() ? literal {var} : literal {-var};
+    };
+
+    std::vector<residual_constraint> constraints;
+    constraints.reserve(model_.clauses.size() + model_.cardinalities.size() + model_.xors.size());
+    for (const auto& clause : model_.clauses) {
+        constraints.push_back({
+            .literals = clause | std::views::transform(dense) | std::ranges::to<std::vector>(),
+            .at_least = 1,
+            .at_most  = static_cast<std::int64_t>(clause.size()),
+        });
+    }
+    for (const auto& [literals, at_most, at_least] : model_.cardinalities) {
+        constraints.push_back({
+            .literals = literals | std::views::transform(dense) | std::ranges::to<std::vector>(),
+            .at_least = static_cast<std::int64_t>(at_least.value_or(0)),
+            .at_most  = static_cast<std::int64_t>(at_most),
+        });
+    }
+    for (const auto& [literals, parity] : model_.xors) {
+        residual_constraint constraint {.is_xor = true, .parity = parity};
+        for (const auto& lit : literals) {
+            constraint.literals.emplace_back(dense(lit).value());
+            constraint.parity ^= lit.is_off();
+        }
+        constraints.push_back(std::move(constraint));
+    }
+
+    const auto variables = std::views::iota(std::uint32_t {0}, static_cast<std::uint32_t>(variables_.size())) | std::ranges::to<std::vector>();
+    component_counter counter {solver_, variables_, config_, statistics_, limits};
+    const auto res = counter.count(std::move(constraints), variables, std::nullopt);
+    overflowed_    = counter.overflowed();
+    if (res.has_value()) {
+        log_info("model counter :: {} solutions counted exactly ({} components, {} cache hits, {} resolutions)", res.value(), statistics_.components,
+            statistics_.cache_hits, statistics_.resolutions);
+    }
+    return res;
+}
+
+std::expected<model_count, sat_error> model_counter::count_approximate(const solve_limits& limits) {
+    // size of a cell small enough to be enumerated (see ApproxMC) : the estimate is within the tolerance with a probability of at least 0.6 for
+    // each iteration, the median of the iterations being within it with a higher probability
+    const auto epsilon   = config_.tolerance;
+    const auto threshold = static_cast<std::size_t>(std::ceil(1 + 9.84 * (1 + epsilon / (1 + epsilon)) * std::pow(1 + 1 / epsilon, 2)));
+
+    // few solutions : they are enumerated, the count is exact
+    const auto solutions = bounded_count({}, threshold, limits);
+    if (!solutions.has_value()) {
+        return std::unexpected(solutions.error());
+    }
+    if (solutions.value() < threshold) {
+        log_info("model counter :: {} solutions enumerated", solutions.value());
+        return model_count {.estimate = static_cast<double>(solutions.value()), .exact = solutions.value()};
+    }
+
+    std::bernoulli_distribution coin {0.5};
+    std::vector<double> estimates;
+    for (std::size_t iteration = 0; iteration < std::max<std::size_t>(config_.iterations, 1); ++iteration) {
+        // the cell of m hash constraints is the set of solutions satisfying the m first random XOR constraints of the iteration, a hash constraint
+        // is enabled by assuming the negation of its activation literal (it is left unconstrained by the next iterations)
+        std::vector<literal> hashes;
+        auto cell_count = [&](std::size_t constraints) {
+            while (hashes.size() < constraints) {
+                xor_constraint hash {.literals = {}, .parity = coin(random_)};
+                std::ranges::copy_if(variables_, std::back_inserter(hash.literals), [&](const literal&) { return coin(random_); });
+                const auto activation = make_fresh_literal();
+                hash.literals.push_back(activation);
+                solver_.add_xor(std::move(hash));
+                hashes.push_back(activation.negation());
+                ++statistics_.hash_constraints;
+            }
+            return bounded_count(std::span {hashes}.first(constraints), threshold, limits);
+        };
+
+        // galloping search of the smallest number of hash constraints whose cell can be enumerated (the cells of an iteration are nested)
+        std::size_t enumerable = 1;
+        std::size_t too_large  = 0;
+        std::size_t cell       = 0;
+        while (true) {
+            const auto res = cell_count(enumerable);
+            if (!res.has_value()) {
+                return std::unexpected(res.error());
+            }
+            cell = res.value();
+            if (cell < threshold || enumerable >= variables_.size()) {
+                break;
+            }
+            too_large  = enumerable;
+            enumerable = std::min(enumerable * 2, variables_.size());
+        }
+        while (enumerable - too_large > 1) {
+            const auto middle = too_large + (enumerable - too_large) / 2;
+            const auto res    = cell_count(middle);
+            if (!res.has_value()) {
+                return std::unexpected(res.error());
+            }
+            if (res.value() < threshold) {
+                enumerable = middle;
+                cell       = res.value();
+            } else {
+                too_large = middle;
+            }
+        }
+        estimates.push_back(std::ldexp(static_cast<double>(cell), static_cast<int>(enumerable)));
+    }
+
+    const auto median = estimates.begin() + static_cast<std::ptrdiff_t>(estimates.size() / 2);
+    std::ranges::nth_element(estimates, median);
+    log_info("model counter :: {:.4g} solutions estimated ({} hash constraints, {} resolutions)", *median, statistics_.hash_constraints,
+        statistics_.resolutions);
+    return model_count {.estimate = *median};
+}
+
+std::expected<std::size_t, sat_error> model_counter::bounded_count(std::span<const literal> assumptions, std::size_t bound, const solve_limits& limits) {
+    // the solutions found are blocked by clauses enabled by the activation literal of the enumeration, disabled once it is over
+    const auto activation = make_fresh_literal();
+    std::vector<literal> enumeration_assumptions {assumptions.begin(), assumptions.end()};
+    enumeration_assumptions.push_back(activation.negation());
+
+    std::size_t count = 0;
+    while (count < bound) {
+        ++statistics_.resolutions;
+        const auto res = solver_.solve_with_assumptions(enumeration_assumptions, limits);
+        if (!res.has_value()) {
+            if (res.error() != sat_error::unsatisfiable) {
+                return std::unexpected(res.error());
+            }
+            break;
+        }
+        ++count;
+
+        std::vector<literal> blocking;
+        blocking.reserve(variables_.size() + 1);
+        for (const auto& lit : res->literals) {
+            if (indexes_.contains(lit.value())) {
+                blocking.push_back(lit.negation());
+            }
+        }
+        blocking.push_back(activation);
+        solver_.add_clause(std::move(blocking));
+    }
+    solver_.add_clause({activation});
+    return count;
+}
+
+} // namespace fabko::compiler::sat
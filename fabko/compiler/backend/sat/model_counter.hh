@@ -0,0 +1,125 @@
+// Dual Licensing Either :
+// - AGPL
+// or
+// - Subscription license for commercial usage (without requirement of licensing propagation).
+//   please contact ballandfys@protonmail.com for additional information about this subscription commercial licensing.
+//
+// Created by FyS on 18/10/26. License 2022-2026
+//
+// In the case no license has been purchased for the use (modification or distribution in any way) of the software stack
+// the APGL license is applying.
+//
+
+#ifndef MODEL_COUNTER_HH
+#define MODEL_COUNTER_HH
+
+#include <cstdint>
+#include <expected>
+#include <optional>
+#include <random>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "solver.hh"
+
+namespace fabko::compiler::sat {
+
+enum class counting_mode {
+    automatic,   //!< exact counting for the small models (see counting_configuration::exact_max_variables), approximate counting otherwise
+    exact,       //!< DPLL counting with component decomposition and caching
+    approximate, //!< hashing based counting (ApproxMC) : solutions are enumerated in a random cell of the solution space
+};
+
+struct counting_configuration {
+    counting_mode mode {counting_mode::automatic};
+    std::size_t exact_max_variables {128}; //!< automatic mode : models of more variables are counted approximately
+    std::size_t cache_capacity {1 << 16};  //!< maximum number of components whose count is cached (the cache is cleared when full)
+    double tolerance {0.8};                //!< approximate count : the estimate is within [count / (1 + tolerance), count * (1 + tolerance)]
+    std::size_t iterations {9};            //!< approximate count : number of estimates the median is taken of (the confidence grows with it)
+    std::uint64_t seed {42};               //!< seed of the random hash functions, the approximate count is deterministic for a given seed
+};
+
+struct model_count {
+    double estimate {};                    //!< number of solutions of the model (the exact count if known, as far as a double is precise)
+    std::optional<std::uint64_t> exact {}; //!< exact number of solutions, if the model has been counted exactly
+};
+
+struct counting_statistics {
+    std::size_t resolutions {0};      //!< resolutions of the CDCL solver
+    std::size_t decisions {0};        //!< branches of the exact counting
+    std::size_t components {0};       //!< components counted by the exact counting (not found in the cache)
+    std::size_t cache_hits {0};       //!< components whose count was found in the cache
+    std::size_t hash_constraints {0}; //!< random XOR constraints added by the approximate counting
+};
+
+/**
+ * @brief Model counter (#SAT) : number of solutions of a model without enumerating them
+ *
+ * Both counting modes are built on top of the CDCL solver, used incrementally (learned clauses are kept in between resolutions) :
+ *  - exact : DPLL search over the constraints simplified by the current branch (residual constraints). The residual constraints are split into
+ *    independent components (sharing no variable) counted separately and multiplied, the count of a component is cached by its residual
+ *    constraints. Branches are pruned by the CDCL solver (resolution under the branch literals as assumptions).
+ *  - approximate : ApproxMC, the solution space is split into cells by random XOR constraints (propagated natively by the solver) until a cell
+ *    has few enough solutions to be enumerated, the count of the cell scaled by the number of cells is an estimate of the model count. The
+ *    median of several estimates is taken.
+ *
+ * Solutions are counted over every variable of the model (literals and variables of its constraints).
+ * @note symmetry breaking is disabled on the solver as it removes solutions
+ */
+class model_counter {
+  public:
+    explicit model_counter(model m, counting_configuration config = {});
+
+    /**
+     * @brief count the solutions of the model as configured (see counting_configuration::mode)
+     * @note in automatic mode, a model whose exact count does not fit 64 bits is counted approximately
+     * @param limits cancellation, deadline and budgets applied on each resolution
+     * @return number of solutions, or sat_error::unknown if the limits stopped a resolution
+     */
+    std::expected<model_count, sat_error> count(const solve_limits& limits = {});
+
+    /**
+     * @brief count exactly the solutions of the model by component decomposition and caching
+     * @param limits cancellation, deadline and budgets applied on each resolution
+     * @return number of solutions, or sat_error::unknown if the limits stopped a resolution or if the count does not fit 64 bits
+     */
+    std::expected<std::uint64_t, sat_error> count_exact(const solve_limits& limits = {});
+
+    /**
+     * @brief estimate the number of solutions of the model by hashing (exact if the model has few solutions)
+     * @param limits cancellation, deadline and budgets applied on each resolution
+     * @return estimated number of solutions, or sat_error::unknown if the limits stopped a resolution
+     */
+    std::expected<model_count, sat_error> count_approximate(const solve_limits& limits = {});
+
+    [[nodiscard]] const counting_statistics& statistics() const { return statistics_; }
+
+  private:
+    /**
+     * @brief enumerate the solutions of the model satisfying the assumptions, up to a bound
+     * @note the solutions are blocked by clauses guarded by a fresh activation literal, the clauses are disabled at the end of the enumeration
+     * @return number of solutions found (bound if there are at least bound solutions)
+     */
+    std::expected<std::size_t, sat_error> bounded_count(std::span<const literal> assumptions, std::size_t bound, const solve_limits& limits);
+
+    /**
+     * @return a literal on a variable unused in the model
+     */
+    literal make_fresh_literal() { return literal {next_var_++}; }
+
+    counting_configuration config_;
+    model model_;                                              //!< constraints counted (the clauses are also owned by the solver)
+    std::vector<literal> variables_;                           //!< variables the solutions are counted on (sorted)
+    std::unordered_map<std::int64_t, std::uint32_t> indexes_; //!< index in variables_ of each variable
+    std::int64_t next_var_;                                    //!< next variable unused in the model (used to generate activation literals)
+    std::mt19937_64 random_;
+    solver solver_;
+
+    counting_statistics statistics_ {};
+    bool overflowed_ {false}; //!< the last exact count did not fit 64 bits
+};
+
+} // namespace fabko::compiler::sat
+
+#endif // MODEL_COUNTER_HH
@@ -0,0 +1,337 @@
+// Dual Licensing Either :
+// - AGPL
+// or
+// - Subscription license for commercial usage (without requirement of licensing propagation).
+//   please contact ballandfys@protonmail.com for additional information about this subscription commercial licensing.
+//
+// Created by FyS on 18/10/26. License 2022-2026
+//
+// In the case no license has been purchased for the use (modification or distribution in any way) of the software stack
+// the APGL license is applying.
+//
+
+#include <algorithm>
+#include <iterator>
+#include <map>
+#include <optional>
+#include <unordered_map>
+
+#include "common/logging.hh"
+
+#include "optimizer.hh"
+
+namespace fabko::compiler::sat {
+
+namespace {
+
+/**
+ * @brief build a Generalized Totalizer Encoding (GTE) of a weighted sum of literals and add its clauses to the solver
+ *
+ * Each node of the totalizer has an output literal per reachable sum value, the output literal is implied to be true when the sum of the
+ * inputs of the node reaches at least that value. Sums greater than the clamp value are merged into the clamp value, which keeps the encoding
+ * small when only a bound is to be enforced.
+ * Forbidding a sum value (and above) is then done by adding the negation of the output literals as unit clauses.
+ *
+ * @param s solver to which the clauses of the encoding are added
+ * @param inputs literals and weights of the sum
+ * @param clamp value at which sums are clamped
+ * @param make_fresh_literal generator of unused literals
+ * @return output literals of the root node of the totalizer by sum value
+ */
+template<typename FreshLiteral>
+std::map<std::uint64_t, literal> build_totalizer(solver& s, std::span<const std::pair<literal, std::uint64_t>> inputs, std::uint64_t clamp, FreshLiteral&& make_fresh_literal) {
+    if (inputs.size() == 1) {
+        return {
+            {std::min(inputs.front().second, clamp), inputs.front().first}
+        };
+    }
+
+    const auto half  = inputs.size() / 2;
+    const auto left  = build_totalizer(s, inputs.subspan(0, half), clamp, make_fresh_literal);
+    const auto right = build_totalizer(s, inputs.subspan(half), clamp, make_fresh_literal);
+
+    std::map<std::uint64_t, literal> outputs;
+    auto output_of = [&](std::uint64_t sum) {
+        const auto value = std::min(sum, clamp);
+        auto it          = outputs.find(value);
+        if (it == outputs.end()) {
+            it = outputs.emplace(value, make_fresh_literal()).first;
+        }
+        return it->second;
+    };
+
+    for (const auto& [sum, lit] : left) {
+        s.add_clause({lit.negation(), output_of(sum)});
+    }
+    for (const auto& [sum, lit] : right) {
+        s.add_clause({lit.negation(), output_of(sum)});
+    }
+    for (const auto& [left_sum, left_lit] : left) {
+        for (const auto& [right_sum, right_lit] : right) {
+            s.add_clause({left_lit.negation(), right_lit.negation(), output_of(left_sum + right_sum)});
+        }
+    }
+    return outputs;
+}
+
+std::int64_t max_variable(const model& hard, const std::vector<soft_clause>& soft) {
+    std::int64_t max_var = 0;
+    for (const auto& lit : hard.literals) {
+        max_var = std::max(max_var, lit.value());
+    }
+    for (const auto& clause : hard.clauses) {
+        for (const auto& lit : clause) {
+            max_var = std::max(max_var, lit.value());
+        }
+    }
+    // variables can be only known by the cardinality and XOR constraints : the new variables must not alias them
+    for (const auto& constraint : hard.cardinalities) {
+        for (const auto& lit : constraint.literals) {
+            max_var = std::max(max_var, lit.value());
+        }
+    }
+    for (const auto& constraint : hard.xors) {
+        for (const auto& lit : constraint.literals) {
+            max_var = std::max(max_var, lit.value());
+        }
+    }
+    for (const auto& sc : soft) {
+        for (const auto& lit : sc.literals) {
+            max_var = std::max(max_var, lit.value());
+        }
+    }
+    return max_var;
+}
+
+/**
+ * @return hard model extended with the soft clauses relaxed by their relaxation literal
+ */
+model relax_model(model hard, const std::vector<soft_clause>& soft, const std::vector<literal>& relaxation) {
+    for (std::size_t i = 0; i < soft.size(); ++i) {
+        std::vector<literal> relaxed = soft[i].literals;
+        relaxed.push_back(relaxation[i]);
+        for (const auto& lit : soft[i].literals) {
+            if (std::ranges::find(hard.literals, lit) == hard.literals.end()) {
+                hard.literals.emplace_back(lit.value());
+            }
+        }
+        hard.literals.push_back(relaxation[i]);
+        hard.clauses.push_back(std::move(relaxed));
+    }
+    return hard;
+}
+
+/**
+ * @brief soft assumption of the core-guided search
+ */
+struct soft_assumption {
+    literal assumption;                //!< literal assumed true (the negation of a relaxation literal or of a totalizer output)
+    std::uint64_t weight {};           //!< weight left to the assumption
+    std::optional<std::size_t> sum {}; //!< totalizer the assumption is an output of (if the assumption bounds a totalizer)
+    std::size_t bound {};              //!< bound enforced on the totalizer by the assumption
+};
+
+/**
+ * @brief totalizer built over the relaxation literals of a core, output literal at index k is true if at least k+1 inputs are true
+ */
+struct core_sum {
+    std::vector<literal> outputs;
+};
+
+} // namespace
+
+std::vector<soft_clause> make_integer_objective(std::span<const literal> bits, optimization_direction direction) {
+    fabko_assert(bits.size() < 64, "integer objective cannot have more than 63 bits");
+
+    std::vector<soft_clause> objective;
+    objective.reserve(bits.size());
+    for (std::size_t i = 0; i < bits.size(); ++i) {
+        // minimizing : each bit set costs its power of two, maximizing : each bit not set costs its power of two
+        objective.push_back(soft_clause {
+            .literals = {direction == optimization_direction::minimize ? bits[i].negation() : bits[i]},
+            .weight   = std::uint64_t {1} << i,
+        });
+    }
+    return objective;
+}
+
+optimizer::optimizer(optimization_model m, optimization_strategy strategy)
+    : strategy_(strategy)
+    , soft_(std::move(m.soft))
+    , next_var_(max_variable(m.hard, soft_) + 1)
+    , relaxation_([this] {
+        std::vector<literal> relaxation;
+        relaxation.reserve(soft_.size());
+        for (std::size_t i = 0; i < soft_.size(); ++i) {
+            relaxation.push_back(make_fresh_literal());
+        }
+        return relaxation;
+    }())
+    , solver_(relax_model(std::move(m.hard), soft_, relaxation_)) {}
+
+std::uint64_t optimizer::cost_of(const solver::result& solution) const {
+    std::unordered_map<std::int64_t, bool> values;
+    values.reserve(solution.literals.size());
+    for (const auto& lit : solution.literals) {
+        values[lit.value()] = lit.is_on();
+    }
+
+    return std::ranges::fold_left(soft_, std::uint64_t {0}, [&values](std::uint64_t cost, const soft_clause& sc) {
+        const bool satisfied = std::ranges::any_of(sc.literals, [&values](const literal& lit) {
+            const auto it = values.find(lit.value());
+            return it != values.end() && it->second == lit.is_on();
+        });
+        return satisfied ? cost : cost + sc.weight;
+    });
+}
+
+bool optimizer::record_solution(solver::result solution, const improvement_callback& on_improvement) {
+    const auto cost = cost_of(solution);
+    if (best_.has_value() && best_->cost <= cost) {
+        return false;
+    }
+    log_info("optimizer :: better solution found with cost {}", cost);
+    best_ = optimization_result {.solution = std::move(solution), .cost = cost};
+    if (on_improvement) {
+        on_improvement(*best_);
+    }
+    return true;
+}
+
+std::expected<optimization_result, sat_error> optimizer::optimize(const improvement_callback& on_improvement, const solve_limits& limits) {
+    // first resolution on the hard clauses only : check the feasibility and provide an initial upper bound
+    auto first = solver_.solve_next(limits);
+    if (!first.has_value()) {
+        return std::unexpected(first.error());
+    }
+    record_solution(std::move(first.value()), on_improvement);
+    if (best_->cost == 0) {
+        best_->optimal = true;
+        return *best_;
+    }
+
+    return strategy_ == optimization_strategy::linear_sat_unsat ? linear_search(on_improvement, limits) : core_guided_search(on_improvement, limits);
+}
+
+std::expected<optimization_result, sat_error> optimizer::linear_search(const improvement_callback& on_improvement, const solve_limits& limits) {
+    std::vector<std::pair<literal, std::uint64_t>> inputs;
+    for (std::size_t i = 0; i < soft_.size(); ++i) {
+        if (soft_[i].weight > 0) {
+            inputs.emplace_back(relaxation_[i], soft_[i].weight);
+        }
+    }
+
+    const auto outputs  = build_totalizer(solver_, inputs, best_->cost, [this] { return make_fresh_literal(); });
+    auto forbidden_from = outputs.end();
+
+    // forbid every sum of the relaxation weights reaching the cost of the best solution found
+    auto forbid_from_cost = [&](std::uint64_t cost) {
+        for (auto it = outputs.lower_bound(cost); it != forbidden_from; ++it) {
+            solver_.add_clause({it->second.negation()});
+        }
+        forbidden_from = outputs.lower_bound(cost);
+    };
+    forbid_from_cost(best_->cost);
+
+    while (true) {
+        auto res = solver_.solve_next(limits);
+        if (!res.has_value()) {
+            if (res.error() == sat_error::unsatisfiable) {
+                log_info("optimizer :: no better solution than cost {}, solution is optimal", best_->cost);
+                best_->optimal = true;
+            }
+            return *best_;
+        }
+        record_solution(std::move(res.value()), on_improvement);
+        if (best_->cost == 0) {
+            best_->optimal = true;
+            return *best_;
+        }
+        forbid_from_cost(best_->cost);
+    }
+}
+
+std::expected<optimization_result, sat_error> optimizer::core_guided_search(const improvement_callback& on_improvement, const solve_limits& limits) {
+    std::map<std::int64_t, soft_assumption> assumptions; // by variable of the assumption literal
+    std::vector<core_sum> sums;
+    std::uint64_t lower_bound = 0;
+
+    for (std::size_t i = 0; i < soft_.size(); ++i) {
+        if (soft_[i].weight > 0) {
+            assumptions.emplace(relaxation_[i].value(), soft_assumption {.assumption = relaxation_[i].negation(), .weight = soft_[i].weight});
+        }
+    }
+
+    while (lower_bound < best_->cost) {
+        std::vector<literal> assumption_literals;
+        assumption_literals.reserve(assumptions.size());
+        std::ranges::transform(assumptions, std::back_inserter(assumption_literals), [](const auto& a) { return a.second.assumption; });
+
+        auto res = solver_.solve_with_assumptions(assumption_literals, limits);
+        if (res.has_value()) {
+            // every soft assumption (and totalizer bound) holds : the cost of the solution reaches the lower bound
+            record_solution(std::move(res.value()), on_improvement);
+            break;
+        }
+        if (res.error() != sat_error::unsatisfiable) {
+            return *best_; // stopped by the limits : anytime answer
+        }
+
+        const std::vector<literal> core = solver_.unsat_core();
+        if (core.empty()) {
+            log_error("optimizer :: hard clauses found unsatisfiable after a solution has been found");
+            return std::unexpected(sat_error::error);
+        }
+
+        const auto min_weight = std::ranges::min(core | std::views::transform([&assumptions](const literal& lit) { return assumptions.at(lit.value()).weight; }));
+        lower_bound += min_weight;
+        log_debug("optimizer :: core of size {} with weight {} :: lower bound {}", core.size(), min_weight, lower_bound);
+
+        std::vector<literal> violated;
+        violated.reserve(core.size());
+        for (const literal& lit : core) {
+            auto it                = assumptions.find(lit.value());
+            soft_assumption& found = it->second;
+            violated.push_back(found.assumption.negation());
+
+            // a totalizer bound in a core is relaxed by one (OLL) : next bound of the same totalizer is assumed with the core weight
+            if (found.sum.has_value()) {
+                const auto& sum_outputs = sums[found.sum.value()].outputs;
+                if (found.bound < sum_outputs.size()) {
+                    const literal next_bound = sum_outputs[found.bound].negation();
+                    assumptions.emplace(next_bound.value(), soft_assumption {.assumption = next_bound, .weight = min_weight, .sum = found.sum, .bound = found.bound + 1});
+                }
+            }
+
+            found.weight -= min_weight;
+            if (found.weight == 0) {
+                assumptions.erase(it);
+            }
+        }
+
+        if (violated.size() == 1) {
+            solver_.add_clause({violated.front()}); // the soft element cannot be satisfied : it is hardened as violated
+            continue;
+        }
+
+        // build a totalizer over the violated literals of the core, at least one of them is violated : at most one is now assumed
+        std::vector<std::pair<literal, std::uint64_t>> inputs;
+        inputs.reserve(violated.size());
+        std::ranges::transform(violated, std::back_inserter(inputs), [](const literal& lit) { return std::make_pair(lit, std::uint64_t {1}); });
+
+        const auto outputs = build_totalizer(solver_, inputs, violated.size(), [this] { return make_fresh_literal(); });
+        core_sum sum;
+        sum.outputs.reserve(outputs.size());
+        std::ranges::transform(outputs, std::back_inserter(sum.outputs), [](const auto& output) { return output.second; });
+        sums.push_back(std::move(sum));
+
+        const literal bound_assumption = sums.back().outputs[1].negation();
+        assumptions.emplace(bound_assumption.value(), soft_assumption {.assumption = bound_assumption, .weight = min_weight, .sum = sums.size() - 1, .bound = 2});
+    }
+
+    log_info("optimizer :: optimal solution of cost {} (lower bound {})", best_->cost, lower_bound);
+    best_->optimal = true;
+    return *best_;
+}
+
+} // namespace fabko::compiler::sat
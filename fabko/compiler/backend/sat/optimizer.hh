@@ -0,0 +1,119 @@
+// Dual Licensing Either :
+// - AGPL
+// or
+// - Subscription license for commercial usage (without requirement of licensing propagation).
+//   please contact ballandfys@protonmail.com for additional information about this subscription commercial licensing.
+//
+// Created by FyS on 18/10/26. License 2022-2026
+//
+// In the case no license has been purchased for the use (modification or distribution in any way) of the software stack
+// the APGL license is applying.
+//
+
+#ifndef OPTIMIZER_HH
+#define OPTIMIZER_HH
+
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <span>
+#include <vector>
+
+#include "solver.hh"
+
+namespace fabko::compiler::sat {
+
+/**
+ * @brief clause that should be satisfied, the weight is the cost paid by a solution that does not satisfy it
+ */
+struct soft_clause {
+    std::vector<literal> literals;
+    std::uint64_t weight {1};
+};
+
+/**
+ * @brief MaxSAT model : hard clauses (the SAT model) that must be satisfied and soft clauses whose violation cost is minimized
+ */
+struct optimization_model {
+    model hard;                    //!< model that has to be satisfied
+    std::vector<soft_clause> soft; //!< clauses to satisfy at best
+};
+
+enum class optimization_strategy {
+    linear_sat_unsat, //!< search for solutions of strictly decreasing cost until the solver proves no better solution exists
+    core_guided,      //!< OLL (RC2 style) : relax the unsatisfiable cores found under soft assumptions until the assumptions are satisfiable
+};
+
+enum class optimization_direction {
+    minimize,
+    maximize,
+};
+
+/**
+ * @brief lower an integer objective (as the FABL 'prefer' optimization over a resource) into weighted soft clauses
+ * @param bits literals of the bits of the integer, from the least significant to the most significant one
+ * @param direction direction of the optimization
+ * @return soft clauses representing the objective : each bit is weighted by its power of two
+ */
+std::vector<soft_clause> make_integer_objective(std::span<const literal> bits, optimization_direction direction);
+
+struct optimization_result {
+    solver::result solution; //!< best solution found
+    std::uint64_t cost {};   //!< sum of the weights of the soft clauses not satisfied by the solution
+    bool optimal {false};    //!< true if the solution is proven optimal, false if the search has been stopped before (anytime answer)
+};
+
+/**
+ * @brief MaxSAT optimizer built on top of the SAT solver
+ *
+ * Every soft clause is relaxed by a fresh variable (the relaxation literal is true when the soft clause is allowed to be violated). The solver
+ * is then used incrementally : the hard clauses, relaxed soft clauses and learned clauses are kept in between resolutions.
+ */
+class optimizer {
+  public:
+    //! called each time a strictly better solution is found
+    using improvement_callback = std::function<void(const optimization_result&)>;
+
+    explicit optimizer(optimization_model m, optimization_strategy strategy = optimization_strategy::core_guided);
+
+    /**
+     * @brief search for a solution of minimal cost
+     * @param on_improvement callback called at each intermediate better solution
+     * @param limits cancellation, deadline and budgets applied on each resolution, if reached the best solution found so far is returned
+     * @return best solution found, sat_error::unsatisfiable if the hard clauses are unsatisfiable, sat_error::unknown if the limits stopped the
+     * search before any solution has been found
+     */
+    std::expected<optimization_result, sat_error> optimize(const improvement_callback& on_improvement = {}, const solve_limits& limits = {});
+
+    /**
+     * @return cost of a solution : sum of the weights of the soft clauses it violates
+     */
+    [[nodiscard]] std::uint64_t cost_of(const solver::result& solution) const;
+
+  private:
+    std::expected<optimization_result, sat_error> linear_search(const improvement_callback& on_improvement, const solve_limits& limits);
+    std::expected<optimization_result, sat_error> core_guided_search(const improvement_callback& on_improvement, const solve_limits& limits);
+
+    /**
+     * @brief record a solution if it improves the best solution found so far
+     * @return true if the solution is an improvement
+     */
+    bool record_solution(solver::result solution, const improvement_callback& on_improvement);
+
+    /**
+     * @return a literal on a variable unused in the model
+     */
+    literal make_fresh_literal() { return literal {next_var_++}; }
+
+    optimization_strategy strategy_;
+    std::vector<soft_clause> soft_;
+    std::int64_t next_var_;           //!< next variable unused in the model (used to generate relaxation and encoding literals)
+    std::vector<literal> relaxation_; //!< relaxation literal of each soft clause (same index)
+    solver solver_;
+
+    std::optional<optimization_result> best_ {};
+};
+
+} // namespace fabko::compiler::sat
+
+#endif // OPTIMIZER_HH
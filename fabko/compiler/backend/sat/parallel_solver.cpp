@@ -0,0 +1,172 @@
+// Dual Licensing Either :
+// - AGPL
+// or
+// - Subscription license for commercial usage (without requirement of licensing propagation).
+//   please contact ballandfys@protonmail.com for additional information about this subscription commercial licensing.
+//
+// Created by FyS on 18/10/26. License 2022-2026
+//
+// In the case no license has been purchased for the use (modification or distribution in any way) of the software stack
+// the APGL license is applying.
+//
+
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <ranges>
+#include <set>
+#include <thread>
+
+#include "common/logging.hh"
+
+#include "parallel_solver.hh"
+
+namespace fabko::compiler::sat {
+
+namespace {
+
+/**
+ * @brief diversify the configuration of a worker : the first worker keeps the configuration of the model, the others alternate the profile
+ * and restart later (the diversification never changes the model solved, the learned clauses stay valid for every worker)
+ */
+solver_context::configuration diversify(solver_context::configuration conf, std::size_t worker) {
+    if (worker == 0) {
+        return conf;
+    }
+    conf.profile           = worker % 2 == 1 ? solver_profile::unsat_heavy : conf.profile;
+    conf.restart_threshold = conf.restart_threshold * static_cast<std::uint32_t>(1 + worker / 2);
+    conf.vsids_decay_ratio = worker % 3 == 0 ? 0.8F : conf.vsids_decay_ratio;
+    conf.progress_interval = 0; // the progress is reported by the first worker only
+    return conf;
+}
+
+std::size_t total_propagations(const std::vector<solver>& workers) {
+    return std::ranges::fold_left(workers, std::size_t {0}, [](std::size_t sum, const solver& s) { return sum + s.statistics().propagations; });
+}
+
+std::size_t total_conflicts(const std::vector<solver>& workers) {
+    return std::ranges::fold_left(workers, std::size_t {0}, [](std::size_t sum, const solver& s) { return sum + s.statistics().conflicts; });
+}
+
+bool limits_reached(const solve_limits& limits) {
+    return limits.stop_token.stop_requested() || (limits.deadline.has_value() && std::chrono::steady_clock::now() >= limits.deadline.value());
+}
+
+} // namespace
+
+parallel_solver::parallel_solver(model m, parallel_configuration config)
+    : config_(config) {
+    const auto threads = std::max<std::size_t>(config_.threads, 1);
+    std::mt19937_64 random {config_.seed};
+    std::bernoulli_distribution coin {0.5};
+
+    workers_.reserve(threads);
+    for (std::size_t worker = 0; worker < threads; ++worker) {
+        model worker_model = worker + 1 < threads ? m : std::move(m);
+        worker_model.conf  = diversify(std::move(worker_model.conf), worker);
+
+        std::vector<literal> phases;
+        if (worker > 0) {
+            phases = worker_model.literals | std::views::transform([&](const literal& lit) { //
+                return coin(random) ? literal {lit.value()} : literal {-lit.value()};
+            }) | std::ranges::to<std::vector>();
+        }
+        workers_.emplace_back(std::move(worker_model)).seed({}, phases);
+    }
+    exported_.resize(threads);
+    log_info("parallel solver :: {} workers, barrier every {} propagations", threads, config_.barrier_interval);
+}
+
+std::expected<solver::result, sat_error> parallel_solver::solve(const solve_limits& limits) {
+    // the epoch of a worker only ends on its propagation budget : the cancellation and the deadline only abandon the resolution
+    const solve_limits epoch_limits {
+        .stop_token         = limits.stop_token,
+        .deadline           = limits.deadline,
+        .propagation_budget = config_.barrier_interval,
+    };
+    const auto propagations_start = total_propagations(workers_);
+    const auto conflicts_start    = total_conflicts(workers_);
+
+    std::vector<std::expected<solver::result, sat_error>> answers(workers_.size(), std::unexpected(sat_error::unknown));
+    std::vector<std::size_t> imported(workers_.size(), 0);
+    std::vector<std::size_t> learned(workers_.size(), 0);
+    std::vector<std::uint8_t> epoch_ended(workers_.size(), 0); // not a std::vector<bool> : each worker writes its own element concurrently
+    while (true) {
+        {
+            auto run_epoch = [&](std::size_t worker) {
+                imported[worker]       = import_shared_clauses(worker);
+                const auto stats_start = workers_[worker].statistics();
+                answers[worker]        = workers_[worker].solve_next(epoch_limits);
+                const auto& stats      = workers_[worker].statistics();
+                learned[worker]        = stats.learned_clause - stats_start.learned_clause;
+                epoch_ended[worker]    = stats.propagations - stats_start.propagations >= config_.barrier_interval;
+            };
+            std::vector<std::jthread> threads;
+            threads.reserve(workers_.size() - 1);
+            for (std::size_t worker = 1; worker < workers_.size(); ++worker) {
+                threads.emplace_back(run_epoch, worker);
+            }
+            run_epoch(0);
+        } // barrier : every worker has ended its epoch
+        ++statistics_.barriers;
+        std::ranges::for_each(exported_, [](auto& clauses) { clauses.clear(); });
+        statistics_.seeded_clauses += std::ranges::fold_left(imported, std::size_t {0}, std::plus {});
+
+        if (limits_reached(limits)) {
+            log_info("parallel solver :: resolution stopped by the solving limits after {} barriers, result unknown", statistics_.barriers);
+            return std::unexpected(sat_error::unknown);
+        }
+        for (std::size_t worker = 0; worker < workers_.size(); ++worker) {
+            if (answers[worker].has_value() || answers[worker].error() != sat_error::unknown) {
+                statistics_.winner = worker;
+                log_info("parallel solver :: answer of worker {} after {} barriers", worker, statistics_.barriers);
+                return std::move(answers[worker]);
+            }
+        }
+        // an unknown answer before the end of the epoch comes from another limit of the worker (memory limit) : the next epochs would stop the
+        // same way without advancing the budgets
+        if (const auto stopped = std::ranges::find(epoch_ended, std::uint8_t {0}); stopped != epoch_ended.end()) {
+            log_warn("parallel solver :: worker {} stopped before the end of its epoch after {} barriers, result unknown",
+                     std::distance(epoch_ended.begin(), stopped),
+                     statistics_.barriers);
+            return std::unexpected(sat_error::unknown);
+        }
+        const bool propagation_budget_reached =
+            limits.propagation_budget.has_value() && total_propagations(workers_) - propagations_start >= limits.propagation_budget.value();
+        const bool conflict_budget_reached = limits.conflict_budget.has_value() && total_conflicts(workers_) - conflicts_start >= limits.conflict_budget.value();
+        if (propagation_budget_reached || conflict_budget_reached) {
+            log_info("parallel solver :: budget reached after {} barriers, result unknown", statistics_.barriers);
+            return std::unexpected(sat_error::unknown);
+        }
+        share_learned_clauses(learned);
+    }
+}
+
+void parallel_solver::share_learned_clauses(std::span<const std::size_t> learned) {
+    std::set<std::vector<std::int64_t>> shared; // a clause learned by several workers during the epoch is only shared once
+    for (std::size_t worker = 0; worker < workers_.size(); ++worker) {
+        for (auto& clause : workers_[worker].learned_clauses(config_.share_max_lbd, learned[worker])) {
+            if (clause.literals.size() > config_.share_max_size) {
+                continue;
+            }
+            auto key = clause.literals | std::views::transform([](const literal& l) { return l.is_on() ? l.value() : -l.value(); }) | std::ranges::to<std::vector>();
+            std::ranges::sort(key);
+            if (shared.insert(std::move(key)).second) {
+                exported_[worker].push_back(std::move(clause));
+            }
+        }
+        statistics_.shared_clauses += exported_[worker].size();
+    }
+}
+
+std::size_t parallel_solver::import_shared_clauses(std::size_t worker) {
+    std::size_t imported = 0;
+    for (std::size_t source = 0; source < exported_.size(); ++source) {
+        if (source != worker && !exported_[source].empty()) {
+            imported += workers_[worker].seed(exported_[source], {});
+        }
+    }
+    return imported;
+}
+
+} // namespace fabko::compiler::sat
@@ -0,0 +1,103 @@
+// Dual Licensing Either :
+// - AGPL
+// or
+// - Subscription license for commercial usage (without requirement of licensing propagation).
+//   please contact ballandfys@protonmail.com for additional information about this subscription commercial licensing.
+//
+// Created by FyS on 18/10/26. License 2022-2026
+//
+// In the case no license has been purchased for the use (modification or distribution in any way) of the software stack
+// the APGL license is applying.
+//
+
+#ifndef PARALLEL_SOLVER_HH
+#define PARALLEL_SOLVER_HH
+
+#include <cstdint>
+#include <expected>
+#include <span>
+#include <vector>
+
+#include "solver.hh"
+
+namespace fabko::compiler::sat {
+
+struct parallel_configuration {
+    std::size_t threads {4};               //!< number of workers, each one solving on its own thread
+    std::size_t barrier_interval {100000}; //!< logical time between two barriers : number of propagations of each worker
+    std::uint32_t share_max_lbd {3};       //!< learned clauses of LBD lower or equal are shared with the other workers at the barriers
+    std::size_t share_max_size {32};       //!< learned clauses of more literals are not shared
+    std::uint64_t seed {42};               //!< seed of the initial phases of the workers (the first worker keeps the default phases)
+};
+
+struct parallel_statistics {
+    std::size_t barriers {0};       //!< barriers passed by the workers
+    std::size_t shared_clauses {0}; //!< learned clauses exported by a worker at a barrier
+    std::size_t seeded_clauses {0}; //!< shared clauses imported by the other workers
+    std::size_t winner {0};         //!< worker the last answer comes from
+};
+
+/**
+ * @brief Deterministic parallel solver : the same model solved with the same number of threads always gives the same answer
+ *
+ * Workers are solvers of the same model diversified by their configuration (profile, restart threshold and initial phases). They run in
+ * parallel for an epoch of logical time : each worker is given the same budget of propagations (see parallel_configuration::barrier_interval).
+ * At the barrier ending the epoch, the answers are looked for in the order of the workers (the first worker that found one wins) and the low
+ * LBD clauses learned during the epoch are exchanged, imported in the order of the workers. As the time is counted in propagations instead of
+ * wall time, what each worker does in an epoch only depends on the model and on the previous barriers : the answer does not depend on the
+ * scheduling of the threads.
+ *
+ * @note the answer is the same for a given number of threads, it can differ from the answer of the sequential solver (or of another number
+ * of threads) as any solution of the model can be found
+ * @note the workers are interrupted by the cancellation or the deadline of the limits in the middle of an epoch : the answer is then unknown,
+ * an answer is only given at the end of a complete epoch. A worker stopped by its own limits before the end of its epoch (memory limit of its
+ * configuration) also ends the resolution with an unknown answer
+ * @note each epoch is a new call to solver::solve_next which starts from the decision level 0 : every barrier is a restart of all the workers,
+ * the barrier interval is to be kept large compared to the restart intervals of the workers
+ * @note with symmetry breaking enabled no clause is shared, the clauses learned from the predicates are not implied by the model (see
+ * solver::learned_clauses)
+ */
+class parallel_solver {
+  public:
+    explicit parallel_solver(model m, parallel_configuration config = {});
+
+    /**
+     * @brief search for a solution of the model
+     * @param limits cancellation, deadline and budgets applied on the resolution, the budgets are the sums over all the workers (checked at
+     * the barriers)
+     * @return a solution if found, sat_error::unsatisfiable if there is none, or sat_error::unknown if the limits stopped the resolution
+     */
+    std::expected<solver::result, sat_error> solve(const solve_limits& limits = {});
+
+    [[nodiscard]] const parallel_statistics& statistics() const { return statistics_; }
+
+    /**
+     * @return statistics of a worker
+     */
+    [[nodiscard]] const solver_context::Statistics& worker_statistics(std::size_t worker) const { return workers_.at(worker).statistics(); }
+
+    [[nodiscard]] std::size_t worker_count() const { return workers_.size(); }
+
+  private:
+    /**
+     * @brief export the clauses learned by the workers since the last barrier, in the order of the workers
+     * @param learned number of clauses learned by each worker during the epoch (only the last learned clauses of the workers are looked at)
+     */
+    void share_learned_clauses(std::span<const std::size_t> learned);
+
+    /**
+     * @brief import into a worker the clauses exported by the other workers at the last barrier, in the order of the workers
+     * @return number of clauses imported
+     */
+    std::size_t import_shared_clauses(std::size_t worker);
+
+    parallel_configuration config_;
+    std::vector<solver> workers_;
+    std::vector<std::vector<lbd_clause>> exported_; //!< clauses exported by each worker at the last barrier
+
+    parallel_statistics statistics_ {};
+};
+
+} // namespace fabko::compiler::sat
+
+#endif // PARALLEL_SOLVER_HH
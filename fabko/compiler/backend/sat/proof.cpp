@@ -0,0 +1,127 @@
+// Dual Licensing Either :
+// - AGPL
+// or
+// - Subscription license for commercial usage (without requirement of licensing propagation).
+//   please contact ballandfys@protonmail.com for additional information about this subscription commercial licensing.
+//
+// Created by FyS on 18/10/26. License 2022-2026
+//
+// In the case no license has been purchased for the use (modification or distribution in any way) of the software stack
+// the APGL license is applying.
+//
+
+#include <charconv>
+
+#include "common/logging.hh"
+
+#include "proof.hh"
+
+namespace fabko::compiler::sat {
+
+std::expected<std::unique_ptr<proof_writer>, proof_error> proof_writer::open(const std::filesystem::path& path, proof_format format, std::size_t buffer_size) {
+    std::ofstream out {path, std::ios::binary | std::ios::trunc};
+    if (!out.is_open()) {
+        log_error("proof :: cannot open {} for writing", path.string());
+        return std::unexpected(proof_error::io_error);
+    }
+    return std::unique_ptr<proof_writer>(new proof_writer(std::move(out), format, buffer_size));
+}
+
+proof_writer::proof_writer(std::ofstream out, proof_format format, std::size_t buffer_size)
+    : out_(std::move(out))
+    , format_(format)
+    , buffer_size_(buffer_size)
+    , writer_([this](std::stop_token stop) { run(std::move(stop)); }) {
+    buffer_.reserve(buffer_size_);
+}
+
+proof_writer::~proof_writer() { [[maybe_unused]] const auto _ = close(); }
+
+void proof_writer::append_literal(std::int64_t lit) {
+    if (format_ == proof_format::binary_drat) {
+        // variable-length encoding of (2 * variable + negated) by groups of 7 bits, the highest bit is set if another group follows
+        auto encoded = static_cast<std::uint64_t>(lit < 0 ? -lit : lit) * 2 + (lit < 0 ? 1 : 0);
+        while (encoded > 0x7F) {
+            buffer_.push_back(static_cast<char>((encoded & 0x7F) | 0x80));
+            encoded >>= 7;
+        }
+        buffer_.push_back(static_cast<char>(encoded));
+        return;
+    }
+    char digits[24];
+    const auto [end, _] = std::to_chars(std::begin(digits), std::end(digits), lit);
+    buffer_.append(digits, end);
+    buffer_.push_back(' ');
+}
+
+void proof_writer::end_clause() {
+    if (format_ == proof_format::binary_drat) {
+        buffer_.push_back('\0');
+    } else {
+        buffer_.append("0\n");
+    }
+    if (buffer_.size() >= buffer_size_) {
+        submit();
+    }
+}
+
+void proof_writer::submit() {
+    if (buffer_.empty()) {
+        return;
+    }
+    std::unique_lock lock {mutex_};
+    cv_.wait(lock, [this] { return pending_.size() < max_pending_buffers; });
+    pending_.push_back(std::move(buffer_));
+    if (free_.empty()) {
+        buffer_ = std::string {};
+        buffer_.reserve(buffer_size_);
+    } else {
+        buffer_ = std::move(free_.back());
+        free_.pop_back();
+    }
+    cv_.notify_all();
+}
+
+void proof_writer::run(std::stop_token stop) {
+    std::unique_lock lock {mutex_};
+    while (true) {
+        cv_.wait(lock, stop, [this] { return !pending_.empty(); });
+        if (pending_.empty()) {
+            return; // stop requested and every buffer has been written
+        }
+        auto chunk = std::move(pending_.front());
+        pending_.pop_front();
+
+        lock.unlock();
+        out_.write(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+        const bool written = out_.good();
+        chunk.clear();
+        lock.lock();
+
+        failed_ = failed_ || !written;
+        free_.push_back(std::move(chunk));
+        cv_.notify_all();
+    }
+}
+
+std::expected<void, proof_error> proof_writer::close() {
+    if (closed_) {
+        return {};
+    }
+    closed_ = true;
+    submit();
+    writer_.request_stop();
+    writer_.join();
+
+    out_.flush();
+    const bool failed = failed_ || !out_.good();
+    out_.close();
+    if (failed) {
+        log_error("proof :: failed to write the proof");
+        return std::unexpected(proof_error::io_error);
+    }
+    log_debug("proof :: {} lemmas and {} deletions written", lemmas_, deletions_);
+    return {};
+}
+
+} // namespace fabko::compiler::sat
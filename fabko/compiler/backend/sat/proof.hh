@@ -0,0 +1,140 @@
+// Dual Licensing Either :
+// - AGPL
+// or
+// - Subscription license for commercial usage (without requirement of licensing propagation).
+//   please contact ballandfys@protonmail.com for additional information about this subscription commercial licensing.
+//
+// Created by FyS on 18/10/26. License 2022-2026
+//
+// In the case no license has been purchased for the use (modification or distribution in any way) of the software stack
+// the APGL license is applying.
+//
+
+#ifndef PROOF_HH
+#define PROOF_HH
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <expected>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ranges>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fabko::compiler::sat {
+
+enum class proof_format {
+    drat,        //!< textual DRAT : one clause per line terminated by 0, deletions prefixed by 'd'
+    binary_drat, //!< binary DRAT : 'a' or 'd' followed by the variable-length encoding of the literals, terminated by a 0 byte
+};
+
+enum class proof_error {
+    io_error, //!< the proof file cannot be opened or written
+};
+
+/**
+ * @brief Writer of a DRAT (Deletion Resolution Asymmetric Tautology) proof, as read by a proof checker (drat-trim)
+ *
+ * A DRAT proof certifies the unsatisfiability of a CNF formula : it lists the clauses learned by the solver (each one is implied by unit
+ * propagation over the formula and the previous clauses) and the clauses deleted, up to the empty clause.
+ *
+ * The clauses are serialized by the solver into a buffer, full buffers are written into the file by a background thread : the solver does
+ * not wait on the file system. The buffers are recycled, and the solver only blocks if the writer is late by several buffers.
+ *
+ * @note the literals are provided as DIMACS values (variable of the formula, negative if negated)
+ */
+class proof_writer {
+    static constexpr std::size_t max_pending_buffers = 4; //!< number of full buffers waiting to be written before the solver blocks
+
+  public:
+    static constexpr std::size_t default_buffer_size = std::size_t {1} << 20;
+
+    /**
+     * @brief open the proof file (replaced if it exists) and start the writer thread
+     * @return the writer, proof_error::io_error if the file cannot be opened
+     */
+    static std::expected<std::unique_ptr<proof_writer>, proof_error> open(
+        const std::filesystem::path& path, proof_format format = proof_format::drat, std::size_t buffer_size = default_buffer_size);
+
+    proof_writer(const proof_writer&)            = delete;
+    proof_writer& operator=(const proof_writer&) = delete;
+    ~proof_writer();
+
+    /**
+     * @brief add a clause learned by the solver to the proof (the empty clause concludes the proof of unsatisfiability)
+     */
+    void add(std::ranges::input_range auto&& literals) {
+        append('a', literals);
+        ++lemmas_;
+    }
+
+    /**
+     * @brief add the deletion of a clause to the proof
+     */
+    void remove(std::ranges::input_range auto&& literals) {
+        append('d', literals);
+        ++deletions_;
+    }
+
+    /**
+     * @brief write what remains buffered and close the file, nothing can be added to the proof afterwards
+     * @return proof_error::io_error if a write failed
+     */
+    std::expected<void, proof_error> close();
+
+    [[nodiscard]] std::size_t lemmas() const { return lemmas_; }
+    [[nodiscard]] std::size_t deletions() const { return deletions_; }
+
+  private:
+    proof_writer(std::ofstream out, proof_format format, std::size_t buffer_size);
+
+    void append(char kind, std::ranges::input_range auto&& literals) {
+        if (format_ == proof_format::binary_drat) {
+            buffer_.push_back(kind);
+        } else if (kind == 'd') {
+            buffer_.append("d ");
+        }
+        for (const std::int64_t lit : literals) {
+            append_literal(lit);
+        }
+        end_clause();
+    }
+
+    void append_literal(std::int64_t lit);
+    void end_clause();
+
+    /**
+     * @brief hand the current buffer over to the writer thread
+     */
+    void submit();
+
+    /**
+     * @brief loop of the writer thread : write the submitted buffers until stopped (the buffers left are written before stopping)
+     */
+    void run(std::stop_token stop);
+
+    std::ofstream out_;
+    proof_format format_;
+    std::size_t buffer_size_;
+    std::string buffer_;      //!< buffer being filled by the solver
+    std::size_t lemmas_ {0};
+    std::size_t deletions_ {0};
+    bool closed_ {false};
+
+    std::mutex mutex_;                 //!< protects the members below, shared with the writer thread
+    std::condition_variable_any cv_;   //!< notified on submission of a buffer and when the writer is done with one
+    std::deque<std::string> pending_;  //!< buffers submitted to the writer thread
+    std::vector<std::string> free_;    //!< buffers written, re-used by the solver
+    bool failed_ {false};              //!< true if a write failed
+
+    std::jthread writer_; //!< started last : it uses the members above
+};
+
+} // namespace fabko::compiler::sat
+
+#endif // PROOF_HH
@@ -0,0 +1,162 @@
+// Dual Licensing Either :
+// - AGPL
+// or
+// - Subscription license for commercial usage (without requirement of licensing propagation).
+//   please contact ballandfys@protonmail.com for additional information about this subscription commercial licensing.
+//
+// Created by FyS on 18/10/26. License 2022-2026
+//
+// In the case no license has been purchased for the use (modification or distribution in any way) of the software stack
+// the APGL license is applying.
+//
+
+#include <algorithm>
+#include <fstream>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "common/logging.hh"
+
+#include "snapshot.hh"
+
+namespace fabko::compiler::sat {
+
+namespace {
+
+constexpr std::size_t variables_offset() { return sizeof(snapshot_header); }
+
+constexpr std::size_t constraints_offset(const snapshot_header& header) { //
+    return variables_offset() + header.variable_count * sizeof(snapshot_variable);
+}
+
+constexpr std::size_t literals_offset(const snapshot_header& header) { //
+    return constraints_offset(header) + header.constraint_count * sizeof(snapshot_constraint);
+}
+
+template<typename T>
+void write_records(std::ofstream& out, std::span<const T> records) {
+    out.write(reinterpret_cast<const char*>(records.data()), static_cast<std::streamsize>(records.size_bytes()));
+}
+
+} // namespace
+
+std::expected<void, snapshot_error> write_snapshot(const std::filesystem::path& path,
+    snapshot_header header,
+    std::span<const snapshot_variable> variables,
+    std::span<const snapshot_constraint> constraints,
+    std::span<const std::int64_t> literals) {
+
+    header.magic            = snapshot_magic;
+    header.version          = snapshot_version;
+    header.byte_order       = snapshot_byte_order;
+    header.variable_count   = variables.size();
+    header.constraint_count = constraints.size();
+    header.literal_count    = literals.size();
+
+    std::ofstream out {path, std::ios::binary | std::ios::trunc};
+    if (!out.is_open()) {
+        log_error("snapshot :: cannot open {} for writing", path.string());
+        return std::unexpected(snapshot_error::io_error);
+    }
+    write_records(out, std::span<const snapshot_header> {&header, 1});
+    write_records(out, variables);
+    write_records(out, constraints);
+    write_records(out, literals);
+    out.flush();
+    if (!out.good()) {
+        log_error("snapshot :: failed to write {}", path.string());
+        return std::unexpected(snapshot_error::io_error);
+    }
+    return {};
+}
+
+std::expected<snapshot, snapshot_error> snapshot::open(const std::filesystem::path& path) {
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        log_error("snapshot :: cannot open {}", path.string());
+        return std::unexpected(snapshot_error::io_error);
+    }
+    struct stat file_stat {};
+    if (::fstat(fd, &file_stat) != 0) {
+        ::close(fd);
+        return std::unexpected(snapshot_error::io_error);
+    }
+    const auto size = static_cast<std::size_t>(file_stat.st_size);
+    if (size < sizeof(snapshot_header)) {
+        ::close(fd);
+        return std::unexpected(snapshot_error::invalid_format);
+    }
+    void* mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // the mapping stays valid once the descriptor is closed
+    if (mapping == MAP_FAILED) {
+        log_error("snapshot :: cannot map {}", path.string());
+        return std::unexpected(snapshot_error::io_error);
+    }
+    snapshot snap {static_cast<const std::byte*>(mapping), size};
+
+    const auto& header = snap.header();
+    if (header.magic != snapshot_magic) {
+        return std::unexpected(snapshot_error::invalid_format);
+    }
+    if (header.version != snapshot_version || header.byte_order != snapshot_byte_order) {
+        return std::unexpected(snapshot_error::unsupported_version);
+    }
+    if (literals_offset(header) + header.literal_count * sizeof(std::int64_t) != size) {
+        return std::unexpected(snapshot_error::invalid_format);
+    }
+    const bool constraints_in_bounds = std::ranges::all_of(snap.constraints(), [&header](const snapshot_constraint& constraint) { //
+        return constraint.first_literal <= header.literal_count && constraint.size <= header.literal_count - constraint.first_literal;
+    });
+    if (!constraints_in_bounds) {
+        return std::unexpected(snapshot_error::invalid_format);
+    }
+    // the literals are used as index of the variables when resuming a solver
+    const auto variable_count   = static_cast<std::int64_t>(header.variable_count);
+    const bool literals_defined = std::ranges::all_of(snap.literals(), [variable_count](std::int64_t lit) { //
+        return lit != 0 && lit >= -variable_count && lit <= variable_count;
+    });
+    if (!literals_defined) {
+        log_error("snapshot :: {} contains a literal of an undefined variable", path.string());
+        return std::unexpected(snapshot_error::invalid_format);
+    }
+    return snap;
+}
+
+snapshot::snapshot(snapshot&& other) noexcept
+    : data_(std::exchange(other.data_, nullptr))
+    , size_(std::exchange(other.size_, 0)) {}
+
+snapshot& snapshot::operator=(snapshot&& other) noexcept {
+    if (this != &other) {
+        if (data_ != nullptr) {
+            ::munmap(const_cast<std::byte*>(data_), size_);
+        }
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+    }
+    return *this;
+}
+
+snapshot::~snapshot() {
+    if (data_ != nullptr) {
+        ::munmap(const_cast<std::byte*>(data_), size_);
+    }
+}
+
+std::span<const snapshot_variable> snapshot::variables() const {
+    return {reinterpret_cast<const snapshot_variable*>(data_ + variables_offset()), header().variable_count};
+}
+
+std::span<const snapshot_constraint> snapshot::constraints() const {
+    return {reinterpret_cast<const snapshot_constraint*>(data_ + constraints_offset(header())), header().constraint_count};
+}
+
+std::span<const std::int64_t> snapshot::literals() const {
+    return {reinterpret_cast<const std::int64_t*>(data_ + literals_offset(header())), header().literal_count};
+}
+
+} // namespace fabko::compiler::sat
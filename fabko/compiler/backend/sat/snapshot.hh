@@ -0,0 +1,162 @@
+// Dual Licensing Either :
+// - AGPL
+// or
+// - Subscription license for commercial usage (without requirement of licensing propagation).
+//   please contact ballandfys@protonmail.com for additional information about this subscription commercial licensing.
+//
+// Created by FyS on 18/10/26. License 2022-2026
+//
+// In the case no license has been purchased for the use (modification or distribution in any way) of the software stack
+// the APGL license is applying.
+//
+
+#ifndef SNAPSHOT_HH
+#define SNAPSHOT_HH
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <span>
+#include <type_traits>
+
+namespace fabko::compiler::sat {
+
+//
+// Binary layout of a solver snapshot
+//
+// The file is made of a header followed by three sections of fixed size records (8 bytes aligned) : the variables, the constraints and the
+// literals of the constraints. Records are written in the native byte order, there is no parsing when loading a snapshot : the sections are
+// read in place from a memory mapping of the file.
+//
+// | snapshot_header | snapshot_variable[variable_count] | snapshot_constraint[constraint_count] | std::int64_t[literal_count] |
+
+inline constexpr std::array<char, 8> snapshot_magic {'F', 'B', 'K', 'S', 'N', 'A', 'P', '\0'};
+//! version of the layout, bumped on any change of the records : 2 added the XOR constraint records, 3 the reduction statistics,
+//! 4 the memory statistics
+inline constexpr std::uint32_t snapshot_version    = 4;
+inline constexpr std::uint32_t snapshot_byte_order = 0x01020304; //!< read back differently if the snapshot comes from another endianness
+
+enum class snapshot_error {
+    io_error,            //!< the snapshot file cannot be written, opened or mapped
+    invalid_format,      //!< the file is not a snapshot or is truncated
+    unsupported_version, //!< the snapshot has been written by an incompatible version of the solver
+};
+
+struct snapshot_statistics {
+    std::uint64_t restarts;
+    std::uint64_t rephases;
+    std::uint64_t conflicts;
+    std::uint64_t propagations;
+    std::uint64_t decisions;
+    std::uint64_t backtracks;
+    std::uint64_t chrono_backtracks;
+    std::uint64_t reused_levels;
+    std::uint64_t learned_clause;
+    std::uint64_t learned_lbd_sum;
+    std::uint64_t reductions;
+    std::uint64_t deleted_clause;
+    std::uint64_t max_decision_lvl;
+    std::uint64_t max_trail_depth;
+    std::uint64_t peak_memory_bytes; //!< the peak is kept over the whole resolution, not only the resumed process
+    std::uint64_t memory_reductions;
+    std::int64_t elapsed_ns;
+};
+
+struct snapshot_header {
+    std::array<char, 8> magic;
+    std::uint32_t version;
+    std::uint32_t byte_order;
+    std::uint64_t variable_count;
+    std::uint64_t constraint_count;
+    std::uint64_t literal_count;
+    std::uint64_t restart_threshold;                 //!< restart threshold reached (it grows along the resolution)
+    std::uint64_t conflict_count_since_last_restart;
+    snapshot_statistics statistics;
+};
+
+struct snapshot_variable {
+    std::int64_t external;       //!< variable of the model provided to the solver, the internal variable is the index of the record + 1
+    std::int64_t vsids_activity;
+    std::uint8_t saved_phase;    //!< 1 if the saved phase is on, 0 otherwise
+    std::array<std::uint8_t, 7> padding;
+};
+
+enum class snapshot_constraint_kind : std::uint8_t {
+    clause,         //!< clause of the model
+    learned_clause, //!< clause learned through the conflict analysis
+    cardinality,    //!< cardinality constraint of the model
+    xor_constraint, //!< XOR constraint of the model (its parity is stored in at_most)
+};
+
+struct snapshot_constraint {
+    std::uint64_t first_literal; //!< index of the first literal of the constraint in the literal section
+    std::uint32_t size;          //!< number of literals of the constraint
+    snapshot_constraint_kind kind;
+    std::uint8_t has_at_least;   //!< 1 if the cardinality constraint has a lower bound
+    std::uint16_t lbd;           //!< LBD of a learned clause when it was learned (saturated at the maximum value)
+    std::uint64_t at_most;       //!< upper bound of a cardinality constraint
+    std::uint64_t at_least;      //!< lower bound of a cardinality constraint (valid if has_at_least)
+};
+
+static_assert(std::is_trivially_copyable_v<snapshot_header> && sizeof(snapshot_header) % 8 == 0);
+static_assert(std::is_trivially_copyable_v<snapshot_variable> && sizeof(snapshot_variable) % 8 == 0);
+static_assert(std::is_trivially_copyable_v<snapshot_constraint> && sizeof(snapshot_constraint) % 8 == 0);
+
+/**
+ * @brief write the records of a snapshot into a file (the header counts are set from the size of the sections)
+ * @return snapshot_error::io_error if the file cannot be written
+ */
+std::expected<void, snapshot_error> write_snapshot(const std::filesystem::path& path,
+    snapshot_header header,
+    std::span<const snapshot_variable> variables,
+    std::span<const snapshot_constraint> constraints,
+    std::span<const std::int64_t> literals);
+
+/**
+ * @brief Read-only view on a solver snapshot file
+ *
+ * The file is memory mapped and validated (magic, version, byte order, size of the sections and variables of the literals) when opened. The records are then accessed in
+ * place : warm-starting a solver from a large clause database does not require to parse nor to copy the file beforehand.
+ *
+ * @note a snapshot is written by solver::save_snapshot, a solver is resumed from it with the solver(const snapshot&) constructor
+ */
+class snapshot {
+  public:
+    /**
+     * @brief map the snapshot file in memory
+     * @return a view on the snapshot, snapshot_error if the file cannot be mapped or is not a valid snapshot
+     */
+    static std::expected<snapshot, snapshot_error> open(const std::filesystem::path& path);
+
+    snapshot(snapshot&& other) noexcept;
+    snapshot& operator=(snapshot&& other) noexcept;
+    snapshot(const snapshot&)            = delete;
+    snapshot& operator=(const snapshot&) = delete;
+    ~snapshot();
+
+    [[nodiscard]] const snapshot_header& header() const { return *reinterpret_cast<const snapshot_header*>(data_); }
+    [[nodiscard]] std::span<const snapshot_variable> variables() const;
+    [[nodiscard]] std::span<const snapshot_constraint> constraints() const;
+    [[nodiscard]] std::span<const std::int64_t> literals() const;
+
+    /**
+     * @return literals of a constraint (expressed with the internal variables)
+     */
+    [[nodiscard]] std::span<const std::int64_t> literals_of(const snapshot_constraint& constraint) const {
+        return literals().subspan(constraint.first_literal, constraint.size);
+    }
+
+  private:
+    snapshot(const std::byte* data, std::size_t size)
+        : data_(data)
+        , size_(size) {}
+
+    const std::byte* data_ {nullptr};
+    std::size_t size_ {0};
+};
+
+} // namespace fabko::compiler::sat
+
+#endif // SNAPSHOT_HH
@@ -11,22 +11,397 @@
 //
 
 #include <algorithm>
+#include <array>
+#include <cctype>
+#include <charconv>
+#include <chrono>
+#include <exception>
 #include <expected>
 #include <filesystem>
 #include <fstream>
+#include <functional>
+#include <ranges>
 #include <set>
+#include <sstream>
 #include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include "common/logging.hh"
 
 #include "solver.hh"
+#include "symmetry.hh"
 
 namespace fabko::compiler::sat {
 
 namespace impl_details {
-std::expected<solver::result, sat_error> solve_sat(solver_context& ctx, const model& model);
+std::expected<solver::result, sat_error> solve_sat(solver_context& ctx, const model& model, const solve_limits& limits);
+void backtrack(solver_context& ctx, std::size_t level);
 } // namespace impl_details
 
+namespace {
+
+/**
+ * @return identifier of the variable of the (internal) literal in the solver context, the variable is added to the model and the context if not
+ * existing yet (a new internal variable is always the next one as internal variables are dense)
+ */
+Vars_Soa::struct_id find_or_insert_var(solver_context& ctx, model& m, literal lit) {
+    const auto index = static_cast<std::size_t>(lit.value() - 1);
+    if (index < ctx.var_ids_.size()) {
+        return ctx.var_ids_[index];
+    }
+    fabko_assert(index == ctx.var_ids_.size(), "internal variables are allocated densely");
+    const literal var {lit.value()};
+    m.literals.push_back(var);
+    ctx.var_ids_.push_back(ctx.vars_soa_.insert(var, assignment::not_assigned, assignment_context {}, variable_heuristics {}, metadata {}));
+    return ctx.var_ids_.back();
+}
+
+/**
+ * @return metadata of a constraint of the model : the FABL construct its variables have been generated for (the atoms of the sat_builder only
+ * constrain their own variables, the first variable with a context is taken)
+ */
+metadata constraint_metadata(const model& m, std::ranges::input_range auto&& literals) {
+    if (m.literal_context.empty()) {
+        return metadata {};
+    }
+    for (const auto& lit : literals) {
+        if (const auto it = m.literal_context.find(lit); it != m.literal_context.end()) {
+            return metadata {it->second};
+        }
+    }
+    return metadata {};
+}
+
+/**
+ * @return model expressed with internal variables (densely numbered from 1 in order of first appearance)
+ */
+model to_internal_model(model m, variable_map& variables) {
+    auto to_internal = [&variables](const literal& l) { return variables.to_internal(l); };
+
+    model internal {.conf = std::move(m.conf)};
+    internal.literals.reserve(m.literals.size());
+    for (const auto& lit : m.literals) {
+        if (const auto known = variables.size(); to_internal(lit).value() > static_cast<std::int64_t>(known)) {
+            internal.literals.emplace_back(static_cast<std::int64_t>(known + 1)); // duplicated variables are only defined once
+        }
+    }
+    internal.clauses.reserve(m.clauses.size());
+    for (const auto& clause : m.clauses) {
+        internal.clauses.push_back(clause | std::views::transform(to_internal) | std::ranges::to<std::vector>());
+    }
+    internal.cardinalities.reserve(m.cardinalities.size());
+    for (auto& [literals, at_most, at_least] : m.cardinalities) {
+        internal.cardinalities.push_back({
+            .literals = literals | std::views::transform(to_internal) | std::ranges::to<std::vector>(),
+            .at_most  = at_most,
+            .at_least = at_least,
+        });
+    }
+    internal.xors.reserve(m.xors.size());
+    for (auto& [literals, parity] : m.xors) {
+        internal.xors.push_back({.literals = literals | std::views::transform(to_internal) | std::ranges::to<std::vector>(), .parity = parity});
+    }
+    for (auto& [lit, ctx] : m.literal_context) {
+        internal.literal_context.emplace(to_internal(lit), std::move(ctx));
+    }
+
+    // variables only referenced by the constraints are part of the model as well
+    for (std::size_t var = internal.literals.size() + 1; var <= variables.size(); ++var) {
+        internal.literals.emplace_back(static_cast<std::int64_t>(var));
+    }
+    return internal;
+}
+
+/**
+ * @brief make the native cardinality constraints (at most bounds) of a model cardinality constraint
+ * @note a lower bound is turned into an upper bound on the negated literals : at least m literals true <=> at most n - m literals false
+ * @param vars variables of the solver, the literals of the constraint have to be defined in it
+ * @param constraint cardinality constraint to transform
+ * @param find_var function returning the variable identifier of a literal
+ * @return native constraints (none if the bounds are trivially satisfied)
+ */
+std::vector<cardinality> make_cardinalities(const cardinality_constraint& constraint, const std::function<Vars_Soa::struct_id(const literal&)>& find_var) {
+    const auto size = constraint.literals.size();
+    fabko_assert(!constraint.at_least.has_value() || constraint.at_least.value() <= std::min(size, constraint.at_most),
+        "a cardinality constraint lower bound cannot be greater than its upper bound or its number of literals");
+
+    std::vector<Vars_Soa::struct_id> ids;
+    ids.reserve(size);
+    std::ranges::transform(constraint.literals, std::back_inserter(ids), find_var);
+
+    std::vector<cardinality> res;
+    if (constraint.at_most < size) {
+        res.emplace_back(constraint.literals, ids, constraint.at_most);
+    }
+    if (constraint.at_least.value_or(0) > 0) {
+        auto negated = constraint.literals | std::views::transform([](const literal& l) { return l.negation(); }) | std::ranges::to<std::vector>();
+        res.emplace_back(std::move(negated), std::move(ids), size - constraint.at_least.value());
+    }
+    return res;
+}
+
+/**
+ * @brief add a XOR constraint (on variables defined in the solver) to the XOR engine of the solver, the negated literals flip the parity
+ */
+void insert_xor(solver_context& ctx, const xor_constraint& constraint) {
+    bool parity = constraint.parity;
+    std::vector<std::uint32_t> variables;
+    variables.reserve(constraint.literals.size());
+    for (const auto& lit : constraint.literals) {
+        fabko_assert(lit.value() >= 1 && static_cast<std::size_t>(lit.value()) <= ctx.var_ids_.size(), "a XOR constraint cannot contains a non-defined literal");
+        variables.push_back(static_cast<std::uint32_t>(lit.value() - 1));
+        parity ^= lit.is_off();
+    }
+    ctx.xors_.add(variables, parity);
+}
+
+/**
+ * @brief add a learned clause (on variables defined in the solver) to the clause database of the solver
+ */
+void insert_learned_clause(solver_context& ctx, std::span<const std::pair<literal, Vars_Soa::struct_id>> literals, std::uint32_t lbd) {
+    clause learned {clause_literals {literals.begin(), literals.end(), ctx.clause_allocator()}};
+    clause_watcher watcher {ctx.vars_soa_, learned};
+    ctx.learned_clauses_.push_back({.clause_index = static_cast<std::uint32_t>(ctx.clause_ids_.size()), .lbd = lbd});
+    ctx.clause_ids_.push_back(ctx.clauses_soa_.insert(std::move(learned), std::move(watcher), metadata {}));
+}
+
+/**
+ * @return signed value of a literal (negative if the literal is off)
+ */
+std::int64_t signed_value(const literal& lit) { return lit.is_off() ? -lit.value() : lit.value(); }
+
+/**
+ * @return model stored in a snapshot expressed with the external variables (learned clauses are not part of it)
+ * @note the variables are listed in the order of the internal variables, the renumbering of the resumed solver is then identical
+ */
+model model_from_snapshot(const snapshot& snap, solver_context::configuration conf) {
+    const auto variables = snap.variables();
+    auto to_external     = [&variables](std::int64_t internal) {
+        const auto index = static_cast<std::size_t>(std::abs(internal) - 1);
+        fabko_assert(internal != 0 && index < variables.size(), "a snapshot constraint cannot contains a non-defined literal");
+        return literal {internal < 0 ? -variables[index].external : variables[index].external};
+    };
+
+    model m {.conf = std::move(conf)};
+    m.conf.restart_threshold = static_cast<std::uint32_t>(snap.header().restart_threshold);
+    m.literals = variables | std::views::transform([](const snapshot_variable& var) { return literal {var.external}; }) | std::ranges::to<std::vector>();
+    for (const auto& constraint : snap.constraints()) {
+        auto literals = snap.literals_of(constraint) | std::views::transform(to_external) | std::ranges::to<std::vector>();
+        if (constraint.kind == snapshot_constraint_kind::clause) {
+            m.clauses.push_back(std::move(literals));
+        } else if (constraint.kind == snapshot_constraint_kind::xor_constraint) {
+            m.xors.push_back({.literals = std::move(literals), .parity = constraint.at_most == 1});
+        } else if (constraint.kind == snapshot_constraint_kind::cardinality) {
+            m.cardinalities.push_back({
+                .literals = std::move(literals),
+                .at_most  = constraint.at_most,
+                .at_least = constraint.has_at_least == 1 ? std::optional {constraint.at_least} : std::nullopt,
+            });
+        }
+    }
+    return m;
+}
+
+snapshot_statistics to_snapshot_statistics(const solver_context::Statistics& stats) {
+    return {
+        .restarts          = stats.restarts,
+        .rephases          = stats.rephases,
+        .conflicts         = stats.conflicts,
+        .propagations      = stats.propagations,
+        .decisions         = stats.decisions,
+        .backtracks        = stats.backtracks,
+        .chrono_backtracks = stats.chrono_backtracks,
+        .reused_levels     = stats.reused_levels,
+        .learned_clause    = stats.learned_clause,
+        .learned_lbd_sum   = stats.learned_lbd_sum,
+        .reductions        = stats.reductions,
+        .deleted_clause    = stats.deleted_clause,
+        .max_decision_lvl  = stats.max_decision_lvl,
+        .max_trail_depth   = stats.max_trail_depth,
+        .peak_memory_bytes = stats.peak_memory_bytes,
+        .memory_reductions = stats.memory_reductions,
+        .elapsed_ns        = std::chrono::duration_cast<std::chrono::nanoseconds>(stats.elapsed).count(),
+    };
+}
+
+solver_context::Statistics from_snapshot_statistics(const snapshot_statistics& stats) {
+    return {
+        .restarts          = stats.restarts,
+        .rephases          = stats.rephases,
+        .conflicts         = stats.conflicts,
+        .propagations      = stats.propagations,
+        .decisions         = stats.decisions,
+        .backtracks        = stats.backtracks,
+        .chrono_backtracks = stats.chrono_backtracks,
+        .reused_levels     = stats.reused_levels,
+        .learned_clause    = stats.learned_clause,
+        .learned_lbd_sum   = stats.learned_lbd_sum,
+        .reductions        = stats.reductions,
+        .deleted_clause    = stats.deleted_clause,
+        .max_decision_lvl  = stats.max_decision_lvl,
+        .max_trail_depth   = stats.max_trail_depth,
+        .peak_memory_bytes = stats.peak_memory_bytes,
+        .memory_reductions = stats.memory_reductions,
+        .elapsed           = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::nanoseconds {stats.elapsed_ns}),
+    };
+}
+
+//! size of the clauses parsed by each thread loading a CNF file (when the number of threads is not given)
+constexpr std::size_t cnf_min_chunk_size = 1 << 20;
+
+/**
+ * @brief read-only memory mapping of a file, the chunks of a CNF file are parsed in place without copying the file
+ */
+class mapped_file {
+  public:
+    /**
+     * @throws std::runtime_error if the file cannot be opened or mapped
+     */
+    explicit mapped_file(const std::filesystem::path& path) {
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("Could not open CNF file");
+        }
+        struct stat file_stat {};
+        if (::fstat(fd, &file_stat) != 0) {
+            ::close(fd);
+            throw std::runtime_error("Could not open CNF file");
+        }
+        size_ = static_cast<std::size_t>(file_stat.st_size);
+        if (size_ == 0) {
+            ::close(fd);
+            return; // an empty file cannot be mapped
+        }
+        void* mapping = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd); // the mapping stays valid once the descriptor is closed
+        if (mapping == MAP_FAILED) {
+            throw std::runtime_error("Could not map CNF file");
+        }
+        ::madvise(mapping, size_, MADV_SEQUENTIAL);
+        data_ = static_cast<const char*>(mapping);
+    }
+
+    mapped_file(const mapped_file&)            = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+
+    ~mapped_file() {
+        if (data_ != nullptr) {
+            ::munmap(const_cast<char*>(data_), size_);
+        }
+    }
+
+    [[nodiscard]] std::string_view text() const { return data_ == nullptr ? std::string_view {} : std::string_view {data_, size_}; }
+
+  private:
+    const char* data_ {nullptr};
+    std::size_t size_ {0};
+};
+
+struct cnf_header {
+    std::size_t num_variables {0};
+    std::size_t num_clauses {0};
+    std::string_view body {}; //!< clauses of the file, following the header
+};
+
+/**
+ * @brief parse the header of a CNF file : the 'p cnf' line, preceded by comments
+ * @throws std::runtime_error if the header is not a 'p cnf' line
+ */
+cnf_header parse_cnf_header(std::string_view text) {
+    cnf_header header {.body = text};
+    while (!header.body.empty()) {
+        const auto line_end = std::min(header.body.find('\n'), header.body.size());
+        const auto line     = header.body.substr(0, line_end);
+        if (!line.empty() && line[0] != 'c' && line[0] != 'p') {
+            break; // no header, the clauses start
+        }
+        header.body.remove_prefix(std::min(line_end + 1, header.body.size()));
+        if (!line.empty() && line[0] == 'p') {
+            std::istringstream iss {std::string {line}};
+            std::string p, cnf;
+            iss >> p >> cnf >> header.num_variables >> header.num_clauses;
+            if (p != "p" || cnf != "cnf") {
+                throw std::runtime_error("Invalid CNF format");
+            }
+            break;
+        }
+    }
+    return header;
+}
+
+/**
+ * @brief clauses of a chunk of a CNF file : the literals of the chunk are stored contiguously, a clause ends at each 0 of the file
+ *
+ * As a clause can span over multiple lines, the first clause of a chunk can be the end of a clause started in the previous chunks, and the
+ * literals following the last 0 of the chunk start a clause terminated in the next chunks.
+ */
+struct cnf_chunk {
+    std::vector<literal> literals {};        //!< literals of the chunk in the order of the file
+    std::vector<std::size_t> clause_ends {}; //!< position in literals of the end of each clause (a 0 in the file)
+};
+
+/**
+ * @brief parse the clauses of a chunk of a CNF file (starting on a line)
+ * @param num_variables number of variables declared by the header of the file
+ * @note the rest of a line that is not a literal is ignored (e.g. the '%' ending the SATLIB files)
+ * @throws std::runtime_error if the chunk contains a second header or a literal of a variable above the number declared
+ */
+cnf_chunk parse_cnf_chunk(std::string_view text, std::size_t num_variables) {
+    cnf_chunk chunk;
+    while (!text.empty()) {
+        const auto line_end = std::min(text.find('\n'), text.size());
+        const auto line     = text.substr(0, line_end);
+        text.remove_prefix(std::min(line_end + 1, text.size()));
+        if (line.empty() || line[0] == 'c') {
+            continue; // Skip comments and empty lines
+        }
+        if (line[0] == 'p') {
+            throw std::runtime_error("Unexpected 'p' is specified twice");
+        }
+
+        const char* it  = line.data();
+        const char* end = line.data() + line.size();
+        while (true) {
+            it = std::find_if_not(it, end, [](char c) { return std::isspace(static_cast<unsigned char>(c)); });
+            if (it == end) {
+                break;
+            }
+            std::int64_t lit      = 0;
+            const auto [next, ec] = std::from_chars(it, end, lit);
+            if (ec != std::errc {}) {
+                break;
+            }
+            it = next;
+            if (static_cast<std::size_t>(std::abs(lit)) > num_variables) {
+                throw std::runtime_error(fmt::format("Literal {} above the {} variables declared", lit, num_variables));
+            }
+            if (lit == 0) {
+                chunk.clause_ends.push_back(chunk.literals.size());
+            } else {
+                chunk.literals.emplace_back(lit);
+            }
+        }
+    }
+    return chunk;
+}
+
+/**
+ * @return first literal of a clause, a watcher cannot be made over an empty clause
+ */
+const clause_watcher::watched_literal& first_literal(const clause& c) {
+    fabko_assert(!c.get_literals().empty(), "Cannot make a clause watchers over an empty clause");
+    return c.get_literals().front();
+}
+
+} // namespace
+
 solver_context::solver_context(const model& model)
     : config_(model.conf)
     , model_(model)
@@ -35,34 +410,108 @@ solver_context::solver_context(const model& model)
         vars.reserve(model.literals.size());
         for (const auto& lit : model.literals) {
             [[maybe_unused]] auto _ =
-                vars.insert(lit, assignment::not_assigned, assignment_context {/*empty assignment context*/}, metadata {/*@todo: add compiler context from model*/});
+                vars.insert(lit, assignment::not_assigned, assignment_context {/*empty assignment context*/}, variable_heuristics {}, metadata {/*@todo: add compiler context from model*/});
         }
         return vars;
     }())
+    , var_ids_([&]() {
+        std::vector<Vars_Soa::struct_id> ids;
+        ids.reserve(model.literals.size());
+        for (const auto& var : vars_soa_) {
+            fabko_assert(get<soa_literal>(var).value() == static_cast<std::int64_t>(ids.size() + 1), "model variables must be densely numbered from 1");
+            ids.push_back(var.struct_id());
+        }
+        return ids;
+    }())
     , clauses_soa_([&]() {
         Clauses_Soa clauses;
         clauses.reserve(model.clauses.size());
 
         for (const std::vector<literal>& model_clause : model.clauses) {
             auto all_clause_ids = std::ranges::fold_left(model_clause, std::vector<Vars_Soa::struct_id> {}, [&, this](auto res, const literal& l) { //
-                auto it = std::ranges::find_if(vars_soa_, fil::soa::index_select<soa_literal>([&, this](literal lit) {                              //
-                    return lit == l;
-                }));
-                fabko_assert(it != vars_soa_.end(), "a clause cannot contains a non-defined literal");
-                ++get<soa_assignment_ctx>(*it).vsids_activity_;
-                res.push_back((*it).struct_id());
+                fabko_assert(l.value() >= 1 && static_cast<std::size_t>(l.value()) <= var_ids_.size(), "a clause cannot contains a non-defined literal");
+                const auto varid = var_ids_[l.value() - 1];
+                ++get<soa_var_heuristics>(vars_soa_[varid]).vsids_activity_;
+                res.push_back(varid);
                 return res;
             });
 
-            clause clause_to_insert {model_clause, std::move(all_clause_ids)};
-            [[maybe_unused]] const auto _ = clauses.insert( //
-                clause_to_insert,
-                clause_watcher {vars_soa_, clause_to_insert},
-                metadata {/*@todo: add compiler context from model*/});
+            clause clause_to_insert {model_clause, std::move(all_clause_ids), clause_allocator()};
+            clause_watcher watcher {vars_soa_, clause_to_insert};
+            [[maybe_unused]] const auto _ = clauses.insert(std::move(clause_to_insert), std::move(watcher), constraint_metadata(model, model_clause));
         }
         return clauses;
+    }())
+    , cardinalities_soa_([&]() {
+        Cardinalities_Soa cardinalities;
+        cardinalities.reserve(model.cardinalities.size());
+
+        auto find_var = [this](const literal& l) {
+            fabko_assert(l.value() >= 1 && static_cast<std::size_t>(l.value()) <= var_ids_.size(), "a cardinality constraint cannot contains a non-defined literal");
+            const auto varid = var_ids_[l.value() - 1];
+            ++get<soa_var_heuristics>(vars_soa_[varid]).vsids_activity_;
+            return varid;
+        };
+        for (const cardinality_constraint& constraint : model.cardinalities) {
+            for (auto& card : make_cardinalities(constraint, find_var)) {
+                [[maybe_unused]] const auto _ = cardinalities.insert(std::move(card), constraint_metadata(model, constraint.literals));
+            }
+        }
+        return cardinalities;
+    }())
+    , clause_ids_([&]() {
+        std::vector<Clauses_Soa::struct_id> ids;
+        ids.reserve(clauses_soa_.size());
+        for (const auto& clause_struct : clauses_soa_) {
+            ids.push_back(clause_struct.struct_id());
+        }
+        return ids;
+    }())
+    , cardinality_ids_([&]() {
+        std::vector<Cardinalities_Soa::struct_id> ids;
+        ids.reserve(cardinalities_soa_.size());
+        for (const auto& card_struct : cardinalities_soa_) {
+            ids.push_back(card_struct.struct_id());
+        }
+        return ids;
     }()) {}
 
+std::vector<bool> solver_context::learned_clause_mask() const {
+    std::vector<bool> mask(clause_ids_.size(), false);
+    for (const auto& learned : learned_clauses_) {
+        mask[learned.clause_index] = true;
+    }
+    return mask;
+}
+
+std::string to_string(const solver_context::Statistics& stats) {
+    return fmt::format("time {:.3f}s | conflicts {} ({:.1f}/s) | propagations {} ({:.1f}/s) | decisions {} | restarts {} (reused levels {}) | "
+                       "backtracks {} (chrono {}) | rephases {} | learned clauses {} (avg LBD {:.2f}, deleted {} in {} reductions) | max decision level {} | "
+                       "trail depth {} (max {}) | memory {:.2f} MiB (peak {:.2f} MiB, learned clauses {:.2f} MiB, {} reductions on limit)",
+        std::chrono::duration<double>(stats.elapsed).count(),
+        stats.conflicts,
+        stats.conflicts_per_second(),
+        stats.propagations,
+        stats.propagations_per_second(),
+        stats.decisions,
+        stats.restarts,
+        stats.reused_levels,
+        stats.backtracks,
+        stats.chrono_backtracks,
+        stats.rephases,
+        stats.learned_clause,
+        stats.average_lbd(),
+        stats.deleted_clause,
+        stats.reductions,
+        stats.max_decision_lvl,
+        stats.trail_depth,
+        stats.max_trail_depth,
+        static_cast<double>(stats.memory_bytes) / (1024.0 * 1024.0),
+        static_cast<double>(stats.peak_memory_bytes) / (1024.0 * 1024.0),
+        static_cast<double>(stats.learned_clause_bytes) / (1024.0 * 1024.0),
+        stats.memory_reductions);
+}
+
 std::string to_string(assignment a) {
     switch (a) {
         case assignment::on: return "on";
@@ -72,49 +521,47 @@ std::string to_string(assignment a) {
 }
 
 clause_watcher::clause_watcher(const Vars_Soa& vs, const clause& clause)
-    : watchers_([&]() -> std::array<std::optional<Vars_Soa::struct_id>, 2> { //
-        fabko_assert(!clause.get_literals().empty(), "Cannot make a clause watchers over an empty clause");
-
-        auto filtered =
-            std::ranges::views::filter(clause.get_literals(), [&vs](const auto& lit_id_pair) { return get<soa_assignment>(vs[lit_id_pair.second]) == assignment::not_assigned; }) //
-            | std::views::transform([&vs](const auto& lit_id_pair) { return vs[lit_id_pair.second].struct_id(); });                                                               //
-
-        auto it = filtered.begin();
-        if (it == filtered.end())
-            return {std::nullopt, std::nullopt};      // no watched literals, clause is satisfied
-        if (++it == filtered.end())
-            return {*filtered.begin(), std::nullopt}; // no watched literals, clause is satisfied
-
-        return {std::make_optional(*filtered.begin()), std::make_optional(*it)};
-    }()) {}
+    : watched_ {first_literal(clause).second, first_literal(clause).second}
+    , blocker_(first_literal(clause)) {
+    for (const auto& [lit, varid] : clause.get_literals()) {
+        if (get<soa_assignment>(vs[varid]) == assignment::not_assigned) {
+            watched_[size_] = vs[varid].struct_id();
+            if (++size_ == watched_.size()) {
+                break; // no more than 2 literals watched, a clause with a single unassigned literal is unit (or satisfied)
+            }
+        }
+    }
+}
 
 void clause_watcher::replace(const Vars_Soa& vs, const clause& clause, Vars_Soa::struct_id to_replace) {
-
-    if ((!watchers_[0].has_value() || watchers_[0].value().offset != to_replace.offset) && //
-        (!watchers_[1].has_value() || watchers_[1].value().offset != to_replace.offset))
+    const auto watched = std::ranges::find_if(get_watched(), [&to_replace](const auto& varid) { return varid.offset == to_replace.offset; });
+    if (watched == get_watched().end())
         return;
 
-    auto& replace_ref = (watchers_[0].value().offset == to_replace.offset) ? watchers_[0] : watchers_[1];
-    auto& other_ref   = (watchers_[0].value().offset != to_replace.offset) ? watchers_[0] : watchers_[1];
-
-    // remove the watched literal
-    replace_ref = std::nullopt;
+    const auto replace_index = static_cast<std::size_t>(std::ranges::distance(get_watched().begin(), watched));
+    std::optional<Vars_Soa::struct_id> other;
+    if (size_ == 2) {
+        other = watched_[1 - replace_index];
+    }
 
-    const auto it = std::ranges::find_if(clause.get_literals(), [&vs, &other_ref](const auto& lit_id_pair) { //
-        if (other_ref.has_value() && other_ref.value().offset == lit_id_pair.second.offset) {
+    const auto it = std::ranges::find_if(clause.get_literals(), [&vs, &other](const auto& lit_id_pair) { //
+        if (other.has_value() && other.value().offset == lit_id_pair.second.offset) {
             return false;
         }
         return get<soa_assignment>(vs[lit_id_pair.second]) == assignment::not_assigned;
     });
-    if (it == clause.get_literals().end()) {
+    if (it != clause.get_literals().end()) {
+        watched_[replace_index] = vs[it->second].struct_id();
         return;
     }
 
-    replace_ref = {vs[it->second].struct_id()};
+    // remove the watched literal : the other one (if any) is kept first
+    if (other.has_value()) {
+        watched_[0] = other.value();
+    }
+    --size_;
 }
 
-std::uint8_t clause_watcher::size() const { return (watchers_[0].has_value() ? 1 : 0) + (watchers_[1].has_value() ? 1 : 0); }
-
 model make_model_from_cnf_file(const std::filesystem::path& cnf_file) {
     if (!std::filesystem::exists(cnf_file)) {
         throw std::runtime_error("CNF file does not exist");
@@ -181,21 +628,640 @@ model make_model_from_cnf_file(const std::filesystem::path& cnf_file) {
     };
 }
 
+solver make_solver_from_cnf_file(const std::filesystem::path& cnf_file, solver_context::configuration conf, std::size_t threads) {
+    const mapped_file file {cnf_file};
+    const auto text = file.text();
+
+    // the header is validated once, the clauses after it are split into chunks starting on a line
+    const auto [num_variables, expected_clauses, body] = parse_cnf_header(text);
+    if (threads == 0) {
+        threads = std::clamp<std::size_t>(body.size() / cnf_min_chunk_size, 1, std::max(std::thread::hardware_concurrency(), 1U));
+    }
+    std::vector<std::string_view> texts;
+    std::size_t chunk_begin = 0;
+    for (std::size_t chunk = 1; chunk <= threads && chunk_begin < body.size(); ++chunk) {
+        // a chunk ends with the line on which its share of the file ends
+        auto chunk_end = chunk == threads ? std::string_view::npos : body.find('\n', std::max(chunk_begin, chunk * body.size() / threads));
+        chunk_end      = chunk_end == std::string_view::npos ? body.size() : chunk_end + 1;
+        texts.push_back(body.substr(chunk_begin, chunk_end - chunk_begin));
+        chunk_begin = chunk_end;
+    }
+
+    std::vector<cnf_chunk> chunks(texts.size());
+    std::vector<std::exception_ptr> errors(texts.size());
+    {
+        auto parse = [&](std::size_t chunk) {
+            try {
+                chunks[chunk] = parse_cnf_chunk(texts[chunk], num_variables);
+            } catch (...) {
+                errors[chunk] = std::current_exception();
+            }
+        };
+        std::vector<std::jthread> workers;
+        workers.reserve(texts.size());
+        for (std::size_t chunk = 1; chunk < texts.size(); ++chunk) {
+            workers.emplace_back(parse, chunk);
+        }
+        if (!texts.empty()) {
+            parse(0);
+        }
+    } // every chunk is parsed
+    for (const auto& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    // the chunks are ingested in the order of the file : the variables are numbered as if the file was parsed sequentially
+    solver_builder builder {std::move(conf)};
+    builder.reserve(num_variables, expected_clauses);
+    std::vector<literal> spanning; // clause started in a chunk and terminated in a following one
+    std::size_t clause_count = 0;
+    auto add_clause          = [&](std::span<const literal> clause) {
+        if (!clause.empty()) {
+            builder.add_clause(clause);
+            ++clause_count;
+        }
+    };
+    for (const auto& chunk : chunks) {
+        std::size_t begin = 0;
+        for (const auto end : chunk.clause_ends) {
+            const std::span<const literal> clause {chunk.literals.data() + begin, end - begin};
+            if (spanning.empty()) {
+                add_clause(clause);
+            } else {
+                spanning.insert(spanning.end(), clause.begin(), clause.end());
+                add_clause(spanning);
+                spanning.clear();
+            }
+            begin = end;
+        }
+        spanning.insert(spanning.end(), chunk.literals.begin() + static_cast<std::ptrdiff_t>(begin), chunk.literals.end());
+    }
+    add_clause(spanning);
+
+    fabko_assert(clause_count == expected_clauses, //
+        fmt::format("More clauses than expected, expected {} but got {}", expected_clauses, clause_count));
+    return std::move(builder).build();
+}
+
+solver_builder& solver_builder::add_variable(const literal& var, std::optional<fabl::compiler_generation_context> context) {
+    const auto internal           = solver_.variables_.to_internal(literal {var.value()});
+    [[maybe_unused]] const auto _ = find_or_insert_var(solver_.context_, solver_.model_, internal);
+    if (context.has_value()) {
+        solver_.model_.literal_context.insert_or_assign(internal, std::move(context.value()));
+    }
+    return *this;
+}
+
+literal variable_map::to_internal(const literal& external) {
+    const auto [it, inserted] = internal_.try_emplace(external.value(), static_cast<std::uint32_t>(external_.size()));
+    if (inserted) {
+        external_.push_back(external.value());
+        max_external_ = std::max(max_external_, external.value());
+    }
+    const auto var = static_cast<std::int64_t>(it->second) + 1;
+    return external.is_off() ? literal {-var} : literal {var};
+}
+
+std::optional<literal> variable_map::find_internal(const literal& external) const {
+    const auto it = internal_.find(external.value());
+    if (it == internal_.end()) {
+        return std::nullopt;
+    }
+    const auto var = static_cast<std::int64_t>(it->second) + 1;
+    return external.is_off() ? literal {-var} : literal {var};
+}
+
+literal variable_map::to_external(const literal& internal) const {
+    const auto var = external_[static_cast<std::size_t>(internal.value() - 1)];
+    return internal.is_off() ? literal {-var} : literal {var};
+}
+
 solver::solver(model m)
-    : context_(m)
-    , model_(std::move(m)) {}
+    : model_(to_internal_model(std::move(m), variables_))
+    , context_(model_) {
+    // the clauses are owned by the clause storage of the context from now on, the model only keeps the variables and cardinality constraints
+    model_.clauses     = {};
+    context_.variables_ = &variables_;
+    for (const auto& constraint : model_.xors) {
+        insert_xor(context_, constraint);
+    }
+    recognize_xors();
+    break_symmetries();
+}
+
+solver::solver(solver&& other) noexcept
+    : variables_(std::move(other.variables_))
+    , model_(std::move(other.model_))
+    , context_(std::move(other.context_))
+    , unsat_core_(std::move(other.unsat_core_))
+    , symmetry_broken_(std::exchange(other.symmetry_broken_, false)) {
+    // the context refers to the model and the variables of its solver
+    context_.model_     = model_;
+    context_.variables_ = &variables_;
+}
+
+solver& solver::operator=(solver&& other) noexcept {
+    // the clauses are released before their pool is replaced (the members of the context are assigned in declaration order)
+    context_.clauses_soa_ = Clauses_Soa {};
+
+    variables_          = std::move(other.variables_);
+    model_              = std::move(other.model_);
+    context_            = std::move(other.context_);
+    unsat_core_         = std::move(other.unsat_core_);
+    symmetry_broken_    = std::exchange(other.symmetry_broken_, false);
+    context_.model_     = model_;
+    context_.variables_ = &variables_;
+    return *this;
+}
+
+solver::solver(const snapshot& snap, solver_context::configuration conf)
+    : solver(model_from_snapshot(snap, std::move(conf))) {
+
+    const auto variables = snap.variables();
+    for (std::size_t index = 0; index < variables.size(); ++index) {
+        auto& heuristics           = get<soa_var_heuristics>(context_.vars_soa_[context_.var_ids_[index]]);
+        heuristics.vsids_activity_ = variables[index].vsids_activity;
+        heuristics.saved_phase_    = variables[index].saved_phase == 1 ? assignment::on : assignment::off;
+    }
+
+    for (const auto& constraint : snap.constraints()) {
+        if (constraint.kind != snapshot_constraint_kind::learned_clause) {
+            continue;
+        }
+        std::vector<std::pair<literal, Vars_Soa::struct_id>> literals;
+        literals.reserve(constraint.size);
+        for (const auto lit : snap.literals_of(constraint)) {
+            literals.emplace_back(literal {lit}, context_.var_ids_[static_cast<std::size_t>(std::abs(lit) - 1)]);
+        }
+        insert_learned_clause(context_, literals, constraint.lbd);
+    }
+
+    context_.conflict_count_since_last_restart_ = snap.header().conflict_count_since_last_restart;
+    context_.statistics_                        = from_snapshot_statistics(snap.header().statistics);
+    log_info("solver resumed from snapshot :: {} variables, {} learned clauses", variables.size(), context_.learned_clauses_.size());
+}
+
+std::expected<void, snapshot_error> solver::save_snapshot(const std::filesystem::path& path) const {
+    std::vector<snapshot_variable> variables;
+    variables.reserve(context_.var_ids_.size());
+    for (std::size_t index = 0; index < context_.var_ids_.size(); ++index) {
+        const auto& heuristics = get<soa_var_heuristics>(context_.vars_soa_[context_.var_ids_[index]]);
+        variables.push_back({
+            .external       = variables_.to_external(literal {static_cast<std::int64_t>(index + 1)}).value(),
+            .vsids_activity = heuristics.vsids_activity_,
+            .saved_phase    = static_cast<std::uint8_t>(heuristics.saved_phase_ == assignment::on ? 1 : 0),
+            .padding        = {},
+        });
+    }
+
+    std::vector<snapshot_constraint> constraints;
+    std::vector<std::int64_t> literals;
+    constraints.reserve(context_.clause_ids_.size() + model_.cardinalities.size());
+    auto add_constraint = [&constraints, &literals](auto&& constraint_literals, snapshot_constraint constraint) {
+        constraint.first_literal = literals.size();
+        for (const literal& lit : constraint_literals) {
+            literals.push_back(signed_value(lit));
+        }
+        constraint.size = static_cast<std::uint32_t>(literals.size() - constraint.first_literal);
+        constraints.push_back(constraint);
+    };
+
+    const auto learned_mask = context_.learned_clause_mask();
+    for (std::size_t clause_index = 0; clause_index < context_.clause_ids_.size(); ++clause_index) {
+        if (!learned_mask[clause_index]) {
+            const auto& model_clause = get<soa_clause>(context_.clauses_soa_[context_.clause_ids_[clause_index]]);
+            add_constraint(model_clause.get_literals() | std::views::keys, {.kind = snapshot_constraint_kind::clause});
+        }
+    }
+    for (const auto& card : model_.cardinalities) {
+        add_constraint(card.literals,
+            {
+                .kind         = snapshot_constraint_kind::cardinality,
+                .has_at_least = static_cast<std::uint8_t>(card.at_least.has_value() ? 1 : 0),
+                .at_most      = card.at_most,
+                .at_least     = card.at_least.value_or(0),
+            });
+    }
+    for (const auto& [literals, parity] : model_.xors) {
+        add_constraint(literals, {.kind = snapshot_constraint_kind::xor_constraint, .at_most = parity ? 1U : 0U});
+    }
+    for (const auto& [clause_index, lbd] : context_.learned_clauses_) {
+        const auto& learned = get<soa_clause>(context_.clauses_soa_[context_.clause_ids_[clause_index]]);
+        add_constraint(learned.get_literals() | std::views::keys,
+            {
+                .kind = snapshot_constraint_kind::learned_clause,
+                .lbd  = static_cast<std::uint16_t>(std::min<std::uint32_t>(lbd, std::numeric_limits<std::uint16_t>::max())),
+            });
+    }
+
+    snapshot_header header {
+        .restart_threshold                 = context_.config_.restart_threshold,
+        .conflict_count_since_last_restart = context_.conflict_count_since_last_restart_,
+        .statistics                        = to_snapshot_statistics(context_.statistics_),
+    };
+    return write_snapshot(path, header, variables, constraints, literals);
+}
+
+std::expected<solver::result, sat_error> solver::to_external(std::expected<result, sat_error> res) {
+    unsat_core_ = context_.unsat_core_ | std::views::transform([this](const literal& l) { return variables_.to_external(l); }) | std::ranges::to<std::vector>();
+    if (res.has_value()) {
+        std::ranges::transform(res->literals, res->literals.begin(), [this](const literal& l) { return variables_.to_external(l); });
+    }
+    return res;
+}
+
+std::expected<solver::result, sat_error> solver::solve_next(const solve_limits& limits) { return to_external(impl_details::solve_sat(context_, model_, limits)); }
+
+std::expected<solver::result, sat_error> solver::solve_with_assumptions(std::span<const literal> assumptions, const solve_limits& limits) {
+    context_.assumptions_.clear();
+    context_.assumptions_.reserve(assumptions.size());
+    for (const literal& assumption : assumptions) {
+        const auto internal = variables_.to_internal(assumption);
+        context_.assumptions_.emplace_back(internal, find_or_insert_var(context_, model_, internal));
+    }
+
+    auto res = to_external(impl_details::solve_sat(context_, model_, limits));
+    context_.assumptions_.clear();
+    return res;
+}
+
+std::expected<std::vector<literal>, sat_error> solver::backbone(std::span<const literal> variables, const solve_limits& limits) {
+    context_.assumptions_.clear();
+    auto first = impl_details::solve_sat(context_, model_, limits);
+    if (!first.has_value()) {
+        return std::unexpected(first.error());
+    }
+
+    // internal variables whose backbone literal is searched for (every variable of the model by default)
+    std::vector<bool> selected(context_.var_ids_.size(), variables.empty());
+    for (const auto& var : variables) {
+        if (const auto internal = variables_.find_internal(var); internal.has_value()) {
+            selected[static_cast<std::size_t>(internal->value() - 1)] = true;
+        }
+    }
+    auto is_fixed = [this](const literal& lit) {
+        const auto var_struct = context_.vars_soa_[context_.var_ids_[static_cast<std::size_t>(lit.value() - 1)]];
+        return get<soa_assignment>(var_struct) != assignment::not_assigned && get<soa_assignment_ctx>(var_struct).decision_level_ == 0;
+    };
+    auto is_satisfied = [this](const literal& lit) { // by the assignment of the last resolution
+        const auto value = get<soa_assignment>(context_.vars_soa_[context_.var_ids_[static_cast<std::size_t>(lit.value() - 1)]]);
+        return value == (lit.is_on() ? assignment::on : assignment::off);
+    };
+
+    std::vector<literal> candidates = first->literals | std::views::filter([&selected](const literal& lit) { //
+        return selected[static_cast<std::size_t>(lit.value() - 1)];
+    }) | std::ranges::to<std::vector>();
+    std::vector<literal> backbone;
+    std::size_t resolutions = 1;
+
+    while (!candidates.empty()) {
+        const auto candidate = candidates.back();
+        candidates.pop_back();
+        if (is_fixed(candidate)) {
+            backbone.push_back(candidate); // implied on the decision level 0 : no resolution needed
+            continue;
+        }
+
+        const auto varid = context_.var_ids_[static_cast<std::size_t>(candidate.value() - 1)];
+        context_.assumptions_.assign(1, {candidate.negation(), varid});
+        auto res = impl_details::solve_sat(context_, model_, limits);
+        context_.assumptions_.clear();
+        ++resolutions;
+
+        if (res.has_value()) {
+            // the solution found is a counter-example for every candidate it does not satisfy
+            std::erase_if(candidates, [&is_satisfied](const literal& lit) { return !is_satisfied(lit); });
+            continue;
+        }
+        if (res.error() != sat_error::unsatisfiable) {
+            context_.unsat_core_.clear();
+            unsat_core_.clear();
+            return std::unexpected(res.error());
+        }
+
+        backbone.push_back(candidate);
+        // the backbone literal is implied by the model : it is kept as a learned unit clause, decided on the decision level 0 from now on (not
+        // while a proof is written, the unit clause being derived under assumption it is not a lemma of the proof)
+        if (context_.proof_ == nullptr) {
+            impl_details::backtrack(context_, 0);
+            const std::array unit {std::pair {candidate, varid}};
+            insert_learned_clause(context_, unit, 1);
+        }
+    }
+    context_.unsat_core_.clear();
+    unsat_core_.clear();
+
+    log_debug("backbone :: {} literals found with {} resolutions", backbone.size(), resolutions);
+    std::ranges::transform(backbone, backbone.begin(), [this](const literal& l) { return variables_.to_external(l); });
+    std::ranges::sort(backbone);
+    return backbone;
+}
+
+std::expected<std::vector<core_clause>, sat_error> solver::minimal_unsat_core(const solve_limits& limits) {
+    // candidates of the core : the clauses of the model, each one relaxed by a selector variable (clause or not selector) numbered after the
+    // variables of the model, the relaxed model is solved on the internal variables
+    const auto learned_mask = context_.learned_clause_mask();
+    std::vector<std::uint32_t> candidates; // index in clause_ids_ of each candidate
+    for (std::uint32_t clause_index = 0; clause_index < context_.clause_ids_.size(); ++clause_index) {
+        if (!learned_mask[clause_index]) {
+            candidates.push_back(clause_index);
+        }
+    }
+
+    const auto selector_base = static_cast<std::int64_t>(context_.var_ids_.size());
+    auto selector            = [selector_base](std::size_t candidate) { return literal {selector_base + static_cast<std::int64_t>(candidate) + 1}; };
+
+    model relaxed {.literals = model_.literals, .clauses = {}, .cardinalities = model_.cardinalities, .xors = model_.xors, .conf = context_.config_};
+    relaxed.conf.symmetry_breaking = false; // the predicates already added are clauses of the model
+    relaxed.conf.xor_recognition   = false;
+    relaxed.clauses.reserve(candidates.size());
+    for (std::size_t candidate = 0; candidate < candidates.size(); ++candidate) {
+        relaxed.literals.push_back(selector(candidate));
+        auto relaxed_clause = get<soa_clause>(context_.clauses_soa_[context_.clause_ids_[candidates[candidate]]]).get_literals() | std::views::keys
+                            | std::ranges::to<std::vector>();
+        relaxed_clause.push_back(selector(candidate).negation());
+        relaxed.clauses.push_back(std::move(relaxed_clause));
+    }
+    solver relaxed_solver {std::move(relaxed)};
+
+    std::vector<std::size_t> core = std::views::iota(std::size_t {0}, candidates.size()) | std::ranges::to<std::vector>();
+    std::vector<bool> necessary(candidates.size(), false);
+    std::vector<literal> assumptions;
+    std::size_t resolutions = 0;
+
+    // resolution of the core without the excluded candidate : if unsatisfiable, the core is refined to the candidates of the unsat core found
+    // (the necessary candidates are hard clauses, they are not assumed)
+    auto refine = [&](std::optional<std::size_t> excluded) -> std::expected<bool, sat_error> {
+        assumptions.clear();
+        for (const auto candidate : core) {
+            if (candidate != excluded && !necessary[candidate]) {
+                assumptions.push_back(selector(candidate));
+            }
+        }
+        ++resolutions;
+        const auto res = relaxed_solver.solve_with_assumptions(assumptions, limits);
+        if (res.has_value()) {
+            return false;
+        }
+        if (res.error() != sat_error::unsatisfiable) {
+            return std::unexpected(res.error());
+        }
+        std::vector<bool> in_unsat_core(candidates.size(), false);
+        for (const auto& lit : relaxed_solver.unsat_core()) {
+            in_unsat_core[static_cast<std::size_t>(lit.value() - selector_base - 1)] = true;
+        }
+        std::erase_if(core, [&](std::size_t candidate) { return !necessary[candidate] && !in_unsat_core[candidate]; });
+        return true;
+    };
+
+    const auto unsatisfiable = refine(std::nullopt);
+    if (!unsatisfiable.has_value()) {
+        return std::unexpected(unsatisfiable.error());
+    }
+    if (!unsatisfiable.value()) {
+        log_info("mus :: the model is satisfiable, no unsatisfiable core");
+        return std::vector<core_clause> {};
+    }
+
+    // deletion-based minimization : the candidates before the position are necessary
+    for (std::size_t position = 0; position < core.size();) {
+        const auto candidate = core[position];
+        const auto refined   = refine(candidate);
+        if (!refined.has_value()) {
+            return std::unexpected(refined.error());
+        }
+        if (!refined.value()) {
+            necessary[candidate] = true; // the core is satisfiable without the candidate
+            relaxed_solver.add_clause({selector(candidate)});
+            ++position;
+        }
+    }
+    unsat_core_.clear();
+
+    log_info("mus :: {} clauses in the minimal unsatisfiable core (out of {}) found with {} resolutions", core.size(), candidates.size(), resolutions);
+    return core | std::views::transform([&](std::size_t candidate) {
+        const auto clause_struct = context_.clauses_soa_[context_.clause_ids_[candidates[candidate]]];
+        return core_clause {
+            .literals = get<soa_clause>(clause_struct).get_literals() | std::views::keys
+                      | std::views::transform([this](const literal& l) { return variables_.to_external(l); }) | std::ranges::to<std::vector>(),
+            .origin   = get<soa_clause_compiler_ctx>(clause_struct).fabl_context(),
+        };
+    }) | std::ranges::to<std::vector>();
+}
+
+std::expected<void, proof_error> solver::start_proof(const std::filesystem::path& path, proof_format format) {
+    if (!context_.cardinality_ids_.empty()) {
+        log_warn("proof :: the model has cardinality constraints, the proof cannot be checked against the clauses of the model only");
+    }
+    if (!context_.xors_.empty()) {
+        log_warn("proof :: the model has XOR constraints, the clauses learned from their Gauss-Jordan elimination cannot be checked by unit propagation");
+    }
+    if (context_.config_.symmetry_breaking) {
+        log_warn("proof :: symmetry breaking predicates have been added to the model, the proof cannot be checked against the clauses of the model only");
+    }
+    auto writer = proof_writer::open(path, format);
+    if (!writer.has_value()) {
+        return std::unexpected(writer.error());
+    }
+    if (context_.proof_ != nullptr) {
+        [[maybe_unused]] const auto _ = context_.proof_->close();
+    }
+    context_.proof_ = std::move(writer.value());
+    return {};
+}
+
+std::expected<void, proof_error> solver::close_proof() {
+    if (context_.proof_ == nullptr) {
+        return {};
+    }
+    auto closed = context_.proof_->close();
+    context_.proof_.reset();
+    return closed;
+}
+
+void solver::add_clause(std::vector<literal> clause_literals) {
+    impl_details::backtrack(context_, 0);
+    ingest_clause(clause_literals);
+}
+
+void solver::recognize_xors() {
+    if (!context_.config_.xor_recognition) {
+        return;
+    }
+    std::vector<std::vector<literal>> clauses;
+    clauses.reserve(context_.clause_ids_.size());
+    for (const auto& id : context_.clause_ids_) {
+        const auto& clause_lits = get<soa_clause>(context_.clauses_soa_[id]).get_literals();
+        if (clause_lits.size() <= context_.config_.xor_max_size) {
+            clauses.push_back(clause_lits | std::views::keys | std::ranges::to<std::vector>());
+        }
+    }
+    const auto xors = find_xor_constraints(clauses, context_.config_.xor_max_size);
+    for (const auto& constraint : xors) {
+        insert_xor(context_, constraint);
+    }
+    log_info("xor :: {} XOR constraints recognized from the clauses", xors.size());
+}
+
+void solver::add_xor(xor_constraint constraint) {
+    impl_details::backtrack(context_, 0);
+
+    std::ranges::transform(constraint.literals, constraint.literals.begin(), [this](const literal& l) { return variables_.to_internal(l); });
+    for (const auto& lit : constraint.literals) {
+        [[maybe_unused]] const auto _ = find_or_insert_var(context_, model_, lit);
+    }
+    insert_xor(context_, constraint);
+    model_.xors.push_back(std::move(constraint));
+}
+
+void solver::break_symmetries() {
+    const auto& conf = context_.config_;
+    if (!conf.symmetry_breaking) {
+        return;
+    }
+    if (model_.literals.size() > conf.symmetry_max_variables) {
+        log_info("symmetry :: detection skipped, {} variables (maximum {})", model_.literals.size(), conf.symmetry_max_variables);
+        return;
+    }
+
+    // the clauses of the model are held by the clause storage of the context
+    model internal {.literals = model_.literals, .clauses = {}, .cardinalities = model_.cardinalities, .xors = model_.xors};
+    internal.clauses.reserve(context_.clause_ids_.size());
+    for (const auto& id : context_.clause_ids_) {
+        internal.clauses.push_back(get<soa_clause>(context_.clauses_soa_[id]).get_literals() | std::views::keys | std::ranges::to<std::vector>());
+    }
+
+    const auto symmetries = find_symmetries(internal, conf.symmetry_max_generators);
+    model predicates {};
+    const auto added = add_symmetry_breaking(predicates, symmetries, conf.symmetry_max_predicate_length, [this] {
+        const auto aux                = variables_.add_auxiliary();
+        [[maybe_unused]] const auto _ = find_or_insert_var(context_, model_, aux);
+        return aux;
+    });
+    for (const auto& clause : predicates.clauses) {
+        ingest_clause(clause | std::views::transform([this](const literal& l) { return variables_.to_external(l); }) | std::ranges::to<std::vector>());
+    }
+    symmetry_broken_ = symmetry_broken_ || added > 0;
+    log_info("symmetry :: {} symmetries found, {} symmetry breaking clauses added", symmetries.size(), added);
+}
+
+void solver::ingest_clause(std::span<const literal> clause_literals) {
+    fabko_assert(!clause_literals.empty(), "cannot add an empty clause to the solver");
+
+    sat::clause_literals literals {context_.clause_allocator()};
+    literals.reserve(clause_literals.size());
+    for (const literal& lit : clause_literals) {
+        const auto internal = variables_.to_internal(lit);
+        literals.emplace_back(internal, find_or_insert_var(context_, model_, internal));
+    }
+
+    auto clause_metadata = constraint_metadata(model_, literals | std::views::keys);
+
+    // the literals are moved into the clause storage : a single allocation (from the clause pool) per clause
+    clause clause_to_insert {std::move(literals)};
+    clause_watcher watcher {context_.vars_soa_, clause_to_insert};
+    context_.clause_ids_.push_back(context_.clauses_soa_.insert(std::move(clause_to_insert), std::move(watcher), std::move(clause_metadata)));
+}
+
+void solver::reserve(std::size_t variables, std::size_t clauses) {
+    variables_.reserve(variables);
+    model_.literals.reserve(variables);
+    context_.vars_soa_.reserve(variables);
+    context_.var_ids_.reserve(variables);
+    context_.clauses_soa_.reserve(clauses);
+    context_.clause_ids_.reserve(clauses);
+}
+
+void solver::add_cardinality(cardinality_constraint constraint) {
+    impl_details::backtrack(context_, 0);
+
+    std::ranges::transform(constraint.literals, constraint.literals.begin(), [this](const literal& l) { return variables_.to_internal(l); });
+    for (auto& card : make_cardinalities(constraint, [this](const literal& l) { return find_or_insert_var(context_, model_, l); })) {
+        context_.cardinality_ids_.push_back(context_.cardinalities_soa_.insert(std::move(card), metadata {}));
+    }
+    model_.cardinalities.push_back(std::move(constraint));
+}
+
+std::vector<lbd_clause> solver::learned_clauses(std::uint32_t max_lbd, std::size_t last) const {
+    std::vector<lbd_clause> res;
+    if (symmetry_broken_) {
+        return res;
+    }
+    const auto learned_count = context_.learned_clauses_.size();
+    for (const auto& [clause_index, lbd] : context_.learned_clauses_ | std::views::drop(learned_count - std::min(last, learned_count))) {
+        if (lbd > max_lbd) {
+            continue;
+        }
+        const auto& learned = get<soa_clause>(context_.clauses_soa_[context_.clause_ids_[clause_index]]);
+        res.push_back({
+            .literals = learned.get_literals() | std::views::keys | std::views::transform([this](const literal& l) { return variables_.to_external(l); })
+                      | std::ranges::to<std::vector>(),
+            .lbd = lbd,
+        });
+    }
+    return res;
+}
+
+std::vector<literal> solver::saved_phases() const {
+    std::vector<literal> res;
+    res.reserve(context_.var_ids_.size());
+    for (std::size_t index = 0; index < context_.var_ids_.size(); ++index) {
+        const literal internal {static_cast<std::int64_t>(index + 1)};
+        if (variables_.is_auxiliary(internal)) {
+            continue;
+        }
+        const auto var = variables_.to_external(internal);
+        res.push_back(get<soa_var_heuristics>(context_.vars_soa_[context_.var_ids_[index]]).saved_phase_ == assignment::on ? var : var.negation());
+    }
+    return res;
+}
+
+std::size_t solver::seed(std::span<const lbd_clause> learned, std::span<const literal> phases) {
+    impl_details::backtrack(context_, 0);
+
+    std::size_t seeded = 0;
+    for (const auto& [literals, lbd] : learned) {
+        std::vector<std::pair<literal, Vars_Soa::struct_id>> internal;
+        internal.reserve(literals.size());
+        for (const auto& lit : literals) {
+            const auto internal_lit = variables_.find_internal(lit);
+            if (!internal_lit.has_value()) {
+                break; // the clause refers to a variable unknown to this model : it cannot be used
+            }
+            internal.emplace_back(internal_lit.value(), context_.var_ids_[static_cast<std::size_t>(internal_lit->value() - 1)]);
+        }
+        if (internal.empty() || internal.size() != literals.size()) {
+            continue;
+        }
+        insert_learned_clause(context_, internal, lbd);
+        ++seeded;
+    }
+
+    for (const auto& phase : phases) {
+        if (const auto internal_lit = variables_.find_internal(phase); internal_lit.has_value()) {
+            get<soa_var_heuristics>(context_.vars_soa_[context_.var_ids_[static_cast<std::size_t>(internal_lit->value() - 1)]]).saved_phase_ =
+                internal_lit->is_on() ? assignment::on : assignment::off;
+        }
+    }
+    log_debug("solver seeded with {} learned clauses and {} phases", seeded, phases.size());
+    return seeded;
+}
 
-std::vector<solver::result> solver::solve(std::int32_t expected) {
+std::vector<solver::result> solver::solve(std::int32_t expected, const solve_limits& limits) {
     std::vector<result> res;
 
     for (auto i = 0; i < expected; ++i) {
-        auto r = impl_details::solve_sat(context_, model_);
+        auto r = solve_next(limits);
 
         if (!r.has_value()) {
             auto error = r.error();
             if (error == sat_error::unsatisfiable) {
                 if (i == 0)
                     log_info("SAT solver cannot find solution for mode : UNSATISFIABLE");
+            } else if (error == sat_error::unknown) {
+                log_info("SAT solver stopped before finding a solution : UNKNOWN");
             } else {
                 log_error("SAT solver : an error occurred");
             }
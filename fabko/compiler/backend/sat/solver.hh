@@ -13,15 +13,24 @@
 #ifndef SOLVER_HH
 #define SOLVER_HH
 
+#include <chrono>
+#include <expected>
 #include <filesystem>
+#include <limits>
 #include <map>
 #include <memory>
+#include <memory_resource>
+#include <optional>
 #include <ranges>
+#include <span>
+#include <stop_token>
+#include <unordered_map>
 #include <vector>
 
 #include <fil/algorithm/string.hh>
 
 #include "common/exception.hh"
+#include "snapshot.hh"
 #include "solver_context.hh"
 
 namespace fabko::compiler::sat {
@@ -49,32 +58,39 @@ class literal {
      */
     [[nodiscard]] constexpr std::int64_t value() const { return std::abs(value_); }
 
+    /**
+     * @return literal of the same variable with the opposite polarity
+     */
+    [[nodiscard]] constexpr literal negation() const { return literal {-value_}; }
+
     [[nodiscard]] friend constexpr std::string to_string(const literal& lit) { return std::to_string(lit.value_); }
 
   private:
     std::int64_t value_;
 };
 
+//! literals of a clause paired with the variable id they refer to in the soa_struct, allocated from the clause pool of the solver
+using clause_literals = std::pmr::vector<std::pair<literal, Vars_Soa::struct_id>>;
+
 class clause {
     friend class clause_view;
 
   public:
-    clause(std::vector<literal> clause, std::vector<Vars_Soa::struct_id> literals_mapping)
+    clause(std::vector<literal> clause, std::vector<Vars_Soa::struct_id> literals_mapping, std::pmr::polymorphic_allocator<> allocator = {})
         : vars_([&]() {
-            return std::views::zip_transform(
-                       [](auto lit_clause, auto lit_mapping) { //
-                           return std::make_pair(lit_clause, lit_mapping);
-                       },
-                       clause,
-                       literals_mapping)
-                 | std::ranges::to<std::vector<std::pair<literal, Vars_Soa::struct_id>>>();
+            clause_literals vars {allocator};
+            vars.reserve(clause.size());
+            for (auto&& [lit_clause, lit_mapping] : std::views::zip(clause, literals_mapping)) {
+                vars.emplace_back(lit_clause, lit_mapping);
+            }
+            return vars;
         }()) {}
 
-    explicit clause(std::vector<std::pair<literal, Vars_Soa::struct_id>>&& lit_vars_mapping)
+    explicit clause(clause_literals&& lit_vars_mapping)
         : vars_(std::move(lit_vars_mapping)) {}
 
     [[nodiscard]] bool is_empty() const { return vars_.empty(); }
-    [[nodiscard]] const std::vector<std::pair<literal, Vars_Soa::struct_id>>& get_literals() const { return vars_; }
+    [[nodiscard]] const clause_literals& get_literals() const { return vars_; }
     [[nodiscard]] friend std::string to_string(const clause& clause) {
         return std::ranges::fold_left(clause.vars_, std::string {"clause["}, [](std::string res, const auto& lit_it) { //
             return std::format("{}{},", res, to_string(lit_it.first));
@@ -83,7 +99,34 @@ class clause {
 
   private:
     std::int64_t id_ {0};
-    std::vector<std::pair<literal, Vars_Soa::struct_id>> vars_; //!< pair of a clause literal and the variable id it refers to in the soa_struct
+    clause_literals vars_; //!< pair of a clause literal and the variable id it refers to in the soa_struct
+};
+
+/**
+ * @brief Native cardinality constraint : at most 'bound' literals of the constraint can be true
+ *
+ * The constraint is propagated by counting the true literals instead of being encoded into clauses (an at-most-one over n literals would
+ * require n.(n-1)/2 binary clauses). When a propagation or a conflict has to be explained to the conflict analysis, the clause implied by the
+ * constraint is produced on demand.
+ */
+class cardinality {
+  public:
+    cardinality(std::vector<literal> literals, std::vector<Vars_Soa::struct_id> literals_mapping, std::size_t bound)
+        : vars_(std::views::zip_transform([](auto lit, auto lit_mapping) { return std::make_pair(lit, lit_mapping); }, literals, literals_mapping)
+                | std::ranges::to<std::vector<std::pair<literal, Vars_Soa::struct_id>>>())
+        , bound_(bound) {}
+
+    [[nodiscard]] const std::vector<std::pair<literal, Vars_Soa::struct_id>>& get_literals() const { return vars_; }
+    [[nodiscard]] std::size_t bound() const { return bound_; }
+    [[nodiscard]] friend std::string to_string(const cardinality& card) {
+        return std::ranges::fold_left(card.vars_, std::string {"at_most_"} + std::to_string(card.bound_) + "[", [](std::string res, const auto& lit_it) { //
+            return std::format("{}{},", res, to_string(lit_it.first));
+        }) + "]";
+    }
+
+  private:
+    std::vector<std::pair<literal, Vars_Soa::struct_id>> vars_; //!< pair of a constraint literal and the variable id it refers to in the soa_struct
+    std::size_t bound_;                                         //!< maximum number of literals of the constraint that can be true
 };
 
 /**
@@ -95,9 +138,14 @@ class clause {
  *
  * The watchers are initially set to the first and last literals in the clause. Only when both
  * watched literals become false does the solver need to examine the entire clause.
+ *
+ * The watcher also records a blocker : a literal of the clause found satisfied on the last visit of the propagation. As long as the blocker is
+ * satisfied the clause is skipped by reading the watcher column only, without dereferencing the literals of the clause.
  */
 class clause_watcher {
   public:
+    using watched_literal = std::pair<literal, Vars_Soa::struct_id>;
+
     /**
      * @brief Constructs a clause watcher for the given clause
      * @param vs The variable structure-of-arrays containing all variables
@@ -118,32 +166,35 @@ class clause_watcher {
      * @brief number of watched literal in the clause watcher
      * @return 0, 1, or 2 depending on the number of watched literals (cannot be more than 2)
      */
-    [[nodiscard]] std::uint8_t size() const;
+    [[nodiscard]] std::uint8_t size() const { return size_; }
 
     /**
-     * @return variable ids that are currently under watch
+     * @return variable ids that are currently under watch (view on the watcher, invalidated by replace)
      */
-    [[nodiscard]] std::vector<Vars_Soa::struct_id> get_watched() const {
-        std::vector<Vars_Soa::struct_id> res;
-        if (watchers_[0].has_value()) {
-            res.push_back(watchers_[0].value());
-        }
-        if (watchers_[1].has_value()) {
-            res.push_back(watchers_[1].value());
-        }
-        return res;
-    }
+    [[nodiscard]] std::span<const Vars_Soa::struct_id> get_watched() const { return {watched_.data(), size_}; }
+
+    /**
+     * @return literal of the clause satisfied on the last visit (the first literal of the clause if none has been found yet)
+     */
+    [[nodiscard]] const watched_literal& blocker() const { return blocker_; }
+    void set_blocker(const watched_literal& blocker) { blocker_ = blocker; }
 
   private:
-    std::array<std::optional<Vars_Soa::struct_id>, 2> watchers_; //!< The watched literals (1 for unit clauses, 2 for other clauses)
+    std::array<Vars_Soa::struct_id, 2> watched_; //!< The watched literals, only the first size_ ones are set
+    watched_literal blocker_;                    //!< literal of the clause satisfied on the last visit of the clause
+    std::uint8_t size_ {0};                      //!< number of watched literals (1 for unit clauses, 2 for other clauses)
 };
 
 /**
  * @brief Represents the context in which an assignment occurs on a literal
  *
- * This class maintains the state of an assigned literal in the SAT solver, including its decision level, VSIDS activity score, and the reason for its assignment
- * (Whether it was a decision or propagated through a clause.)
+ * This class maintains the state of an assigned literal in the SAT solver that is read by the propagation and the conflict analysis (hot state)
+ * : its decision level, its position in the trail and the reason for its assignment (Whether it was a decision or propagated through a clause,
+ * a cardinality constraint or the XOR constraints.)
  *
+ * The reason is stored as a 32-bit index in the constraint tables of the solver context (solver_context::clause_ids_ and
+ * solver_context::cardinality_ids_, or the variable index for the XOR engine which records the explanation of its implications), the two
+ * highest bits tell which table is indexed and 'no_reason' marks a decision. This keeps the hot state of a variable in 12 bytes, the heuristic state (see variable_heuristics) and the compiler metadata being stored in separated columns.
  */
 class assignment_context {
   public:
@@ -152,18 +203,56 @@ class assignment_context {
         propagated,
     };
 
+    static constexpr std::uint32_t no_reason        = std::numeric_limits<std::uint32_t>::max(); //!< reason of a decision
+    static constexpr std::uint32_t cardinality_flag = 1U << 31;                                   //!< set if the reason is a cardinality constraint
+    static constexpr std::uint32_t xor_flag         = 1U << 30;                                   //!< set if the reason is the XOR engine
+    static constexpr std::uint32_t index_mask       = ~(cardinality_flag | xor_flag);             //!< bits of the index of the reason
+
     /**
-     * @return true if the assignment is propagation from a clause, false if it is a decision from the SAT solver
+     * @return true if the assignment is propagation from a clause or a cardinality constraint, false if it is a decision from the SAT solver
      */
-    [[nodiscard]] bool is_propagated() const { return clause_propagation_.has_value(); }
+    [[nodiscard]] bool is_propagated() const { return reason_ != no_reason; }
     /**
      * @return true if the assignment is a decision made by the SAT solver, false if it is propagation from a clause.
      */
     [[nodiscard]] bool is_decision() const { return !is_propagated(); }
 
-    std::int64_t vsids_activity_ {};                              //!< VSIDS (Variable State Independent Decaying Sum) activity value type
-    std::size_t decision_level_ {};                               //!< decision level of the literal
-    std::optional<Clauses_Soa::struct_id> clause_propagation_ {}; //!< clause that produced this (std::nullopt if decision type)
+    [[nodiscard]] bool has_clause_reason() const { return is_propagated() && (reason_ & ~index_mask) == 0; }
+    [[nodiscard]] bool has_cardinality_reason() const { return is_propagated() && (reason_ & cardinality_flag) != 0; }
+    [[nodiscard]] bool has_xor_reason() const { return is_propagated() && (reason_ & ~index_mask) == xor_flag; }
+
+    /**
+     * @return index (in solver_context::clause_ids_) of the clause that produced this assignment, valid only if has_clause_reason()
+     */
+    [[nodiscard]] std::uint32_t clause_reason() const { return reason_; }
+    /**
+     * @return index (in solver_context::cardinality_ids_) of the cardinality constraint that produced this assignment, valid only if
+     * has_cardinality_reason()
+     */
+    [[nodiscard]] std::uint32_t cardinality_reason() const { return reason_ & index_mask; }
+    /**
+     * @return index of the variable whose implication by the XOR engine produced this assignment (see xor_engine::reason), valid only if
+     * has_xor_reason()
+     */
+    [[nodiscard]] std::uint32_t xor_reason() const { return reason_ & index_mask; }
+
+    void set_clause_reason(std::uint32_t clause_index) { reason_ = clause_index; }
+    void set_cardinality_reason(std::uint32_t cardinality_index) { reason_ = cardinality_index | cardinality_flag; }
+    void set_xor_reason(std::uint32_t variable_index) { reason_ = variable_index | xor_flag; }
+    void clear_reason() { reason_ = no_reason; }
+
+    std::uint32_t decision_level_ {};  //!< decision level of the literal
+    std::uint32_t trail_position_ {};  //!< position of the assignment in the trail
+    std::uint32_t reason_ {no_reason}; //!< encoded constraint that produced this (no_reason if decision type)
+};
+static_assert(sizeof(assignment_context) == 12, "hot state of a variable is expected to stay compact");
+
+/**
+ * @brief Heuristic state of a variable, only read when taking a decision, bumping activities or saving phases (cold state)
+ */
+struct variable_heuristics {
+    std::int64_t vsids_activity_ {};          //!< VSIDS (Variable State Independent Decaying Sum) activity value type
+    assignment saved_phase_ {assignment::on}; //!< phase re-used when the variable is decided (phase saving)
 };
 
 struct conflict_resolution_result {
@@ -171,9 +260,29 @@ struct conflict_resolution_result {
     std::size_t backtrack_level {}; //!< level the conflict resolution found to requires the solver to backtrack to
 };
 
+/**
+ * @brief cardinality constraint of a model : the number of true literals is bounded (exactly-k is expressed with both bounds set to k)
+ */
+struct cardinality_constraint {
+    std::vector<literal> literals;          //!< literals of the constraint
+    std::size_t at_most {1};                //!< maximum number of literals that can be true
+    std::optional<std::size_t> at_least {}; //!< minimum number of literals that have to be true (no lower bound if not set)
+};
+
+/**
+ * @brief XOR (parity) constraint of a model : the number of true literals is odd if the parity is set, even otherwise
+ * @note a negated literal flips the parity of the constraint
+ */
+struct xor_constraint {
+    std::vector<literal> literals; //!< literals of the constraint
+    bool parity {true};            //!< XOR of the literals
+};
+
 struct model {
     std::vector<literal> literals;                                           //!< literals to be computed by the sat solver
     std::vector<std::vector<literal>> clauses;                               //!< cnf clauses to be solved
+    std::vector<cardinality_constraint> cardinalities {};                    //!< cardinality constraints, propagated natively by the solver
+    std::vector<xor_constraint> xors {};                                     //!< XOR constraints, propagated natively by Gauss-Jordan elimination
     std::map<literal, fabl::compiler_generation_context> literal_context {}; //!< contextualization of the literal of the compiler
     solver_context::configuration conf {};                                   //!< configuration of the SAT solver
 };
@@ -191,17 +300,125 @@ model make_model_from_cnf_file(const std::filesystem::path& cnf_file);
 
 enum class sat_error {
     unsatisfiable, //!< The SAT problem is unsatisfiable.
+    unknown,       //!< The solving process has been stopped before an answer was found (cancellation, deadline or budget exhausted).
     error          //!< An error occurred during the solving process.
 };
 
+/**
+ * @brief Limits applied on a call to the solver
+ *
+ * The limits are checked cooperatively inside the solving loop, when one of them is reached the resolution is abandoned and
+ * sat_error::unknown is returned. Budgets are relative to the call they are provided to (and not to the overall solver statistics).
+ */
+struct solve_limits {
+    std::stop_token stop_token {};                                    //!< cooperative cancellation of the resolution
+    std::optional<std::chrono::steady_clock::time_point> deadline {}; //!< point in time after which the resolution is abandoned
+    std::optional<std::size_t> conflict_budget {};                    //!< maximum number of conflicts allowed in the call
+    std::optional<std::size_t> propagation_budget {};                 //!< maximum number of propagations allowed in the call
+
+    /**
+     * @brief make limits out of a time limit
+     * @param time_limit duration after which the resolution is abandoned, starting from now
+     * @param token cooperative cancellation token
+     */
+    [[nodiscard]] static solve_limits with_time_limit(std::chrono::steady_clock::duration time_limit, std::stop_token token = {}) {
+        return solve_limits {
+            .stop_token = std::move(token),
+            .deadline   = std::chrono::steady_clock::now() + time_limit,
+        };
+    }
+};
+
+/**
+ * @brief learned clause exported from (or seeded into) a solver, with the LBD (Literal Block Distance) it had when it was learned
+ */
+struct lbd_clause {
+    std::vector<literal> literals;
+    std::uint32_t lbd {};
+};
+
+/**
+ * @brief clause of an unsatisfiable core, with the FABL construct it has been generated for
+ */
+struct core_clause {
+    std::vector<literal> literals;                              //!< literals of the clause, expressed with the variables of the model
+    std::optional<fabl::compiler_generation_context> origin {}; //!< FABL construct of the clause (none if not generated by the fabl compiler)
+};
+
+/**
+ * @brief Dense renumbering of the variables between the user-facing identifiers and the solver internal ones
+ *
+ * Variables of a model can be numbered in any way upstream (sparse DIMACS files, identifiers allocated by the FABL compiler). The solver works on
+ * internal variables numbered densely from 1 (in order of first appearance) so that every per-variable array stays tight. The map stores the
+ * internal index of a variable on 32 bits.
+ */
+class variable_map {
+  public:
+    /**
+     * @return internal literal of an external literal (same polarity), a new internal variable is allocated if the variable is unknown
+     */
+    literal to_internal(const literal& external);
+
+    /**
+     * @return internal literal of an external literal (same polarity), std::nullopt if the variable is unknown
+     */
+    [[nodiscard]] std::optional<literal> find_internal(const literal& external) const;
+
+    /**
+     * @return external literal of an internal literal (same polarity)
+     */
+    [[nodiscard]] literal to_external(const literal& internal) const;
+
+    /**
+     * @brief allocate a variable that is not part of the model (auxiliary variable added by the solver), it is numbered after the greatest
+     * external variable mapped
+     * @return internal literal of the new variable
+     */
+    literal add_auxiliary() {
+        const auto aux = to_internal(literal {max_external_ + 1});
+        auxiliary_.resize(external_.size(), false);
+        auxiliary_[aux.value() - 1] = true;
+        return aux;
+    }
+
+    /**
+     * @return true if the internal literal is on an auxiliary variable (see add_auxiliary)
+     */
+    [[nodiscard]] bool is_auxiliary(const literal& internal) const {
+        const auto index = static_cast<std::size_t>(internal.value() - 1);
+        return index < auxiliary_.size() && auxiliary_[index];
+    }
+
+    /**
+     * @return number of variables mapped
+     */
+    [[nodiscard]] std::size_t size() const { return external_.size(); }
+
+    void reserve(std::size_t variables) {
+        internal_.reserve(variables);
+        external_.reserve(variables);
+    }
+
+  private:
+    std::unordered_map<std::int64_t, std::uint32_t> internal_; //!< internal index (internal variable - 1) of each external variable
+    std::vector<std::int64_t> external_;                       //!< external variable of each internal index
+    std::int64_t max_external_ {0};                            //!< greatest external variable mapped
+    std::vector<bool> auxiliary_;                              //!< true for the internal index of the auxiliary variables
+};
+
 /**
  * @brief The solver class for solving SAT models.
  *
  * This class provides functionality to solve a satisfiability problem given a model. It uses
  * an internal solver_context to handle the solving process and produces results as a list of
  * literal assignments.
+ *
+ * The variables of the model are renumbered densely for the resolution (see variable_map), this is transparent for the user : results,
+ * assumptions, unsat cores and added clauses are expressed with the variables of the model provided.
  */
 class solver {
+    friend class solver_builder;
+
   public:
     struct result {
         std::vector<literal> literals;
@@ -215,13 +432,292 @@ class solver {
 
     explicit solver(model m);
 
-    std::vector<result> solve(std::int32_t expected = -1);
+    solver(solver&& other) noexcept;
+    solver& operator=(solver&& other) noexcept;
+    solver(const solver&)            = delete;
+    solver& operator=(const solver&) = delete;
+
+    /**
+     * @brief resume a solver from a snapshot written by save_snapshot
+     *
+     * The model (including the clauses and cardinality constraints added incrementally), the learned clauses, the saved phases, the VSIDS
+     * activities and the statistics are restored : the resolution continues where the snapshotted solver stopped instead of starting cold.
+     *
+     * @param snap snapshot to resume from
+     * @param conf configuration of the resumed solver (the configuration is not part of the snapshot, except for the restart threshold reached)
+     */
+    explicit solver(const snapshot& snap, solver_context::configuration conf = {});
+
+    /**
+     * @brief write the state of the solver into a binary snapshot, it can be resumed later on (as after a preemption) by another solver
+     * @note the snapshot is taken between two resolutions : the assignments of the current search are not part of it
+     * @param path file to write the snapshot into (replaced if it exists)
+     * @return snapshot_error::io_error if the file cannot be written
+     */
+    [[nodiscard]] std::expected<void, snapshot_error> save_snapshot(const std::filesystem::path& path) const;
+
+    /**
+     * @brief search for the next solution of the model
+     * @param limits cancellation, deadline and budgets applied on the resolution
+     * @return a solution if found, sat_error::unsatisfiable if there is none, or sat_error::unknown if the limits stopped the resolution
+     */
+    std::expected<result, sat_error> solve_next(const solve_limits& limits = {});
+
+    /**
+     * @brief search for solutions of the model
+     * @param expected number of solutions to search for
+     * @param limits cancellation, deadline and budgets applied on each resolution
+     * @return solutions found, could be less than expected if the problem does not have more solutions or if the limits have been reached
+     */
+    std::vector<result> solve(std::int32_t expected = -1, const solve_limits& limits = {});
+
+    /**
+     * @brief search for a solution of the model in which all the assumption literals are satisfied
+     *
+     * Assumptions only apply to this call, learned clauses are kept in between calls which makes it possible to use the solver incrementally.
+     *
+     * @param assumptions literals assumed to be true for this resolution
+     * @param limits cancellation, deadline and budgets applied on the resolution
+     * @return a solution if found, sat_error::unsatisfiable if there is no solution satisfying the assumptions (see unsat_core()), or
+     * sat_error::unknown if the limits stopped the resolution
+     */
+    std::expected<result, sat_error> solve_with_assumptions(std::span<const literal> assumptions, const solve_limits& limits = {});
+
+    /**
+     * @brief extract a minimal unsatisfiable subset (MUS) of the clauses of the model : removing any of its clauses makes it satisfiable
+     *
+     * The clauses are relaxed by selector variables in a dedicated solver : a first resolution assuming every selector gives an initial core
+     * (the assumptions responsible for the unsatisfiability). The core is then minimized by deletion : each clause is removed in turn, if the
+     * remaining clauses are still unsatisfiable the core is refined to the new (smaller) core found, otherwise the clause is necessary and kept
+     * as a hard clause. The clauses learned by the dedicated solver are kept from a resolution to the other.
+     *
+     * Each clause of the core is given with the FABL construct it has been generated for (see model::literal_context) : an infeasible request
+     * points at the capabilities and preconditions that clash.
+     *
+     * @note the cardinality and XOR constraints are not part of the core : they are kept in every resolution (as hard constraints)
+     * @note the clauses learned by this solver are not used : they could be implied by clauses out of the core
+     * @param limits cancellation, deadline and budgets applied on each resolution
+     * @return clauses of the core (empty if the model is satisfiable, or unsatisfiable by its cardinality and XOR constraints alone), or
+     * sat_error::unknown if the limits stopped a resolution
+     */
+    std::expected<std::vector<core_clause>, sat_error> minimal_unsat_core(const solve_limits& limits = {});
+
+    /**
+     * @brief compute the backbone of the model : the literals that are satisfied by every solution
+     *
+     * The backbone is computed without enumerating the solutions. A first solution gives the candidates (its literals), then each candidate
+     * is checked by a resolution assuming its negation : if unsatisfiable the literal is part of the backbone (it is kept as a learned unit
+     * clause for the next resolutions), otherwise the solution found filters out every candidate it does not satisfy. The literals assigned
+     * on the decision level 0 are part of the backbone without any resolution, the learned clauses are kept from a resolution to the other.
+     *
+     * @note with symmetry breaking enabled (see solver_context::configuration::symmetry_breaking), this is the backbone of the model up to
+     * its symmetries
+     * @param variables variables the backbone is computed on (every variable of the model if empty), unknown variables are ignored
+     * @param limits cancellation, deadline and budgets applied on each resolution
+     * @return backbone literals (sorted by variable), sat_error::unsatisfiable if the model has no solution, or sat_error::unknown if the
+     * limits stopped a resolution
+     */
+    std::expected<std::vector<literal>, sat_error> backbone(std::span<const literal> variables = {}, const solve_limits& limits = {});
+
+    /**
+     * @return subset of the assumptions of the last resolution that is enough to make the problem unsatisfiable (empty if the problem is
+     * unsatisfiable without any assumption)
+     */
+    [[nodiscard]] const std::vector<literal>& unsat_core() const { return unsat_core_; }
+
+    /**
+     * @brief add a clause to the model being solved, variables not yet known by the solver are added to the model
+     * @note the solver is reset to the decision level 0 before adding the clause, learned clauses are kept
+     * @param clause literals of the clause to add, cannot be empty
+     */
+    void add_clause(std::vector<literal> clause);
+
+    /**
+     * @brief add a cardinality constraint to the model being solved, variables not yet known by the solver are added to the model
+     * @note the solver is reset to the decision level 0 before adding the constraint, learned clauses are kept
+     * @param constraint cardinality constraint to add
+     */
+    void add_cardinality(cardinality_constraint constraint);
+
+    /**
+     * @brief add a XOR constraint to the model being solved, variables not yet known by the solver are added to the model
+     * @note the solver is reset to the decision level 0 before adding the constraint, learned clauses are kept
+     * @param constraint XOR constraint to add, propagated by Gauss-Jordan elimination along with the other XOR constraints (see xor_engine)
+     */
+    void add_xor(xor_constraint constraint);
+
+    /**
+     * @param max_lbd maximum LBD of the clauses returned (the lower the LBD, the more useful the clause is expected to be)
+     * @param last only the last learned clauses kept by the solver are looked at (the clauses are kept in the order they are learned)
+     * @return clauses learned by the solver, expressed with the variables of the model
+     * @note no clause is returned once symmetry breaking predicates have been added (see break_symmetries) : the clauses learned can be derived
+     * from the predicates, they are not implied by the model and would remove solutions from another solver they are seeded into
+     */
+    [[nodiscard]] std::vector<lbd_clause> learned_clauses(std::uint32_t max_lbd = std::numeric_limits<std::uint32_t>::max(),
+                                                          std::size_t last       = std::numeric_limits<std::size_t>::max()) const;
+
+    /**
+     * @return saved phase of every variable of the model (the literal of the value the variable would be decided on), the auxiliary variables
+     * of the solver are not part of it
+     */
+    [[nodiscard]] std::vector<literal> saved_phases() const;
+
+    /**
+     * @brief warm start the solver with the clauses learned and phases saved by a previous resolution of the same model (or of a subset of it)
+     * @note learned clauses are only valid if they are implied by the model : the resolution they come from must be on a subset of the model
+     * @param learned clauses to add to the learned clauses of the solver, clauses on variables unknown to the model are ignored
+     * @param phases phases to set as saved phases, phases of variables unknown to the model are ignored
+     * @return number of learned clauses seeded
+     */
+    std::size_t seed(std::span<const lbd_clause> learned, std::span<const literal> phases);
+
+    /**
+     * @return statistics of the solver resolution accumulated over all the calls to solve
+     */
+    [[nodiscard]] const solver_context::Statistics& statistics() const { return context_.statistics_; }
+
+    /**
+     * @brief start writing a DRAT proof of the resolutions : when the solver answers unsatisfiable (without assumptions), the proof certifies it
+     *
+     * The clauses learned (and deleted) from now on are written into the proof with the variables of the model, the proof is concluded by the
+     * empty clause when the unsatisfiability is found. It can be checked against the CNF of the model (e.g. with drat-trim).
+     *
+     * @note the proof has to be started before the first resolution, on a solver that has not been seeded : the clauses it already learned
+     * are not part of it
+     * @note clauses derived from native cardinality constraints are not implied by the clauses of the formula : a proof of a model with
+     * cardinality constraints cannot be checked against its clauses only
+     * @note the same applies to the symmetry breaking predicates (see solver_context::configuration::symmetry_breaking) : they are not implied
+     * by the model
+     * @param path file the proof is written into (replaced if it exists)
+     * @param format textual or binary DRAT
+     * @return proof_error::io_error if the file cannot be opened
+     */
+    [[nodiscard]] std::expected<void, proof_error> start_proof(const std::filesystem::path& path, proof_format format = proof_format::drat);
+
+    /**
+     * @brief write the end of the proof and close its file (a proof is also closed when the solver is destroyed)
+     * @return proof_error::io_error if the proof could not be written entirely
+     */
+    std::expected<void, proof_error> close_proof();
+
+  private:
+    /**
+     * @brief add the XOR constraints encoded by the clauses of the solver to its XOR engine, if enabled by the configuration (see
+     * find_xor_constraints)
+     * @note the clauses are kept : the XOR engine propagates the combinations of the constraints that the clauses cannot
+     */
+    void recognize_xors();
+
+    /**
+     * @brief detect the symmetries of the model and add their lex-leader breaking predicates to it, if enabled by the configuration (see
+     * symmetry.hh)
+     * @note the auxiliary variables of the predicates are variables of the model numbered after the greatest variable of the model, they are
+     * part of the results. The predicates only keep the lexicographically smallest solution among symmetric ones : the solutions enumerated
+     * are the ones of the model up to its symmetries
+     */
+    void break_symmetries();
+
+    /**
+     * @brief add a clause into the clause storage of the solver, variables not yet known by the solver are added to the model
+     * @note the solver has to be on the decision level 0
+     */
+    void ingest_clause(std::span<const literal> clause_literals);
+
+    /**
+     * @brief reserve the storage of the solver for the provided number of variables and clauses
+     */
+    void reserve(std::size_t variables, std::size_t clauses);
+
+    /**
+     * @return solution of the internal resolution expressed with the external variables
+     */
+    std::expected<result, sat_error> to_external(std::expected<result, sat_error> res);
+
+    variable_map variables_;          //!< renumbering of the variables of the model
+    model model_;                     //!< model being solved on internal variables (declared before the context as it refers to it)
+    solver_context context_;          //!< The context for the solver, containing configuration and state.
+    std::vector<literal> unsat_core_; //!< unsat core of the last resolution expressed with the external variables
+    bool symmetry_broken_ {false};    //!< symmetry breaking predicates have been added to the model (see break_symmetries)
+};
+
+/**
+ * @brief Direct ingestion of a model into a solver
+ *
+ * Instead of gathering the whole formula into a model (one vector per clause) that the solver copies again into its clause storage, the clauses
+ * are written straight into the clause storage of the solver as they are produced (by the sat_builder or a CNF parser). The clause literals
+ * are only read : the caller can re-use the same buffer for every clause.
+ *
+ * The variables are numbered in order of first appearance (see variable_map), add_variable can be used to declare them beforehand.
+ */
+class solver_builder {
+  public:
+    explicit solver_builder(solver_context::configuration conf = {})
+        : solver_(model {.conf = std::move(conf)}) {}
+
+    /**
+     * @brief reserve the storage of the solver, avoid the re-allocations while the model is ingested
+     */
+    solver_builder& reserve(std::size_t variables, std::size_t clauses) {
+        solver_.reserve(variables, clauses);
+        return *this;
+    }
+
+    /**
+     * @brief declare a variable of the model (a variable only referenced by the clauses is declared by them)
+     * @param var variable to declare
+     * @param context FABL construct the variable has been generated for, the constraints added afterward on the variable are attached to it
+     * (see solver::minimal_unsat_core)
+     */
+    solver_builder& add_variable(const literal& var, std::optional<fabl::compiler_generation_context> context = std::nullopt);
+
+    /**
+     * @brief add a clause to the model, the literals are copied into the clause storage of the solver
+     * @param clause literals of the clause, cannot be empty
+     */
+    solver_builder& add_clause(std::span<const literal> clause) {
+        solver_.ingest_clause(clause);
+        return *this;
+    }
+
+    solver_builder& add_cardinality(cardinality_constraint constraint) {
+        solver_.add_cardinality(std::move(constraint));
+        return *this;
+    }
+
+    solver_builder& add_xor(xor_constraint constraint) {
+        solver_.add_xor(std::move(constraint));
+        return *this;
+    }
+
+    /**
+     * @return solver of the ingested model
+     */
+    [[nodiscard]] solver build() && {
+        solver_.recognize_xors();
+        solver_.break_symmetries();
+        return std::move(solver_);
+    }
 
   private:
-    solver_context context_; // !< The context for the solver, containing configuration and state.
-    model model_;
+    solver solver_;
 };
 
+/**
+ * @brief Create a solver from a CNF file, the clauses are parsed straight into the clause storage of the solver (see solver_builder)
+ *
+ * The file is mapped in memory and split into chunks starting on a line, parsed in place and in parallel into a buffer per thread. The buffers
+ * are then ingested into the solver in the order of the file (a clause spanning over two chunks is joined back) : the variables are numbered as
+ * if the file was parsed sequentially, the header is validated before the split and the number of clauses after the ingestion.
+ *
+ * @param cnf_file Path to the CNF file to be processed.
+ * @param conf configuration of the solver
+ * @param threads number of threads parsing the file (0 : one thread per MiB of the file, up to the hardware concurrency)
+ * @return solver of the model of the CNF file
+ * @throws std::runtime_error if the file cannot be read, if the header is invalid or if a literal refers to a variable above the number of
+ * variables declared by the header
+ */
+solver make_solver_from_cnf_file(const std::filesystem::path& cnf_file, solver_context::configuration conf = {}, std::size_t threads = 0);
+
 } // namespace fabko::compiler::sat
 
 #endif // SOLVER_HH
@@ -13,23 +13,35 @@
 #ifndef SOLVER_CONTEXT_HH
 #define SOLVER_CONTEXT_HH
 
+#include <chrono>
 #include <cstdint>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <string>
 #include <vector>
 
 #include <fil/datastructure/soa.hh>
 
 #include "../../metadata.hh"
+#include "clause_kernels.hh"
+#include "proof.hh"
+#include "solver_policies.hh"
+#include "xor_engine.hh"
 
 //
 // Forward declarations
 namespace fabko::compiler::sat {
 
 class assignment_context;
+struct variable_heuristics;
 
 struct statistics;
 class clause;
+class cardinality;
 class literal;
 class clause_watcher;
+class variable_map;
 enum class assignment;
 struct model;
 } // namespace fabko::compiler::sat
@@ -45,14 +57,18 @@ class solver_solution {
     std::vector<literal> literals_solving_;                                           //!< literals that solve the SAT problem
 };
 
-using Vars_Soa    = fil::soa::soa<literal, assignment, assignment_context, metadata>; //!< structure of arrays representing a variable
-using Clauses_Soa = fil::soa::soa<clause, clause_watcher, metadata>;                  //!< structure of arrays representing a clause
+//! structure of arrays representing a variable : the columns read in propagation and conflict analysis (literal, assignment and assignment
+//! context) are separated from the heuristic state and the compiler metadata that are seldom accessed
+using Vars_Soa          = fil::soa::soa<literal, assignment, assignment_context, variable_heuristics, metadata>;
+using Clauses_Soa       = fil::soa::soa<clause, clause_watcher, metadata>; //!< structure of arrays representing a clause
+using Cardinalities_Soa = fil::soa::soa<cardinality, metadata>;            //!< structure of arrays representing a cardinality constraint
 
 enum var_values {
     soa_literal          = 0,
     soa_assignment       = 1,
     soa_assignment_ctx   = 2,
-    soa_var_compiler_ctx = 3,
+    soa_var_heuristics   = 3,
+    soa_var_compiler_ctx = 4,
 };
 
 enum clause_values {
@@ -61,6 +77,19 @@ enum clause_values {
     soa_clause_compiler_ctx = 2,
 };
 
+enum cardinality_values {
+    soa_cardinality              = 0,
+    soa_cardinality_compiler_ctx = 1,
+};
+
+/**
+ * @brief clause learned through the conflict analysis
+ */
+struct learned_clause_entry {
+    std::uint32_t clause_index; //!< index of the clause in solver_context::clause_ids_
+    std::uint32_t lbd;          //!< LBD (Literal Block Distance) of the clause when it was learned
+};
+
 /**
  * @brief Represents the context for managing the state of a SAT solver
  *
@@ -71,13 +100,65 @@ enum clause_values {
  * @note clause can be learned using Conflict-Driven Clause Learning (CDCL) techniques
  */
 struct solver_context {
+    struct Statistics {
+        std::size_t restarts {};                        //!< number of restarts that occurred
+        std::size_t rephases {};                        //!< number of saved phases reset from a local search assignment
+        std::size_t conflicts {};                       //!< number of conflicts that occurred in the overall execution of the solver
+        std::size_t propagations {};                    //!< amount of propagation that occurred
+        std::size_t decisions {};                       //!< number of decisions taken
+        std::size_t backtracks {};                      //!< number of backtracking that occurred
+        std::size_t chrono_backtracks {};               //!< number of chronological backtracking (only the conflict level is unwound)
+        std::size_t reused_levels {};                   //!< number of decision levels kept on restarts thanks to the trail reuse
+        std::size_t learned_clause {};                  //!< number of clauses learned through the CDCL
+        std::size_t learned_lbd_sum {};                 //!< sum of the LBD (Literal Block Distance) of every learned clause
+        std::size_t reductions {};                      //!< number of reductions of the learned clauses
+        std::size_t deleted_clause {};                  //!< number of learned clauses deleted by the reductions
+        std::size_t max_decision_lvl {};                //!< level of decision maximum during sat solver
+        std::size_t trail_depth {};                     //!< size of the trail at the time the statistics were last reported
+        std::size_t max_trail_depth {};                 //!< maximum size of the trail reached during sat solver
+        std::size_t memory_bytes {};                    //!< estimation of the memory used by the solver (variables, clauses, watchers and trail)
+        std::size_t clause_bytes {};                    //!< memory of the clauses of the model (and of the cardinality constraints)
+        std::size_t learned_clause_bytes {};            //!< memory of the learned clauses
+        std::size_t watcher_bytes {};                   //!< memory of the watchers of the clauses
+        std::size_t trail_bytes {};                     //!< memory of the trail
+        std::size_t peak_memory_bytes {};               //!< maximum memory measured during sat solver
+        std::size_t memory_reductions {};               //!< number of reductions of the learned clauses forced by the memory limit
+        std::chrono::steady_clock::duration elapsed {}; //!< time spent solving
+
+        /**
+         * @return average LBD of the learned clauses, a low value indicates good quality learned clauses
+         */
+        [[nodiscard]] double average_lbd() const { return learned_clause == 0 ? 0.0 : static_cast<double>(learned_lbd_sum) / static_cast<double>(learned_clause); }
+
+        [[nodiscard]] double conflicts_per_second() const { return per_second(conflicts); }
+        [[nodiscard]] double propagations_per_second() const { return per_second(propagations); }
+
+      private:
+        [[nodiscard]] double per_second(std::size_t value) const {
+            const auto seconds = std::chrono::duration<double>(elapsed).count();
+            return seconds > 0.0 ? static_cast<double>(value) / seconds : 0.0;
+        }
+    };
+
     struct configuration {
 
+        //! specialization of the search loop used (see solver_policies.hh) : the dynamic profile follows the configuration below, the other ones
+        //! have their restart, decision and deletion strategies fixed at compile time
+        solver_profile profile {solver_profile::dynamic};
+
         //! after a certain number of conflicts, restart the resolution of the sat solver to avoid the algorithm to
         //! being stuck in a bad path of the resolution domain.
         // @todo check in tuto what are the recommended values for start
         std::uint32_t restart_threshold {100};
         std::uint32_t restart_multiplier {2}; //!< multiplier that is applied on the threshold when hit
+        bool restart_trail_reuse {true};      //!< on restart, keep the decision levels that would be decided again identically
+
+        //! backjump distance (in decision levels) above which the solver backtracks chronologically (0 disables the chronological backtracking)
+        std::size_t chrono_backtrack_threshold {100};
+
+        //! number of conflicts between two reductions of the learned clauses : the half of highest LBD is deleted (0 keeps every learned clause)
+        std::size_t reduce_interval {0};
+        std::uint32_t reduce_glue_lbd {2}; //!< learned clauses of LBD lower or equal are never deleted
 
         // VSIDS (Variable State Independent Decaying Sum) configurations
 
@@ -85,25 +166,89 @@ struct solver_context {
         std::int32_t vsids_increment {10};
         std::int32_t decay_interval {100}; //!< number of ticks before decaying the vsids (to favor recent conflict)
         float vsids_decay_ratio {0.95};    //!< ratio to decrease the importance of the vsids value over time
-    };
 
-    struct Statistics {
-        std::size_t restarts;         //!< number of restarts that occurred
-        std::size_t conflicts;        //!< number of conflicts that occurred in the overall execution of the solver
-        std::size_t propagations;     //!< amount of propagation that occurred
-        std::size_t decisions;        //!< number of decisions taken
-        std::size_t backtracks;       //!< number of backtracking that occurred
-        std::size_t learned_clause;   //!< number of clauses learned through the CDCL
-        std::size_t max_decision_lvl; //!< level of decision maximum during sat solver
+        // Rephasing : a local search (see local_search.hh) is run on restarts, its best assignment becomes the saved phases of the variables
+
+        bool local_search_rephasing {false};   //!< enable the rephasing from the local search
+        std::size_t rephase_interval {4};      //!< number of restarts between two rephasing
+        std::size_t rephase_max_flips {50000}; //!< number of flips allowed to the local search at each rephasing
+
+        // Symmetry breaking : symmetries of the model are detected when the solver is created (see symmetry.hh), lex-leader predicates are added
+        // to the model to prune the symmetric parts of the search space
+
+        bool symmetry_breaking {false};                 //!< enable the symmetry detection and breaking
+        std::size_t symmetry_max_generators {64};       //!< maximum number of symmetries broken
+        std::size_t symmetry_max_variables {10000};     //!< the detection is skipped on models with more variables
+        std::size_t symmetry_max_predicate_length {32}; //!< maximum number of variables compared by the predicate of a symmetry
+
+        // XOR constraints : the XOR constraints of the model are propagated by Gauss-Jordan elimination (see xor_engine.hh)
+
+        bool xor_recognition {false}; //!< look for the XOR constraints encoded by the clauses of the model (they are propagated natively as well)
+        std::size_t xor_max_size {6}; //!< maximum number of variables of the XOR constraints recognized (encoded by 2^(size-1) clauses)
+
+        // Memory limit : the memory used by the solver is measured periodically (see Statistics::memory_bytes), above the limit the learned
+        // clauses are reduced aggressively (glue clauses included), the resolution is abandoned (result unknown) if it stays above the limit
+
+        std::size_t memory_limit {0};            //!< maximum memory in bytes the solver can use (0 disables the limit)
+        std::size_t memory_check_interval {256}; //!< number of conflicts between two measures of the memory against the limit
+
+        // Progress reporting
+
+        //! number of conflicts between two progress reports (0 disables the progress report)
+        std::size_t progress_interval {1000};
+        //! callback called at each progress report, if not set the statistics are logged instead
+        std::function<void(const Statistics&)> progress_callback {};
     };
 
     explicit solver_context(const model& model);
 
+    /**
+     * @return for each clause of clause_ids_, true if it has been learned through the conflict analysis, false if it is a clause of the model
+     */
+    [[nodiscard]] std::vector<bool> learned_clause_mask() const;
+
+    /**
+     * @return allocator of the literals of the clauses stored in clauses_soa_
+     */
+    [[nodiscard]] std::pmr::polymorphic_allocator<> clause_allocator() const { return clause_memory_.get(); }
+
+    /**
+     * @brief buffers re-used along the search : they are cleared on use (keeping their capacity) so the search loop does not allocate once
+     * they reached the size of the largest clause analysed
+     */
+    struct scratch_buffers {
+        std::vector<std::pair<literal, Vars_Soa::struct_id>> reason;     //!< explanation of the propagation of a variable
+        std::vector<std::pair<literal, Vars_Soa::struct_id>> conflict;   //!< explanation of the conflict, resolved into the learned clause
+        std::vector<std::pair<literal, Vars_Soa::struct_id>> unassigned; //!< unassigned literals of a cardinality constraint being propagated
+        std::vector<Vars_Soa::struct_id> current_level;                  //!< variables of the clause being learned assigned on the conflict level
+        std::vector<Vars_Soa::struct_id> kept;                           //!< out-of-order literals kept on the trail by a backtrack
+        std::vector<std::uint32_t> levels;                               //!< decision levels of a clause (LBD computation)
+        std::vector<std::uint8_t> values;                                //!< packed assignment of the variables (model verification)
+        std::vector<xor_implication> implied;                            //!< variables implied by the XOR engine
+    };
+
     configuration config_ {};                   //!< configuration of the solver
-    std::reference_wrapper<const model> model_; //!< reference to the model being solved
+    std::reference_wrapper<const model> model_; //!< reference to the model being solved (the solver releases its clauses once stored in clauses_soa_)
+
+    //! pool in which the literals of the clauses (of the model and learned) are allocated, the memory of a clause released is re-used for the next
+    //! ones instead of going back to the heap. It must outlive clauses_soa_ (it is held by pointer to keep its address stable on move)
+    std::unique_ptr<std::pmr::unsynchronized_pool_resource> clause_memory_ {std::make_unique<std::pmr::unsynchronized_pool_resource>()};
 
     Vars_Soa vars_soa_;                         //!< variables of the SAT solver, containing their assignment and context
+    std::vector<Vars_Soa::struct_id> var_ids_;  //!< identifier in vars_soa_ of each variable (indexed by variable - 1, variables are dense)
     Clauses_Soa clauses_soa_;                   //!< clauses of the SAT solver, containing their watchers and context
+    Cardinalities_Soa cardinalities_soa_;       //!< cardinality constraints of the SAT solver, propagated natively by counting
+
+    //! identifier in clauses_soa_ of each clause, the index in this table is the 32-bit reason stored in the assignment_context
+    std::vector<Clauses_Soa::struct_id> clause_ids_;
+    //! identifier in cardinalities_soa_ of each cardinality constraint, the index in this table is the 32-bit reason stored in the assignment_context
+    std::vector<Cardinalities_Soa::struct_id> cardinality_ids_;
+    //! clauses learned through the conflict analysis (the other clauses of clause_ids_ are the clauses of the model)
+    std::vector<learned_clause_entry> learned_clauses_ {};
+    //! XOR constraints of the model (added natively or recognized from the clauses), propagated along the clauses and cardinality constraints
+    xor_engine xors_ {};
+    //! clauses of clause_ids_ packed for the SIMD evaluation of a whole assignment (synced lazily on the verification of a model)
+    packed_clauses packed_clauses_ {};
 
     //! trail of assigned literals and their context
     //! the trail store in an ordered fashion all the variables that has been assigned during sat resolution. the level of assignment of the literal
@@ -113,11 +258,28 @@ struct solver_context {
     std::size_t conflict_count_since_last_restart_ {0}; //!< current number of conflicts since last restart
     std::size_t current_decision_level_ {0};
 
+    //! literals assumed to be true for the current resolution, each assumption is decided on its own decision level (the first ones)
+    std::vector<std::pair<literal, Vars_Soa::struct_id>> assumptions_ {};
+    //! subset of the assumptions that made the last resolution unsatisfiable (empty if the problem is unsatisfiable without assumptions)
+    std::vector<literal> unsat_core_ {};
+
     Statistics statistics_ {};                          //!< resolution statistics of the solver
 
+    //! DRAT proof of the resolution if enabled (see solver::start_proof) : learned and deleted clauses are written into it
+    std::unique_ptr<proof_writer> proof_ {};
+    //! renumbering of the variables of the solver (set by the solver owning the context) : the proof is written with the variables of the model
+    const variable_map* variables_ {nullptr};
+
+    scratch_buffers scratch_ {};                        //!< buffers of the search loop (see scratch_buffers)
+
     std::vector<solver_solution> solutions_found_ {};   //!< final solutions found by the solver
 };
 
+/**
+ * @return human-readable summary of the solver statistics (throughput, search counters, learned clause quality and memory)
+ */
+[[nodiscard]] std::string to_string(const solver_context::Statistics& stats);
+
 } // namespace fabko::compiler::sat
 
 #endif // SOLVER_CONTEXT_HH
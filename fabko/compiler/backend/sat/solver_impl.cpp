@@ -11,13 +11,18 @@
 //
 
 #include <algorithm>
+#include <chrono>
 #include <expected>
+#include <iterator>
 #include <numeric>
 #include <optional>
 #include <ranges>
 
+#include "clause_kernels.hh"
 #include "common/logging.hh"
+#include "local_search.hh"
 #include "solver.hh"
+#include "solver_policies.hh"
 
 #include "solver_context.hh"
 
@@ -25,6 +30,109 @@ namespace fabko::compiler::sat::impl_details {
 
 namespace {
 constexpr std::string SECTION = "sat_solver"; //!< logging a section for the SAT solver
+
+/**
+ * @return true if the debug messages of the search loop are logged with the logging policy (always false if they are compiled out)
+ */
+template<typename Logging>
+bool debug_logged() {
+    if constexpr (Logging::compiled) {
+        return is_debug_logged();
+    } else {
+        return false;
+    }
+}
+
+/**
+ * @brief Record the time spent in a solving call into the solver statistics when going out of scope
+ */
+class elapsed_time_recorder {
+  public:
+    explicit elapsed_time_recorder(solver_context& ctx)
+        : ctx_(ctx)
+        , start_(std::chrono::steady_clock::now())
+        , elapsed_before_(ctx.statistics_.elapsed) {}
+
+    ~elapsed_time_recorder() { update(); }
+
+    elapsed_time_recorder(const elapsed_time_recorder&)            = delete;
+    elapsed_time_recorder& operator=(const elapsed_time_recorder&) = delete;
+
+    void update() { ctx_.statistics_.elapsed = elapsed_before_ + (std::chrono::steady_clock::now() - start_); }
+
+  private:
+    solver_context& ctx_;
+    std::chrono::steady_clock::time_point start_;
+    std::chrono::steady_clock::duration elapsed_before_;
+};
+
+/**
+ * @brief Check cooperatively the limits (cancellation, deadline and budgets) of a solving call
+ *
+ * Budgets are checked at each call as they only require comparing counters. The stop token and the deadline are more costly
+ * (atomic load and clock access) and are only checked every CHECK_INTERVAL calls.
+ */
+class limits_checker {
+    static constexpr std::size_t CHECK_INTERVAL = 64;
+
+  public:
+    limits_checker(const solver_context& ctx, const solve_limits& limits)
+        : limits_(limits)
+        , conflicts_start_(ctx.statistics_.conflicts)
+        , propagations_start_(ctx.statistics_.propagations) {}
+
+    /**
+     * @return true if one of the limits has been reached and the resolution has to be abandoned, false otherwise
+     */
+    [[nodiscard]] bool reached(const solver_context& ctx) {
+        if (limits_.conflict_budget.has_value() && ctx.statistics_.conflicts - conflicts_start_ >= limits_.conflict_budget.value()) {
+            log_debug("conflict budget of {} reached", limits_.conflict_budget.value());
+            return true;
+        }
+        if (limits_.propagation_budget.has_value() && ctx.statistics_.propagations - propagations_start_ >= limits_.propagation_budget.value()) {
+            log_debug("propagation budget of {} reached", limits_.propagation_budget.value());
+            return true;
+        }
+        if (++calls_ % CHECK_INTERVAL != 0) {
+            return false;
+        }
+        if (limits_.stop_token.stop_requested()) {
+            log_debug("stop requested on the resolution");
+            return true;
+        }
+        if (limits_.deadline.has_value() && std::chrono::steady_clock::now() >= limits_.deadline.value()) {
+            log_debug("deadline reached");
+            return true;
+        }
+        return false;
+    }
+
+  private:
+    const solve_limits& limits_;
+    std::size_t conflicts_start_;
+    std::size_t propagations_start_;
+    std::size_t calls_ {0};
+};
+
+} // namespace
+
+using reason_literals = std::vector<std::pair<literal, Vars_Soa::struct_id>>; //!< literals of a clause explaining a propagation or a conflict
+
+/**
+ * @brief constraint found in conflict by the unit propagation (either a clause, a cardinality constraint or a row of the XOR engine)
+ */
+struct conflict_source {
+    std::optional<std::uint32_t> clause {};      //!< index in solver_context::clause_ids_
+    std::optional<std::uint32_t> cardinality {}; //!< index in solver_context::cardinality_ids_
+    bool xors {false};                           //!< true if the conflict has been found by the XOR engine (see xor_engine::conflict)
+};
+
+/**
+ * @return true if the variable is assigned to a value that satisfies the literal, false otherwise
+ */
+bool is_literal_satisfied(const solver_context& ctx, const literal& lit, Vars_Soa::struct_id varid) {
+    const auto assignment = get<soa_assignment>(ctx.vars_soa_[varid]);
+    return (lit.is_on() && assignment == assignment::on) || (lit.is_off() && assignment == assignment::off);
 }
 
 /**
@@ -32,11 +140,82 @@ constexpr std::string SECTION = "sat_solver"; //!< logging a section for the SAT
  */
 bool is_clause_satisfied(const solver_context& ctx, const clause& clause) {
     const auto& all_clause_lit = clause.get_literals();
-    return std::ranges::any_of(all_clause_lit, [&ctx](const auto& lit) {
-        const auto& [literal, varid] = lit;
-        const auto assignment        = get<soa_assignment>(ctx.vars_soa_[varid]);
-        return (literal.is_on() && assignment == assignment::on) || (literal.is_off() && assignment == assignment::off);
-    });
+    return std::ranges::any_of(all_clause_lit, [&ctx](const auto& lit) { return is_literal_satisfied(ctx, lit.first, lit.second); });
+}
+
+/**
+ * @brief fill the buffer with the negation of the current value of the variables (indexes in solver_context::var_ids_)
+ */
+void append_falsified(const solver_context& ctx, std::span<const std::uint32_t> variables, reason_literals& reason) {
+    for (const auto variable : variables) {
+        const auto varid = ctx.var_ids_[variable];
+        const auto value = static_cast<std::int64_t>(variable + 1);
+        reason.emplace_back(literal {get<soa_assignment>(ctx.vars_soa_[varid]) == assignment::on ? -value : value}, varid);
+    }
+}
+
+/**
+ * @brief explain the assignment of a propagated variable as a clause : the propagated literal and the negation of its antecedents
+ *
+ * For a clause propagation, the explanation is the clause itself. For a cardinality propagation (the literal has been made false because the
+ * bound was reached), the explanation is made lazily out of the literals of the constraint that were true before the propagation. For a XOR
+ * propagation, the explanation is made of the variables of the row of the XOR engine that implied the variable (recorded on propagation).
+ *
+ * @param ctx solving context
+ * @param varid propagated variable
+ * @param reason buffer filled with the literals of the clause explaining the propagation (its previous content is cleared)
+ */
+void explain(const solver_context& ctx, Vars_Soa::struct_id varid, reason_literals& reason) {
+    reason.clear();
+    const auto& assign_ctx = get<soa_assignment_ctx>(ctx.vars_soa_[varid]);
+    if (assign_ctx.has_clause_reason()) {
+        const auto& clause_lits = get<soa_clause>(ctx.clauses_soa_[ctx.clause_ids_[assign_ctx.clause_reason()]]).get_literals();
+        reason.assign(clause_lits.begin(), clause_lits.end());
+        return;
+    }
+    if (assign_ctx.has_xor_reason()) {
+        const auto variable = assign_ctx.xor_reason();
+        const auto value    = static_cast<std::int64_t>(variable + 1);
+        reason.emplace_back(literal {get<soa_assignment>(ctx.vars_soa_[varid]) == assignment::on ? value : -value}, varid);
+        append_falsified(ctx, ctx.xors_.reason(variable), reason);
+        return;
+    }
+
+    const auto& card        = get<soa_cardinality>(ctx.cardinalities_soa_[ctx.cardinality_ids_[assign_ctx.cardinality_reason()]]);
+    std::size_t antecedents = 0;
+    for (const auto& [lit, card_varid] : card.get_literals()) {
+        if (card_varid.offset == varid.offset) {
+            reason.emplace_back(lit.negation(), card_varid);
+        } else if (antecedents < card.bound() && is_literal_satisfied(ctx, lit, card_varid)
+                   && get<soa_assignment_ctx>(ctx.vars_soa_[card_varid]).trail_position_ < assign_ctx.trail_position_) {
+            reason.emplace_back(lit.negation(), card_varid);
+            ++antecedents;
+        }
+    }
+}
+
+/**
+ * @brief fill the buffer with the literals of the clause in conflict, for a cardinality constraint : the negation of bound + 1 of its true literals,
+ * for the XOR engine : the negation of the values of the variables of the row in conflict
+ */
+void explain_conflict(const solver_context& ctx, const conflict_source& conflict, reason_literals& reason) {
+    reason.clear();
+    if (conflict.xors) {
+        append_falsified(ctx, ctx.xors_.conflict(), reason);
+        return;
+    }
+    if (conflict.clause.has_value()) {
+        const auto& clause_lits = get<soa_clause>(ctx.clauses_soa_[ctx.clause_ids_[conflict.clause.value()]]).get_literals();
+        reason.assign(clause_lits.begin(), clause_lits.end());
+        return;
+    }
+
+    const auto& card = get<soa_cardinality>(ctx.cardinalities_soa_[ctx.cardinality_ids_[conflict.cardinality.value()]]);
+    for (const auto& [lit, card_varid] : card.get_literals()) {
+        if (reason.size() <= card.bound() && is_literal_satisfied(ctx, lit, card_varid)) {
+            reason.emplace_back(lit.negation(), card_varid);
+        }
+    }
 }
 
 bool has_conflict(const solver_context& ctx, const clause& clause) { // @todo remove function when watchers is implemented
@@ -60,58 +239,76 @@ void update_vsids_activity(solver_context& ctx, const clause& learned_clause) {
     const auto& all_lit = learned_clause.get_literals();
 
     const bool need_normalization = std::ranges::any_of(all_lit, [&ctx](const auto& lit) { // check if any variable activity is too high
-        const auto vsids_activity = get<soa_assignment_ctx>(ctx.vars_soa_[lit.second]).vsids_activity_;
+        const auto vsids_activity = get<soa_var_heuristics>(ctx.vars_soa_[lit.second]).vsids_activity_;
         return vsids_activity >= (std::numeric_limits<decltype(vsids_activity)>::max() - ctx.config_.vsids_increment);
     });
     if (need_normalization) {
         static constexpr auto NORMALIZATION_FACTOR = 1e6;
-        std::ranges::for_each(ctx.vars_soa_, fil::soa::index_select<soa_assignment_ctx>([](auto& assignment_ctx) { //
-            assignment_ctx.vsids_activity_ /= NORMALIZATION_FACTOR;
+        std::ranges::for_each(ctx.vars_soa_, fil::soa::index_select<soa_var_heuristics>([](auto& heuristics) { //
+            heuristics.vsids_activity_ /= NORMALIZATION_FACTOR;
         }));
     }
 
     // increase the VSIDS activity of the variables in the learned clause
     for (const auto& varid : all_lit | std::views::values) {
-        auto& assignment_context = get<soa_assignment_ctx>(ctx.vars_soa_[varid]);
-        assignment_context.vsids_activity_ += ctx.config_.vsids_increment;
+        get<soa_var_heuristics>(ctx.vars_soa_[varid]).vsids_activity_ += ctx.config_.vsids_increment;
     }
 
     // decrease the VSIDS for all variables if the counter of conflict exceeded the configured decay interval
     if (ctx.statistics_.conflicts % ctx.config_.decay_interval == 0) {
-        std::ranges::for_each(ctx.vars_soa_, fil::soa::index_select<soa_assignment_ctx>([&ctx](auto& assignment_ctx) { //
-            assignment_ctx.vsids_activity_ /= ctx.config_.vsids_decay_ratio;
+        std::ranges::for_each(ctx.vars_soa_, fil::soa::index_select<soa_var_heuristics>([&ctx](auto& heuristics) { //
+            heuristics.vsids_activity_ /= ctx.config_.vsids_decay_ratio;
         }));
     }
 }
 
+/**
+ * @brief level at which a propagation is implied : the highest decision level among the assigned antecedents
+ * @note with chronological backtracking the level of a propagation can be lower than the current decision level (out-of-order literal)
+ * @param ctx solving context
+ * @param varids variables of the antecedents of the propagation (unassigned variables are ignored)
+ */
+std::size_t implication_level(const solver_context& ctx, std::ranges::input_range auto&& varids) {
+    std::size_t level = 0;
+    for (const auto& varid : varids) {
+        const auto soa_struct = ctx.vars_soa_[varid];
+        if (get<soa_assignment>(soa_struct) != assignment::not_assigned) {
+            level = std::max(level, static_cast<std::size_t>(get<soa_assignment_ctx>(soa_struct).decision_level_));
+        }
+    }
+    return level;
+}
+
 /**
  * @brief conflict resolution step consist of analyzing a found conflicting clause
  *  As the SAT solver implement CDCL (Clause-Driven Clause Learning) learned clause is retrieved from that and an indication of the backtracking to be done to
  *  continue SAT resolution
  * @param ctx solving context to resolve the conflict from
- * @param conflict_soastruct_clause clause that conflicted in the solving context
+ * @param learned_clause literals of the clause (or of the explanation of the cardinality constraint) that conflicted in the solving context, the
+ *  buffer is resolved in place into the learned clause
  * @return a resolution result that provides the learned clause as well as the backtracking level at which the solver must return to for continuation of the sat solve
  */
-conflict_resolution_result resolve_conflict(solver_context& ctx, Clauses_Soa::soa_struct conflict_soastruct_clause) {
-    const auto& [conflict_clause, watcher, meta] = conflict_soastruct_clause;
-    log_debug("analyzing conflicting clause: {}", to_string(conflict_clause));
-
-    auto current_level_vars = std::ranges::fold_left(conflict_clause.get_literals(),
-        std::vector<Vars_Soa::soa_struct> {}, //
-        [&ctx](std::vector<Vars_Soa::soa_struct> res, auto conflict_clausepair) {
-            auto struct_soa            = ctx.vars_soa_[conflict_clausepair.second];
-            const auto& assignment_ctx = get<soa_assignment_ctx>(struct_soa);
-            if (assignment_ctx.decision_level_ == ctx.current_decision_level_) {
-                res.push_back(struct_soa);
-            }
-            return res;
-        });
+template<typename Logging>
+conflict_resolution_result resolve_conflict(solver_context& ctx, reason_literals& learned_clause) {
+    if (debug_logged<Logging>()) {
+        log_debug("analyzing conflicting clause: clause[{}]",
+            std::ranges::fold_left(learned_clause, std::string {}, [](std::string&& res, const auto& lit) { return res + to_string(lit.first) + ", "; }));
+    }
 
-    // learned clause to be returned : start as being equal to the conflict clause
-    std::vector<std::pair<literal, Vars_Soa::struct_id>> learned_clause = conflict_clause.get_literals();
+    auto& current_level_vars = ctx.scratch_.current_level;
+    current_level_vars.clear();
+    for (const auto& varid : learned_clause | std::views::values) {
+        if (get<soa_assignment_ctx>(ctx.vars_soa_[varid]).decision_level_ == ctx.current_decision_level_) {
+            current_level_vars.push_back(varid);
+        }
+    }
 
-    std::size_t backtrack_level = 0;                     // backtracking level retrieved from a learned clause
-    std::size_t trail_index     = ctx.trail_.size() - 1; // index of the trail to backtrack to // @todo : do the iteration with reverse iterator
+    // backtracking level retrieved from a learned clause : the highest level below the current one among its literals
+    std::size_t backtrack_level = std::ranges::fold_left(learned_clause | std::views::values, std::size_t {0}, [&ctx](std::size_t res, const auto& varid) {
+        const std::size_t level = get<soa_assignment_ctx>(ctx.vars_soa_[varid]).decision_level_;
+        return level < ctx.current_decision_level_ ? std::max(res, level) : res;
+    });
+    std::size_t trail_index = ctx.trail_.size() - 1; // index of the trail to backtrack to // @todo : do the iteration with reverse iterator
 
     // to find a UIP (Unique Implication Point), we need to resolve all the antecedent clause (clause resulting from the propagation of the literals)
     // at the current decision level, we need to keep one variable from the current level.
@@ -119,12 +316,10 @@ conflict_resolution_result resolve_conflict(solver_context& ctx, Clauses_Soa::so
 
         while (trail_index > 0) {
             const auto trail_struct_id   = ctx.trail_[trail_index];
-            const auto& trail_node       = ctx.vars_soa_[trail_struct_id];
-            const auto trail_var         = get<soa_literal>(trail_node).value();
-            const auto& trail_assign_ctx = get<soa_assignment_ctx>(trail_node);
+            const auto& trail_assign_ctx = get<soa_assignment_ctx>(ctx.vars_soa_[trail_struct_id]);
 
             if (!trail_assign_ctx.is_decision() && trail_assign_ctx.decision_level_ == ctx.current_decision_level_) {
-                if (std::ranges::any_of(current_level_vars, [trail_var](const auto& current_var) { return get<soa_literal>(current_var).value() == trail_var; })) {
+                if (std::ranges::any_of(current_level_vars, [trail_struct_id](const auto& current_var) { return current_var.offset == trail_struct_id.offset; })) {
                     break;
                 }
             }
@@ -132,7 +327,9 @@ conflict_resolution_result resolve_conflict(solver_context& ctx, Clauses_Soa::so
             --trail_index;
         }
         if (trail_index == 0) {
-            log_debug(" :: trail empty");
+            if (debug_logged<Logging>()) {
+                log_debug(" :: trail empty");
+            }
             break;
         }
 
@@ -144,16 +341,17 @@ conflict_resolution_result resolve_conflict(solver_context& ctx, Clauses_Soa::so
         // remove trail literal found from the learned clause
         std::erase_if(learned_clause, [&trail_lit](const auto& lit_struct) { return get<soa_literal>(lit_struct).value() == trail_lit.value(); });
 
-        log_debug(":: resolving with trail antecedent of {}", trail_lit.value());
+        if (debug_logged<Logging>()) {
+            log_debug(":: resolving with trail antecedent of {}", trail_lit.value());
+        }
 
-        if (trail_assign_ctx.clause_propagation_.has_value()) {
-            const auto& propagation_clausestruct = ctx.clauses_soa_[trail_assign_ctx.clause_propagation_.value()];
-            const auto& propagation_vars         = get<soa_clause>(propagation_clausestruct).get_literals();
+        if (trail_assign_ctx.is_propagated()) {
+            auto& propagation_vars = ctx.scratch_.reason;
+            explain(ctx, trail_struct_id, propagation_vars);
 
             // add literals from the propagation clause (except current trail literal)
             for (const auto [prop_lit, prop_varid] : propagation_vars) {
-                const auto prop_node        = ctx.vars_soa_[prop_varid];
-                const auto& prop_assign_ctx = get<soa_assignment_ctx>(prop_node);
+                const auto& prop_assign_ctx = get<soa_assignment_ctx>(ctx.vars_soa_[prop_varid]);
 
                 if (prop_lit.value() == trail_lit.value()
                     || std::ranges::any_of(learned_clause, [&prop_lit](const auto& lit_map) { return prop_lit.value() == lit_map.first.value(); }))
@@ -161,18 +359,20 @@ conflict_resolution_result resolve_conflict(solver_context& ctx, Clauses_Soa::so
 
                 learned_clause.emplace_back(prop_lit, prop_varid);
                 if (prop_assign_ctx.decision_level_ == ctx.current_decision_level_) {
-                    current_level_vars.push_back(prop_node);
+                    current_level_vars.push_back(prop_varid);
                 } else if (prop_assign_ctx.decision_level_ > backtrack_level) {
                     backtrack_level = prop_assign_ctx.decision_level_;
                 }
             }
         }
 
-        std::erase_if(current_level_vars, fil::soa::index_select<soa_literal>([trail_lit](auto lit_var) { return lit_var == trail_lit; }));
+        std::erase_if(current_level_vars, [trail_struct_id](const auto& varid) { return varid.offset == trail_struct_id.offset; });
 
-        log_debug(":: learning clause[{}] :: variable left current var level {}",
-            std::ranges::fold_left(learned_clause, std::string {}, [](std::string&& res, const auto& lit) { return res + to_string(lit.first) + ", "; }),
-            current_level_vars.size());
+        if (debug_logged<Logging>()) {
+            log_debug(":: learning clause[{}] :: variable left current var level {}",
+                std::ranges::fold_left(learned_clause, std::string {}, [](std::string&& res, const auto& lit) { return res + to_string(lit.first) + ", "; }),
+                current_level_vars.size());
+        }
 
         --trail_index;
     }
@@ -182,91 +382,227 @@ conflict_resolution_result resolve_conflict(solver_context& ctx, Clauses_Soa::so
         std::ranges::unique(learned_clause, [](const auto& lhs, const auto& rhs) { return lhs.first.value() == rhs.first.value(); }).begin(),
         learned_clause.end());
 
-    log_debug("conflict resolution :: backtracking to level ({}) :: learned clause (clause[{}])",
-        backtrack_level,                                                                                //
-        std::ranges::fold_left(learned_clause, std::string {}, [](std::string&& res, const auto& lit) { //
-            return res + ", " + to_string(lit.first);
-        }));
+    if (debug_logged<Logging>()) {
+        log_debug("conflict resolution :: backtracking to level ({}) :: learned clause (clause[{}])",
+            backtrack_level,                                                                                //
+            std::ranges::fold_left(learned_clause, std::string {}, [](std::string&& res, const auto& lit) { //
+                return res + ", " + to_string(lit.first);
+            }));
+    }
 
-    return {clause {std::move(learned_clause)}, backtrack_level};
+    // the learned clause is copied out of the scratch buffer into the clause pool, where it is stored once learned
+    return {clause {clause_literals {learned_clause.begin(), learned_clause.end(), ctx.clause_allocator()}}, backtrack_level};
 }
 
 /**
  * @brief backtrack the SAT solver to the indicated level
  *  the SAT solver has a non-linear backtracking implementation. it is backtracking multiple levels to skip unnecessary decision branches thanks to the learned clause.
+ *  as chronological backtracking makes the trail not sorted by level (out-of-order literals propagated on a lower level than the current one), the
+ *  literals of a level lower or equal to the targeted one found in the unwound part of the trail are kept (in order) on the trail.
  * @param ctx of the sat solver
  * @param level to backtrack to
  */
+template<typename Logging>
 void backtrack(solver_context& ctx, std::size_t level) {
-    log_debug("backtracking start :: from {} to {}", ctx.current_decision_level_, level);
+    if (debug_logged<Logging>()) {
+        log_debug("backtracking start :: from {} to {}", ctx.current_decision_level_, level);
+    }
+    if (level >= ctx.current_decision_level_) {
+        return;
+    }
+
+    // every literal assigned before the decision of a level is on a lower level : the unwinding stops at the first decision of the level following
+    // the targeted one, or at a decision of a kept level (the following level has no decision if it is an empty assumption level)
+    auto& kept = ctx.scratch_.kept;
+    kept.clear();
     while (!ctx.trail_.empty()) {
-        const auto& node = ctx.trail_.back();
-        auto soa_struct  = ctx.vars_soa_[node];
+        const auto node = ctx.trail_.back();
+        auto soa_struct = ctx.vars_soa_[node];
 
-        auto& [literal, assignment, assignment_context, compiler_context] = soa_struct;
+        auto& [literal, assignment, assignment_context, heuristics, compiler_context] = soa_struct;
 
+        const bool is_decision = assignment_context.is_decision();
         if (assignment_context.decision_level_ <= level) {
-            break;
+            if (is_decision) {
+                break;
+            }
+            kept.push_back(node); // out-of-order literal
+            ctx.trail_.pop_back();
+            continue;
         }
-        assignment                             = assignment::not_assigned;
-        assignment_context.clause_propagation_ = std::nullopt; // remove any propagation context from the assignment
+        const bool is_next_level_decision = is_decision && assignment_context.decision_level_ == level + 1;
+
+        heuristics.saved_phase_ = assignment; // phase saving : the variable is decided again on the same value
+        assignment              = assignment::not_assigned;
+        assignment_context.clear_reason(); // remove any propagation context from the assignment
         ctx.trail_.pop_back();
+
+        if (is_next_level_decision) {
+            break;
+        }
+    }
+    for (const auto node : kept | std::views::reverse) {
+        get<soa_assignment_ctx>(ctx.vars_soa_[node]).trail_position_ = static_cast<std::uint32_t>(ctx.trail_.size());
+        ctx.trail_.push_back(node);
     }
+    ++ctx.statistics_.backtracks;
     ctx.current_decision_level_ = level;
-    log_debug("backtracking end :: backtracked to level {} :: size trail {}", level, ctx.trail_.size());
+    if (debug_logged<Logging>()) {
+        log_debug("backtracking end :: backtracked to level {} :: size trail {}", level, ctx.trail_.size());
+    }
 }
 
-std::optional<Clauses_Soa::struct_id> unit_propagation(solver_context& ctx) {
-    std::optional<Clauses_Soa::struct_id> conflict;
-    [[maybe_unused]] auto propagate = [&](const auto& clause_struct) {
+void backtrack(solver_context& ctx, std::size_t level) { backtrack<debug_logging>(ctx, level); }
+
+template<typename Logging>
+std::optional<conflict_source> unit_propagation(solver_context& ctx) {
+    std::optional<conflict_source> conflict;
+    [[maybe_unused]] auto propagate = [&](std::uint32_t clause_index) {
         if (conflict.has_value())
             return false;
 
-        const auto& [clause, watchers, _] = clause_struct;
+        auto clause_struct                   = ctx.clauses_soa_[ctx.clause_ids_[clause_index]];
+        auto& [clause, watcher, _]           = clause_struct;
+        const auto& [blocker, blocker_varid] = watcher.blocker();
 
-        if (is_clause_satisfied(ctx, clause)) {
-            return false; // skip satisfied clause
+        if (is_literal_satisfied(ctx, blocker, blocker_varid)) {
+            return false; // skip satisfied clause : the blocker is checked without reading the literals of the clause
         }
 
-        const auto& clauselit_mapped_varid = clause.get_literals();
-        const auto unassigned              = std::ranges::fold_left(clauselit_mapped_varid,
-            std::vector<std::pair<literal, Vars_Soa::struct_id>> {}, //
-            [&ctx, &clause_struct](std::vector<std::pair<literal, Vars_Soa::struct_id>> res, const auto& pair) {
-                const auto clause_var_id                                    = pair.second;
-                const auto& [literal, assignment, assignment_context, meta] = ctx.vars_soa_[clause_var_id];
-                if (assignment != assignment::not_assigned) {
-                    return res;
+        // only the number of unassigned literals matters (0 is a conflict, 1 a propagation) : the scan stops at the second one, or at a satisfied
+        // literal that becomes the blocker of the clause
+        const auto& clauselit_mapped_varid                        = clause.get_literals();
+        std::size_t unassigned_count                              = 0;
+        const std::pair<literal, Vars_Soa::struct_id>* unassigned = nullptr;
+        for (const auto& pair : clauselit_mapped_varid) {
+            const auto value = get<soa_assignment>(ctx.vars_soa_[pair.second]);
+            if (value == assignment::not_assigned) {
+                unassigned = &pair;
+                if (++unassigned_count > 1) {
+                    return false;
                 }
-                res.push_back(pair);
-                return res;
-            });
+            } else if ((value == assignment::on) == pair.first.is_on()) {
+                watcher.set_blocker(pair);
+                return false; // skip satisfied clause
+            }
+        }
 
-        if (unassigned.empty()) {
+        if (unassigned_count == 0) {
             // if (has_conflict(ctx, clause)) {
-            conflict = clause_struct.struct_id(); // no literal is assigned : conflict detected
-            log_debug("conflict found :: {}", to_string(clause));
+            conflict = conflict_source {.clause = clause_index}; // no literal is assigned : conflict detected
+            if (debug_logged<Logging>()) {
+                log_debug("conflict found :: {}", to_string(clause));
+            }
             return false;
         }
 
-        if (unassigned.size() == 1) {
-            const auto& [unassigned_clauselit, unassigned_varid]  = unassigned.front();
+        if (unassigned_count == 1) {
+            const auto& [unassigned_clauselit, unassigned_varid]  = *unassigned;
             auto unassigned_soa_struct                            = ctx.vars_soa_[unassigned_varid];
-            auto& [literal, assignment, assignment_context, meta] = unassigned_soa_struct;
+            auto& [literal, assignment, assignment_context, heuristics, meta] = unassigned_soa_struct;
 
-            assignment                             = unassigned_clauselit.is_on() ? assignment::on : assignment::off; // set assignment of the propagation
-            assignment_context.decision_level_     = ctx.current_decision_level_;                                     // set decision level of the propagation
-            assignment_context.clause_propagation_ = clause_struct.struct_id(); // setup clause responsible for the propagation of the assignment
-            ctx.trail_.push_back(unassigned_varid);                             // add the propagation in the trail
+            assignment                         = unassigned_clauselit.is_on() ? assignment::on : assignment::off; // set assignment of the propagation
+            assignment_context.decision_level_ = static_cast<std::uint32_t>(implication_level(ctx, clauselit_mapped_varid | std::views::values));
+            assignment_context.trail_position_ = static_cast<std::uint32_t>(ctx.trail_.size());
+            assignment_context.set_clause_reason(clause_index); // setup clause responsible for the propagation of the assignment
+            ctx.trail_.push_back(unassigned_varid); // add the propagation in the trail
+            watcher.set_blocker(*unassigned);       // the propagated literal satisfies the clause
 
-            log_debug("propagate decision: level({}) on {} :: {} -> {} ", assignment_context.decision_level_, to_string(clause), literal.value(), to_string(assignment));
+            if (debug_logged<Logging>()) {
+                log_debug("propagate decision: level({}) on {} :: {} -> {} ", assignment_context.decision_level_, to_string(clause), literal.value(), to_string(assignment));
+            }
             return true;
         }
         return false;
     };
 
+    // a cardinality constraint is propagated by counting its true literals : when the bound is reached, every unassigned literal is made false
+    [[maybe_unused]] auto propagate_cardinality = [&](std::uint32_t cardinality_index) {
+        if (conflict.has_value())
+            return false;
+
+        const auto& card = get<soa_cardinality>(ctx.cardinalities_soa_[ctx.cardinality_ids_[cardinality_index]]);
+
+        std::size_t true_count = 0;
+        auto& unassigned       = ctx.scratch_.unassigned;
+        unassigned.clear();
+        for (const auto& [lit, varid] : card.get_literals()) {
+            if (is_literal_satisfied(ctx, lit, varid)) {
+                ++true_count;
+            } else if (get<soa_assignment>(ctx.vars_soa_[varid]) == assignment::not_assigned) {
+                unassigned.emplace_back(lit, varid);
+            }
+        }
+
+        if (true_count > card.bound()) {
+            conflict = conflict_source {.cardinality = cardinality_index}; // bound exceeded : conflict detected
+            if (debug_logged<Logging>()) {
+                log_debug("conflict found :: {}", to_string(card));
+            }
+            return false;
+        }
+        if (true_count < card.bound() || unassigned.empty()) {
+            return false;
+        }
+
+        const auto level = static_cast<std::uint32_t>(implication_level(ctx,
+            card.get_literals() | std::views::filter([&ctx](const auto& lit) { return is_literal_satisfied(ctx, lit.first, lit.second); }) | std::views::values));
+        for (const auto& [card_lit, varid] : unassigned) {
+            auto soa_struct                                       = ctx.vars_soa_[varid];
+            auto& [literal, assignment, assignment_context, heuristics, meta] = soa_struct;
+
+            assignment                         = card_lit.is_on() ? assignment::off : assignment::on; // the literal is made false
+            assignment_context.decision_level_ = level;
+            assignment_context.trail_position_ = static_cast<std::uint32_t>(ctx.trail_.size());
+            assignment_context.set_cardinality_reason(cardinality_index);
+            ctx.trail_.push_back(varid);
+
+            if (debug_logged<Logging>()) {
+                log_debug("propagate decision: level({}) on {} :: {} -> {} ", assignment_context.decision_level_, to_string(card), literal.value(), to_string(assignment));
+            }
+        }
+        return true;
+    };
+
+    // the XOR engine looks for implications on the combination of its rows (Gauss-Jordan elimination), an implication is explained by the
+    // variables of the row that implied it
+    auto propagate_xors = [&]() -> std::size_t {
+        if (conflict.has_value() || ctx.xors_.empty())
+            return 0;
+
+        auto& implied = ctx.scratch_.implied;
+        if (ctx.xors_.propagate(ctx, implied)) {
+            conflict = conflict_source {.xors = true};
+            if (debug_logged<Logging>()) {
+                log_debug("conflict found :: XOR constraints");
+            }
+            return 0;
+        }
+        for (const auto& [variable, value] : implied) {
+            auto soa_struct                                                   = ctx.vars_soa_[ctx.var_ids_[variable]];
+            auto& [literal, assignment, assignment_context, heuristics, meta] = soa_struct;
+
+            assignment                         = value ? assignment::on : assignment::off;
+            assignment_context.decision_level_ = static_cast<std::uint32_t>(
+                implication_level(ctx, ctx.xors_.reason(variable) | std::views::transform([&ctx](std::uint32_t antecedent) { return ctx.var_ids_[antecedent]; })));
+            assignment_context.trail_position_ = static_cast<std::uint32_t>(ctx.trail_.size());
+            assignment_context.set_xor_reason(variable);
+            ctx.trail_.push_back(ctx.var_ids_[variable]);
+
+            if (debug_logged<Logging>()) {
+                log_debug("propagate decision: level({}) on XOR constraints :: {} -> {} ", assignment_context.decision_level_, literal.value(), to_string(assignment));
+            }
+        }
+        return implied.size();
+    };
+
     // execute propagation unit there is no propagation happening
     // propagate return the number of propagations that occurred on a single loop over the clauses, this is repeated in case of a cascade effect.
-    while (auto propagated_literal = std::ranges::count_if(ctx.clauses_soa_, propagate)) {
+    // constraints are iterated through their index in the constraint tables : the index is the reason recorded in the assignment context
+    const auto clause_indexes      = std::views::iota(std::uint32_t {0}, static_cast<std::uint32_t>(ctx.clause_ids_.size()));
+    const auto cardinality_indexes = std::views::iota(std::uint32_t {0}, static_cast<std::uint32_t>(ctx.cardinality_ids_.size()));
+    while (auto propagated_literal = std::ranges::count_if(clause_indexes, propagate) + std::ranges::count_if(cardinality_indexes, propagate_cardinality)
+                                     + static_cast<std::ptrdiff_t>(propagate_xors())) {
         if (conflict.has_value()) {
             break;
         }
@@ -275,84 +611,612 @@ std::optional<Clauses_Soa::struct_id> unit_propagation(solver_context& ctx) {
     return conflict;
 }
 
-void learn_additional_clause(solver_context& ctx, const clause& clause_learned) {
+/**
+ * @brief compute the LBD (Literal Block Distance) of a clause : the number of distinct decision levels among its literals
+ * @note must be called before backtracking as it relies on the decision level of the assigned literals
+ */
+std::size_t compute_lbd(solver_context& ctx, const clause& c) {
+    auto& levels = ctx.scratch_.levels;
+    levels.clear();
+    for (const auto& varid : c.get_literals() | std::views::values) {
+        levels.push_back(get<soa_assignment_ctx>(ctx.vars_soa_[varid]).decision_level_);
+    }
+    std::ranges::sort(levels);
+    return static_cast<std::size_t>(std::ranges::distance(levels.begin(), std::ranges::unique(levels).begin()));
+}
+
+/**
+ * @brief measure the memory used by the solver state into the statistics : variables, clauses (of the model and learned), watchers and trail
+ *
+ * The memory of a clause is its entry in the clause table and the capacity of its literals, the storage kept by the deleted clauses is counted
+ * as learned clause memory. The measure is an estimation of the live memory : the literals of the deleted clauses go back to the clause pool
+ * and are re-used for the next clauses instead of being released to the system.
+ */
+void measure_memory(solver_context& ctx) {
+    static constexpr std::size_t var_size    = sizeof(literal) + sizeof(assignment) + sizeof(assignment_context) + sizeof(variable_heuristics) + sizeof(metadata);
+    static constexpr std::size_t clause_size = sizeof(clause) + sizeof(metadata) + sizeof(Clauses_Soa::struct_id);
+    static constexpr std::size_t card_size   = sizeof(cardinality) + sizeof(metadata) + sizeof(Cardinalities_Soa::struct_id);
+    static constexpr std::size_t lit_size    = sizeof(std::pair<literal, Vars_Soa::struct_id>);
+
+    const auto learned        = ctx.learned_clause_mask();
+    std::size_t clause_bytes  = 0;
+    std::size_t learned_bytes = (ctx.clauses_soa_.size() - ctx.clause_ids_.size()) * (sizeof(clause) + sizeof(metadata)); // deleted clauses
+    for (std::size_t clause_index = 0; clause_index < ctx.clause_ids_.size(); ++clause_index) {
+        const auto bytes = clause_size + get<soa_clause>(ctx.clauses_soa_[ctx.clause_ids_[clause_index]]).get_literals().capacity() * lit_size;
+        (learned[clause_index] ? learned_bytes : clause_bytes) += bytes;
+    }
+    clause_bytes += std::ranges::fold_left(ctx.cardinalities_soa_, std::size_t {0}, [](std::size_t res, const auto& card_struct) { //
+        return res + card_size + get<soa_cardinality>(card_struct).get_literals().capacity() * lit_size;
+    });
+
+    auto& stats                = ctx.statistics_;
+    stats.clause_bytes         = clause_bytes;
+    stats.learned_clause_bytes = learned_bytes + ctx.learned_clauses_.capacity() * sizeof(learned_clause_entry);
+    stats.watcher_bytes        = ctx.clauses_soa_.size() * sizeof(clause_watcher);
+    stats.trail_bytes          = ctx.trail_.capacity() * sizeof(Vars_Soa::struct_id);
+    stats.memory_bytes         = ctx.vars_soa_.size() * var_size + stats.clause_bytes + stats.learned_clause_bytes + stats.watcher_bytes + stats.trail_bytes;
+    stats.peak_memory_bytes    = std::max(stats.peak_memory_bytes, stats.memory_bytes);
+}
+
+/**
+ * @brief report the progress of the solver : either through the configured progress callback, or by logging the statistics
+ */
+void report_progress(solver_context& ctx) {
+    ctx.statistics_.trail_depth = ctx.trail_.size();
+    measure_memory(ctx);
+
+    if (ctx.config_.progress_callback) {
+        ctx.config_.progress_callback(ctx.statistics_);
+        return;
+    }
+    log_info("progress :: {}", to_string(ctx.statistics_));
+}
+
+/**
+ * @return literals of the clause expressed with the variables of the model, as written in the proof
+ */
+auto to_proof_literals(const solver_context& ctx, const clause_literals& literals) {
+    return literals | std::views::keys | std::views::transform([&ctx](const literal& lit) {
+        const auto external = ctx.variables_->to_external(lit);
+        return external.is_off() ? -external.value() : external.value();
+    });
+}
+
+/**
+ * @brief write a clause learned by the solver into the DRAT proof of the resolution (if enabled), with the variables of the model
+ */
+void prove_lemma(solver_context& ctx, const clause_literals& literals) {
+    if (ctx.proof_ != nullptr) {
+        ctx.proof_->add(to_proof_literals(ctx, literals));
+    }
+}
+
+/**
+ * @brief write the deletion of a learned clause into the DRAT proof of the resolution (if enabled)
+ */
+void prove_deletion(solver_context& ctx, const clause_literals& literals) {
+    if (ctx.proof_ != nullptr) {
+        ctx.proof_->remove(to_proof_literals(ctx, literals));
+    }
+}
+
+/**
+ * @brief conclude the DRAT proof of the resolution (if enabled) by the empty clause : the model is unsatisfiable
+ */
+void prove_unsatisfiable(solver_context& ctx) {
+    if (ctx.proof_ != nullptr) {
+        ctx.proof_->add(std::span<const std::int64_t> {});
+    }
+}
+
+template<typename Logging>
+void learn_additional_clause(solver_context& ctx, clause&& clause_learned) {
     if (clause_learned.is_empty()) {
-        log_debug("learned clause is empty, the solver is unsatisfiable", SECTION);
+        if (debug_logged<Logging>()) {
+            log_debug("learned clause is empty, the solver is unsatisfiable", SECTION);
+        }
         return;
     }
-    log_debug("learned clause: {}", to_string(clause_learned));
-    [[maybe_unused]] const auto _ = ctx.clauses_soa_.insert(clause_learned, clause_watcher {ctx.vars_soa_, clause_learned}, metadata {/*@todo: add compiler context from model*/});
+    if (debug_logged<Logging>()) {
+        log_debug("learned clause: {}", to_string(clause_learned));
+    }
+    prove_lemma(ctx, clause_learned.get_literals());
+    const auto lbd = compute_lbd(ctx, clause_learned);
+    ctx.statistics_.learned_lbd_sum += lbd;
+    clause_watcher watcher {ctx.vars_soa_, clause_learned};
+    ctx.learned_clauses_.push_back({.clause_index = static_cast<std::uint32_t>(ctx.clause_ids_.size()), .lbd = static_cast<std::uint32_t>(lbd)});
+    ctx.clause_ids_.push_back(ctx.clauses_soa_.insert(std::move(clause_learned), std::move(watcher), metadata {/*@todo: add compiler context from model*/}));
     ++ctx.statistics_.learned_clause;
 }
 
-bool make_decision(solver_context& ctx) {
+/**
+ * @brief delete the half of the learned clauses of highest LBD from the clause database
+ *
+ * The clauses of LBD lower or equal to the glue LBD are kept, as well as the clauses that are the reason of an assignment of the trail (the
+ * conflict analysis needs their explanation). The clause table is compacted : the reasons recorded in the assignment contexts and the learned
+ * clause entries are renumbered, the literals of the deleted clauses go back to the clause pool.
+ *
+ * @param ctx solving context
+ * @param glue_lbd LBD up to which a learned clause is never deleted
+ * @return number of learned clauses deleted
+ */
+std::size_t reduce_learned_clauses(solver_context& ctx, std::uint32_t glue_lbd) {
+    std::vector<bool> locked(ctx.clause_ids_.size(), false);
+    for (const auto varid : ctx.trail_) {
+        if (const auto& assign_ctx = get<soa_assignment_ctx>(ctx.vars_soa_[varid]); assign_ctx.has_clause_reason()) {
+            locked[assign_ctx.clause_reason()] = true;
+        }
+    }
+
+    // the clauses of highest LBD are deleted first, the oldest first on equal LBD
+    std::vector<learned_clause_entry> deletions;
+    std::ranges::copy_if(ctx.learned_clauses_, std::back_inserter(deletions), [&locked, glue_lbd](const learned_clause_entry& entry) { //
+        return entry.lbd > glue_lbd && !locked[entry.clause_index];
+    });
+    std::ranges::stable_sort(deletions, std::ranges::greater {}, &learned_clause_entry::lbd);
+    deletions.resize(deletions.size() / 2);
+    if (deletions.empty()) {
+        return 0;
+    }
+
+    std::vector<bool> deleted(ctx.clause_ids_.size(), false);
+    for (const auto& entry : deletions) {
+        deleted[entry.clause_index] = true;
+        auto& deleted_clause        = get<soa_clause>(ctx.clauses_soa_[ctx.clause_ids_[entry.clause_index]]);
+        prove_deletion(ctx, deleted_clause.get_literals());
+        deleted_clause = clause {clause_literals {ctx.clause_allocator()}}; // the storage of the clause is kept empty
+    }
+
+    std::vector<std::uint32_t> renumbering(ctx.clause_ids_.size(), 0);
+    std::uint32_t kept = 0;
+    for (std::uint32_t clause_index = 0; clause_index < ctx.clause_ids_.size(); ++clause_index) {
+        if (!deleted[clause_index]) {
+            renumbering[clause_index] = kept;
+            ctx.clause_ids_[kept++]   = ctx.clause_ids_[clause_index];
+        }
+    }
+    ctx.clause_ids_.resize(kept);
+    std::erase_if(ctx.learned_clauses_, [&deleted](const learned_clause_entry& entry) { return deleted[entry.clause_index]; });
+    for (auto& entry : ctx.learned_clauses_) {
+        entry.clause_index = renumbering[entry.clause_index];
+    }
+    for (const auto varid : ctx.trail_) {
+        if (auto& assign_ctx = get<soa_assignment_ctx>(ctx.vars_soa_[varid]); assign_ctx.has_clause_reason()) {
+            assign_ctx.set_clause_reason(renumbering[assign_ctx.clause_reason()]);
+        }
+    }
+    ctx.packed_clauses_.clear();
+
+    ++ctx.statistics_.reductions;
+    ctx.statistics_.deleted_clause += deletions.size();
+    log_debug("reduction of the learned clauses :: {} deleted, {} kept", deletions.size(), ctx.learned_clauses_.size());
+    return deletions.size();
+}
+
+/**
+ * @brief measure the memory of the solver against the memory limit of the configuration : above the limit, the learned clauses are reduced
+ * without keeping the glue clauses (only the reasons of the trail are kept) until the memory is back under the limit
+ * @return true if the memory used by the solver is under the limit, false if the reductions could not bring it back under the limit
+ */
+bool enforce_memory_limit(solver_context& ctx) {
+    measure_memory(ctx);
+    while (ctx.statistics_.memory_bytes > ctx.config_.memory_limit) {
+        if (reduce_learned_clauses(ctx, 0) == 0) {
+            return false;
+        }
+        ++ctx.statistics_.memory_reductions;
+        measure_memory(ctx);
+    }
+    return true;
+}
+
+/**
+ * @brief compute the subset of the assumptions responsible for the falsification of a failed assumption
+ *
+ * The implication graph is walked back from the failed assumption variable, every decision reached (which are all assumptions, as the
+ * assumptions are decided on the first decision levels) is part of the core.
+ *
+ * @param ctx solving context in which the assumption failed
+ * @param failed_assumption assumption literal found to be false when trying to decide it
+ * @param failed_varid variable of the failed assumption
+ * @return unsat core : subset of the assumptions that cannot be satisfied together
+ */
+std::vector<literal> analyze_final(const solver_context& ctx, literal failed_assumption, Vars_Soa::struct_id failed_varid) {
+    std::vector<literal> core {failed_assumption};
+
+    if (get<soa_assignment_ctx>(ctx.vars_soa_[failed_varid]).decision_level_ == 0) {
+        return core; // the assumption is falsified without any decision
+    }
+
+    std::vector<bool> seen(ctx.vars_soa_.size(), false);
+    seen[failed_varid.offset] = true;
+    reason_literals reason; // not a scratch buffer of the context : the analysis only happens once, when the resolution fails
+
+    for (const auto trail_varid : ctx.trail_ | std::views::reverse) {
+        if (!seen[trail_varid.offset]) {
+            continue;
+        }
+        const auto& assign_ctx = get<soa_assignment_ctx>(ctx.vars_soa_[trail_varid]);
+        if (assign_ctx.decision_level_ == 0) {
+            continue;
+        }
+        if (assign_ctx.is_decision()) {
+            const auto assumption_it = std::ranges::find_if(ctx.assumptions_, [&trail_varid](const auto& assumption) { //
+                return assumption.second.offset == trail_varid.offset;
+            });
+            if (assumption_it != ctx.assumptions_.end() && trail_varid.offset != failed_varid.offset) {
+                core.push_back(assumption_it->first);
+            }
+            continue;
+        }
+        explain(ctx, trail_varid, reason);
+        for (const auto& reason_varid : reason | std::views::values) {
+            if (get<soa_assignment_ctx>(ctx.vars_soa_[reason_varid]).decision_level_ > 0) {
+                seen[reason_varid.offset] = true;
+            }
+        }
+    }
+    log_debug("assumption {} failed :: unsat core of size {}", to_string(failed_assumption), core.size());
+    return core;
+}
+
+enum class assumption_decision {
+    none,    //!< every assumption is already decided
+    decided, //!< an assumption has been decided
+    failed,  //!< an assumption is falsified by the previous ones : unsatisfiable under assumptions
+};
+
+/**
+ * @brief decide the next assumption (if any left), each assumption is decided on its own decision level
+ * @note if the assumption is already satisfied, an empty decision level is created to keep the level/assumption correspondence
+ */
+assumption_decision decide_assumption(solver_context& ctx) {
+    while (ctx.current_decision_level_ < ctx.assumptions_.size()) {
+        const auto& [assumption, varid] = ctx.assumptions_[ctx.current_decision_level_];
+        const auto expected             = assumption.is_on() ? assignment::on : assignment::off;
+
+        auto soa_struct                                               = ctx.vars_soa_[varid];
+        auto& [lit, assignment, assignment_context, heuristics, meta] = soa_struct;
+
+        if (assignment == expected) {
+            ++ctx.current_decision_level_; // already satisfied
+            continue;
+        }
+        if (assignment != assignment::not_assigned) {
+            ctx.unsat_core_ = analyze_final(ctx, assumption, varid);
+            return assumption_decision::failed;
+        }
+
+        ++ctx.current_decision_level_;
+        ctx.statistics_.max_decision_lvl = std::max(ctx.statistics_.max_decision_lvl, ctx.current_decision_level_);
+        ++ctx.statistics_.decisions;
+
+        assignment_context.decision_level_ = static_cast<std::uint32_t>(ctx.current_decision_level_);
+        assignment_context.trail_position_ = static_cast<std::uint32_t>(ctx.trail_.size());
+        assignment                         = expected;
+        ctx.trail_.push_back(varid);
+
+        log_debug("assumption decision: level({}) :: {} -> {}", ctx.current_decision_level_, lit.value(), to_string(assignment));
+        return assumption_decision::decided;
+    }
+    return assumption_decision::none;
+}
+
+/**
+ * @brief decide the variable on a new decision level, on its saved phase
+ */
+template<typename Logging>
+void decide(solver_context& ctx, auto soa_struct) {
+    ++ctx.current_decision_level_;
+    ctx.statistics_.max_decision_lvl = std::max(ctx.statistics_.max_decision_lvl, ctx.current_decision_level_);
+    ++ctx.statistics_.decisions;
+
+    auto& [lit, assignment, assignment_context, heuristics, meta] = soa_struct;
+
+    assignment_context.decision_level_ = static_cast<std::uint32_t>(ctx.current_decision_level_);
+    assignment_context.trail_position_ = static_cast<std::uint32_t>(ctx.trail_.size());
+    assignment                         = heuristics.saved_phase_;
+
+    if (debug_logged<Logging>()) {
+        log_debug("make decision: level({}) :: {} -> {}", ctx.current_decision_level_, lit.value(), to_string(assignment));
+    }
+    ctx.trail_.push_back(soa_struct.struct_id());
+}
+
+/**
+ * @brief decide the unassigned variable of highest VSIDS activity
+ * @return false if every variable is assigned
+ */
+template<typename Logging>
+bool make_decision(solver_context& ctx, vsids_decision) {
     auto unassigned_vars = //
         std::ranges::views::filter(ctx.vars_soa_, [](const auto& var) { return get<soa_assignment>(var) == assignment::not_assigned; });
 
     if (unassigned_vars.empty()) {
-        log_debug("no unassigned variable found");
+        if (debug_logged<Logging>()) {
+            log_debug("no unassigned variable found");
+        }
         return false;
     }
 
     auto var_highest_vsids = std::ranges::max_element(
-        unassigned_vars, [](const auto& rhs, const auto& lhs) { return get<soa_assignment_ctx>(rhs).vsids_activity_ < get<soa_assignment_ctx>(lhs).vsids_activity_; });
+        unassigned_vars, [](const auto& rhs, const auto& lhs) { return get<soa_var_heuristics>(rhs).vsids_activity_ < get<soa_var_heuristics>(lhs).vsids_activity_; });
+    decide<Logging>(ctx, *var_highest_vsids);
+    return true;
+}
 
-    ++ctx.current_decision_level_;
-    ctx.statistics_.max_decision_lvl = std::max(ctx.statistics_.max_decision_lvl, ctx.current_decision_level_);
-    ++ctx.statistics_.decisions;
+/**
+ * @brief decide the first unassigned variable
+ * @return false if every variable is assigned
+ */
+template<typename Logging>
+bool make_decision(solver_context& ctx, ordered_decision) {
+    const auto first_unassigned = std::ranges::find_if(ctx.vars_soa_, [](const auto& var) { return get<soa_assignment>(var) == assignment::not_assigned; });
+    if (first_unassigned == ctx.vars_soa_.end()) {
+        if (debug_logged<Logging>()) {
+            log_debug("no unassigned variable found");
+        }
+        return false;
+    }
+    decide<Logging>(ctx, *first_unassigned);
+    return true;
+}
 
-    auto s                                            = *var_highest_vsids;
-    auto& [lit, assignment, assignment_context, meta] = s;
+/**
+ * @brief bump the heuristic state of the variables of the clause learned on a conflict
+ */
+void on_learned(solver_context& ctx, const clause& learned_clause, vsids_decision) { update_vsids_activity(ctx, learned_clause); }
+void on_learned(solver_context&, const clause&, ordered_decision) {}
 
-    assignment_context.decision_level_ = ctx.current_decision_level_;
-    assignment                         = assignment::on;
+/**
+ * @brief reset the saved phases of the variables from the best assignment found by a local search seeded with the current saved phases
+ * @note the local search works on the model clauses (learned clauses are implied by them), it is bounded by the configured number of flips
+ */
+void rephase(solver_context& ctx, const solve_limits& limits) {
+    std::vector<literal> phases;
+    phases.reserve(ctx.vars_soa_.size());
+    for (const auto& soa_struct : ctx.vars_soa_) {
+        const auto var = get<soa_literal>(soa_struct).value();
+        phases.emplace_back(get<soa_var_heuristics>(soa_struct).saved_phase_ == assignment::on ? var : -var);
+    }
 
-    log_debug("make decision: level({}) :: {} -> {}", ctx.current_decision_level_, lit.value(), to_string(assignment));
-    ctx.trail_.push_back((*var_highest_vsids).struct_id());
+    local_search search {
+        ctx,
+        local_search_configuration {.max_flips = ctx.config_.rephase_max_flips, .max_tries = 1, .seed = ctx.statistics_.restarts}
+    };
+    [[maybe_unused]] const auto _ = search.search(phases, limits);
 
-    return true;
+    std::ranges::for_each(ctx.vars_soa_, [&search](auto soa_struct) {
+        auto& [lit, assignment, assignment_context, heuristics, meta] = soa_struct;
+        if (const auto phase = search.best_phase(lit); phase.has_value()) {
+            heuristics.saved_phase_ = phase.value();
+        }
+    });
+    ++ctx.statistics_.rephases;
+    log_debug("rephasing :: saved phases reset from a local search assignment falsifying {} clauses", search.best_falsified_count());
+}
+
+/**
+ * @brief compute the level to restart to while re-using the trail
+ *
+ * After a restart the solver would take again the decisions whose variable activity is higher than the best unassigned variable. Those levels
+ * are kept instead of being unwound and propagated again : the restart goes back to the first level whose decision has a lower activity than
+ * the best unassigned variable (assumption levels are always kept as they would be decided again identically).
+ *
+ * @return level to backtrack to for the restart
+ */
+std::size_t restart_level(const solver_context& ctx, vsids_decision) {
+    if (!ctx.config_.restart_trail_reuse) {
+        return 0;
+    }
+    auto unassigned_vars = std::ranges::views::filter(ctx.vars_soa_, [](const auto& var) { return get<soa_assignment>(var) == assignment::not_assigned; });
+    if (unassigned_vars.empty()) {
+        return 0;
+    }
+    const auto best_activity = std::ranges::max(unassigned_vars | std::views::transform([](const auto& var) { //
+        return get<soa_var_heuristics>(var).vsids_activity_;
+    }));
+
+    for (const auto varid : ctx.trail_) {
+        const auto var_struct  = ctx.vars_soa_[varid];
+        const auto& assign_ctx = get<soa_assignment_ctx>(var_struct);
+        if (assign_ctx.is_decision() && assign_ctx.decision_level_ > ctx.assumptions_.size() && get<soa_var_heuristics>(var_struct).vsids_activity_ < best_activity) {
+            return assign_ctx.decision_level_ - 1;
+        }
+    }
+    return ctx.current_decision_level_;
+}
+
+/**
+ * @brief compute the level to restart to while re-using the trail with the ordered decisions : the levels whose decision comes before the first
+ * unassigned variable would be decided again identically
+ */
+std::size_t restart_level(const solver_context& ctx, ordered_decision) {
+    if (!ctx.config_.restart_trail_reuse) {
+        return 0;
+    }
+    const auto first_unassigned = std::ranges::find_if(ctx.vars_soa_, [](const auto& var) { return get<soa_assignment>(var) == assignment::not_assigned; });
+    if (first_unassigned == ctx.vars_soa_.end()) {
+        return 0;
+    }
+    const auto first_unassigned_offset = (*first_unassigned).struct_id().offset;
+    for (const auto varid : ctx.trail_) {
+        const auto& assign_ctx = get<soa_assignment_ctx>(ctx.vars_soa_[varid]);
+        if (assign_ctx.is_decision() && assign_ctx.decision_level_ > ctx.assumptions_.size() && varid.offset > first_unassigned_offset) {
+            return assign_ctx.decision_level_ - 1;
+        }
+    }
+    return ctx.current_decision_level_;
+}
+
+/**
+ * @return the i-th term of the Luby sequence (1, 1, 2, 1, 1, 2, 4, 1, ...), starting at 0
+ */
+std::size_t luby(std::size_t index) {
+    std::size_t size     = 1;
+    std::size_t exponent = 0;
+    while (size < index + 1) {
+        ++exponent;
+        size = 2 * size + 1;
+    }
+    while (size - 1 != index) {
+        size = (size - 1) >> 1;
+        --exponent;
+        index %= size;
+    }
+    return std::size_t {1} << exponent;
+}
+
+/**
+ * @return true if the search has to be restarted
+ */
+bool should_restart(const solver_context& ctx, geometric_restart) { return ctx.conflict_count_since_last_restart_ >= ctx.config_.restart_threshold; }
+template<std::size_t Unit>
+bool should_restart(const solver_context& ctx, luby_restart<Unit>) {
+    return ctx.conflict_count_since_last_restart_ >= Unit * luby(ctx.statistics_.restarts);
 }
+constexpr bool should_restart(const solver_context&, no_restart) { return false; }
+
+/**
+ * @brief update the restart policy once the search has been restarted
+ */
+void on_restart(solver_context& ctx, geometric_restart) { ctx.config_.restart_threshold *= ctx.config_.restart_multiplier; }
+template<std::size_t Unit>
+void on_restart(solver_context&, luby_restart<Unit>) {}
+void on_restart(solver_context&, no_restart) {}
+
+/**
+ * @brief reduce the learned clauses if the deletion policy requires it (checked after each conflict)
+ */
+void reduce(solver_context&, keep_learned_clauses) {}
+void reduce(solver_context& ctx, configured_deletion) {
+    if (ctx.config_.reduce_interval > 0 && ctx.statistics_.conflicts % ctx.config_.reduce_interval == 0) {
+        reduce_learned_clauses(ctx, ctx.config_.reduce_glue_lbd);
+    }
+}
+template<std::size_t Interval, std::uint32_t GlueLbd>
+void reduce(solver_context& ctx, lbd_deletion<Interval, GlueLbd>) {
+    if (ctx.statistics_.conflicts % Interval == 0) {
+        reduce_learned_clauses(ctx, GlueLbd);
+    }
+}
+
+/**
+ * @brief search loop of the CDCL specialized on a set of policies (see solver_policies.hh)
+ */
+template<typename Policies>
+std::expected<solver::result, sat_error> search(solver_context& ctx, const model& model, const solve_limits& limits) {
+    elapsed_time_recorder elapsed_recorder {ctx};
+    limits_checker limits_check {ctx, limits};
+
+    using logging  = typename Policies::logging;
+    using restart  = typename Policies::restart;
+    using decision = typename Policies::decision;
+
+    // start the resolution from the top level : previous resolutions and added clauses must not interfere with the search
+    backtrack<logging>(ctx, 0);
+    ctx.unsat_core_.clear();
+
+    // first rephasing before any search : on loosely constrained problems the local search assignment is often already a solution
+    if (ctx.config_.local_search_rephasing && ctx.statistics_.rephases == 0) {
+        rephase(ctx, limits);
+    }
+
+    if (ctx.config_.memory_limit > 0 && !enforce_memory_limit(ctx)) {
+        log_warn("memory limit of {} bytes exceeded by the model ({} bytes), result unknown", ctx.config_.memory_limit, ctx.statistics_.memory_bytes);
+        return std::unexpected(sat_error::unknown);
+    }
 
-std::expected<solver::result, sat_error> solve_sat(solver_context& ctx, const model& model) {
     solver::result solution;
     while (solution.literals.empty()) {
-        if (ctx.conflict_count_since_last_restart_ >= ctx.config_.restart_threshold) {
+        if (limits_check.reached(ctx)) {
+            log_info("resolution stopped by the solving limits, result unknown");
+            return std::unexpected(sat_error::unknown);
+        }
+
+        if (should_restart(ctx, restart {})) {
             ctx.conflict_count_since_last_restart_ = 0;
             ++ctx.statistics_.restarts;
 
-            // Restart by backtracking to decision level 0
-            backtrack(ctx, 0);
+            // Restart by backtracking to decision level 0 (or to the first level that would not be decided again when re-using the trail)
+            const auto level = restart_level(ctx, decision {});
+            ctx.statistics_.reused_levels += level;
+            backtrack<logging>(ctx, level);
 
-            // Update the restart threshold for the next restart
-            ctx.config_.restart_threshold *= ctx.config_.restart_multiplier;
+            // Update the restart policy for the next restart
+            on_restart(ctx, restart {});
+
+            if (ctx.config_.local_search_rephasing && ctx.statistics_.restarts % ctx.config_.rephase_interval == 0) {
+                rephase(ctx, limits);
+            }
         }
 
-        if (const auto conflict = unit_propagation(ctx); conflict.has_value()) {
+        const auto conflict             = unit_propagation<logging>(ctx);
+        ctx.statistics_.max_trail_depth = std::max(ctx.statistics_.max_trail_depth, ctx.trail_.size());
+
+        if (conflict.has_value()) {
             ++ctx.conflict_count_since_last_restart_;
             ++ctx.statistics_.conflicts;
-            const auto& [learned_clause, backtrack_level] = resolve_conflict(ctx, ctx.clauses_soa_[conflict.value()]);
 
-            if (ctx.current_decision_level_ == 0 && backtrack_level == 0) {
+            if (ctx.config_.progress_interval > 0 && ctx.statistics_.conflicts % ctx.config_.progress_interval == 0) {
+                elapsed_recorder.update();
+                report_progress(ctx);
+            }
+            auto& conflict_literals = ctx.scratch_.conflict;
+            explain_conflict(ctx, conflict.value(), conflict_literals);
+
+            // with out-of-order literals the conflict can be on a level lower than the current one : the analysis is done on the conflict level
+            const auto conflict_level = implication_level(ctx, conflict_literals | std::views::values);
+            if (conflict_level == 0) {
                 log_info("Conflict found on level 0, unsatisfiable");
+                prove_unsatisfiable(ctx);
                 return std::unexpected(sat_error::unsatisfiable);
             }
+            backtrack<logging>(ctx, conflict_level);
+
+            auto [learned_clause, backtrack_level] = resolve_conflict<logging>(ctx, conflict_literals);
 
             if (learned_clause.is_empty()) {
                 log_info("Conflict resolved into an empty clause, unsatisfiable");
+                prove_unsatisfiable(ctx);
                 return std::unexpected(sat_error::unsatisfiable);
             }
-            learn_additional_clause(ctx, learned_clause);
-            backtrack(ctx, backtrack_level);
-            update_vsids_activity(ctx, learned_clause);
+            on_learned(ctx, learned_clause, decision {});
+            learn_additional_clause<logging>(ctx, std::move(learned_clause));
+
+            // chronological backtracking : on a long backjump only the conflict level is unwound, the learned clause becomes unit on a lower level
+            // and is propagated as an out-of-order literal, which saves the re-propagation of all the levels in between
+            const auto backjump_distance = ctx.current_decision_level_ - backtrack_level;
+            if (ctx.config_.chrono_backtrack_threshold > 0 && backjump_distance > ctx.config_.chrono_backtrack_threshold) {
+                ++ctx.statistics_.chrono_backtracks;
+                backtrack<logging>(ctx, ctx.current_decision_level_ - 1);
+            } else {
+                backtrack<logging>(ctx, backtrack_level);
+            }
+            reduce(ctx, typename Policies::deletion {});
+
+            const auto memory_check_interval = std::max<std::size_t>(ctx.config_.memory_check_interval, 1);
+            if (ctx.config_.memory_limit > 0 && ctx.statistics_.conflicts % memory_check_interval == 0 && !enforce_memory_limit(ctx)) {
+                log_warn("memory limit of {} bytes exceeded ({} bytes) after reducing the learned clauses, result unknown", ctx.config_.memory_limit,
+                    ctx.statistics_.memory_bytes);
+                return std::unexpected(sat_error::unknown);
+            }
 
         } else {
-            if (make_decision(ctx))
+            if (const auto assumption_decided = decide_assumption(ctx); assumption_decided != assumption_decision::none) {
+                if (assumption_decided == assumption_decision::failed) {
+                    log_info("assumptions cannot be satisfied, unsatisfiable under assumptions");
+                    return std::unexpected(sat_error::unsatisfiable);
+                }
+                continue;
+            }
+            if (make_decision<logging>(ctx, decision {}))
                 continue;
 
-            // no decision found, check if a solution is found
-            const bool is_sat_solved = std::ranges::all_of(ctx.clauses_soa_, fil::soa::index_select<soa_clause>([&ctx](const auto& clause) { //
-                return is_clause_satisfied(ctx, clause);
-            }));
+            // no decision found, check if a solution is found : the whole clause database is evaluated by the (SIMD) packed clause kernels
+            ctx.packed_clauses_.sync(ctx);
+            pack_assignment(ctx, ctx.scratch_.values);
+            const bool is_sat_solved = ctx.packed_clauses_.all_satisfied(ctx.scratch_.values);
             if (is_sat_solved) {
                 solution = std::ranges::fold_left(ctx.vars_soa_, solution, [](solver::result res, const auto& soa_struct) {
                     res.literals.emplace_back(                              //
@@ -368,4 +1232,24 @@ std::expected<solver::result, sat_error> solve_sat(solver_context& ctx, const mo
     return solution;
 }
 
+/**
+ * @brief dynamic dispatch of the resolution on the search loop specialized for the configured profile
+ * @note the trail depth and the memory of the statistics are measured at the end of the resolution (they are otherwise only measured on the
+ * progress reports)
+ */
+std::expected<solver::result, sat_error> solve_sat(solver_context& ctx, const model& model, const solve_limits& limits) {
+    auto res = [&] {
+        switch (ctx.config_.profile) {
+            case solver_profile::planning: return search<planning_policies>(ctx, model, limits);
+            case solver_profile::unsat_heavy: return search<unsat_heavy_policies>(ctx, model, limits);
+            case solver_profile::minimal: return search<minimal_policies>(ctx, model, limits);
+            case solver_profile::dynamic: break;
+        }
+        return search<dynamic_policies>(ctx, model, limits);
+    }();
+    ctx.statistics_.trail_depth = ctx.trail_.size();
+    measure_memory(ctx);
+    return res;
+}
+
 } // namespace fabko::compiler::sat::impl_details
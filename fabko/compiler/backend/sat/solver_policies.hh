@@ -0,0 +1,130 @@
+// Dual Licensing Either :
+// - AGPL
+// or
+// - Subscription license for commercial usage (without requirement of licensing propagation).
+//   please contact ballandfys@protonmail.com for additional information about this subscription commercial licensing.
+//
+// Created by FyS on 18/10/26. License 2022-2026
+//
+// In the case no license has been purchased for the use (modification or distribution in any way) of the software stack
+// the APGL license is applying.
+//
+
+#ifndef SOLVER_POLICIES_HH
+#define SOLVER_POLICIES_HH
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+namespace fabko::compiler::sat {
+
+//
+// Restart policies : when the search is restarted (see solver_context::configuration for the restart trail reuse)
+
+//! restart when the conflicts since the last restart reach the configured threshold, multiplied by the configured multiplier on each restart
+struct geometric_restart {};
+
+//! restart after Unit times the i-th term of the Luby sequence (1, 1, 2, 1, 1, 2, 4, ...) conflicts, i being the number of restarts
+template<std::size_t Unit>
+struct luby_restart {
+    static constexpr std::size_t unit = Unit;
+};
+
+//! never restart
+struct no_restart {};
+
+//
+// Decision policies : which variable is decided next (the value decided is always the saved phase of the variable)
+
+//! decide the unassigned variable of highest VSIDS activity, the variables of the learned clauses are bumped on each conflict
+struct vsids_decision {};
+
+//! decide the first unassigned variable (in the order of the model), no activity is maintained
+struct ordered_decision {};
+
+//
+// Clause deletion policies : which learned clauses are deleted from the clause database along the search
+
+//! every learned clause is kept
+struct keep_learned_clauses {};
+
+//! the learned clauses are reduced as configured (see solver_context::configuration::reduce_interval)
+struct configured_deletion {};
+
+//! every Interval conflicts, the half of the learned clauses of highest LBD is deleted (clauses of LBD up to GlueLbd are always kept)
+template<std::size_t Interval, std::uint32_t GlueLbd>
+struct lbd_deletion {
+    static constexpr std::size_t interval   = Interval;
+    static constexpr std::uint32_t glue_lbd = GlueLbd;
+};
+
+//
+// Logging policies : whether the debug messages of the search loop are compiled
+
+//! debug messages are logged if the logger allows it (checked at runtime)
+struct debug_logging {
+    static constexpr bool compiled = true;
+};
+
+//! debug messages of the search loop are compiled out
+struct silent_logging {
+    static constexpr bool compiled = false;
+};
+
+/**
+ * @brief set of policies the search loop of the solver is specialized on (see solve_sat in solver_impl.cpp)
+ *
+ * Each policy is a compile-time choice : the search loop instantiated on a set of policies has no runtime branch on the strategies it does
+ * not use, and the debug logging can be compiled out of the hot paths (propagation, conflict analysis and backtracking).
+ */
+template<typename Restart, typename Decision, typename Deletion, typename Logging>
+struct solver_policies {
+    using restart  = Restart;
+    using decision = Decision;
+    using deletion = Deletion;
+    using logging  = Logging;
+};
+
+//! policies following the runtime configuration of the solver, the default ones
+using dynamic_policies = solver_policies<geometric_restart, vsids_decision, configured_deletion, debug_logging>;
+//! policies for the models compiled from fabl : mostly satisfiable and enumerated incrementally, the learned clauses are kept between solutions
+using planning_policies = solver_policies<geometric_restart, vsids_decision, keep_learned_clauses, silent_logging>;
+//! policies for the hard unsatisfiable models : frequent restarts and a clause database kept small by its LBD
+using unsat_heavy_policies = solver_policies<luby_restart<100>, vsids_decision, lbd_deletion<2000, 2>, silent_logging>;
+//! policies for the small models : plain DPLL ordering with clause learning, nothing else
+using minimal_policies = solver_policies<no_restart, ordered_decision, keep_learned_clauses, silent_logging>;
+
+/**
+ * @brief pre-instantiated specializations of the search loop, selected at runtime through solver_context::configuration::profile
+ */
+enum class solver_profile {
+    dynamic,     //!< dynamic_policies
+    planning,    //!< planning_policies
+    unsat_heavy, //!< unsat_heavy_policies
+    minimal,     //!< minimal_policies
+};
+
+/**
+ * @return profile of the name ("dynamic", "planning", "unsat-heavy" or "minimal"), nothing if the name is unknown
+ */
+[[nodiscard]] constexpr std::optional<solver_profile> profile_from_name(std::string_view name) {
+    if (name == "dynamic") {
+        return solver_profile::dynamic;
+    }
+    if (name == "planning") {
+        return solver_profile::planning;
+    }
+    if (name == "unsat-heavy") {
+        return solver_profile::unsat_heavy;
+    }
+    if (name == "minimal") {
+        return solver_profile::minimal;
+    }
+    return std::nullopt;
+}
+
+} // namespace fabko::compiler::sat
+
+#endif // SOLVER_POLICIES_HH
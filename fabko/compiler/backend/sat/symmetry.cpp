@@ -0,0 +1,375 @@
+// Dual Licensing Either :
+// - AGPL
+// or
+// - Subscription license for commercial usage (without requirement of licensing propagation).
+//   please contact ballandfys@protonmail.com for additional information about this subscription commercial licensing.
+//
+// Created by FyS on 18/10/26. License 2022-2026
+//
+// In the case no license has been purchased for the use (modification or distribution in any way) of the software stack
+// the APGL license is applying.
+//
+
+#include <algorithm>
+#include <numeric>
+#include <optional>
+#include <ranges>
+#include <tuple>
+
+#include "common/logging.hh"
+
+#include "symmetry.hh"
+
+namespace fabko::compiler::sat {
+
+namespace {
+
+/**
+ * @brief graph of a model : a vertex per literal (positive literal of variable v is 2(v - 1), its negation 2(v - 1) + 1) followed by a vertex
+ * per constraint
+ */
+struct model_graph {
+    std::size_t variables {};
+    std::vector<std::vector<std::uint32_t>> adjacency;
+    std::vector<std::uint32_t> initial_colors; //!< literals are colored by polarity, constraints by kind and bounds
+};
+
+using coloring = std::vector<std::uint32_t>;
+
+//! sorted representation of a constraint : {kind, bounds..., sorted signed literals}
+using constraint_key = std::vector<std::int64_t>;
+
+std::uint32_t vertex_of(const literal& lit) { return static_cast<std::uint32_t>(2 * (lit.value() - 1) + (lit.is_off() ? 1 : 0)); }
+
+std::int64_t signed_value(const literal& lit) { return lit.is_off() ? -lit.value() : lit.value(); }
+
+constraint_key make_key(std::initializer_list<std::int64_t> header, const std::vector<literal>& literals, const std::function<std::int64_t(const literal&)>& map) {
+    constraint_key key {header};
+    const auto header_size = key.size();
+    std::ranges::transform(literals, std::back_inserter(key), map);
+    std::ranges::sort(key.begin() + static_cast<std::ptrdiff_t>(header_size), key.end());
+    return key;
+}
+
+/**
+ * @return sorted keys of the constraints of the model, the literals being mapped through 'map'
+ */
+std::vector<constraint_key> constraint_keys(const model& m, const std::function<std::int64_t(const literal&)>& map) {
+    std::vector<constraint_key> keys;
+    keys.reserve(m.clauses.size() + m.cardinalities.size() + m.xors.size());
+    for (const auto& clause : m.clauses) {
+        keys.push_back(make_key({0}, clause, map));
+    }
+    for (const auto& [literals, at_most, at_least] : m.cardinalities) {
+        keys.push_back(make_key({1, static_cast<std::int64_t>(at_most), at_least.has_value() ? static_cast<std::int64_t>(at_least.value()) : -1}, literals, map));
+    }
+    for (const auto& [literals, parity] : m.xors) {
+        keys.push_back(make_key({2, parity ? 1 : 0}, literals, map));
+    }
+    return keys;
+}
+
+/**
+ * @return true if every constraint of the model mapped through the permutation (image of each variable, indexed by variable - 1) is a
+ * constraint of the model
+ */
+bool maps_constraints(const model& m, const std::vector<constraint_key>& sorted_keys, const std::vector<std::int64_t>& image) {
+    const auto mapped = constraint_keys(m, [&image](const literal& lit) {
+        const auto var = image[static_cast<std::size_t>(lit.value() - 1)];
+        return lit.is_off() ? -var : var;
+    });
+    return std::ranges::all_of(mapped, [&sorted_keys](const constraint_key& key) { return std::ranges::binary_search(sorted_keys, key); });
+}
+
+model_graph make_graph(const model& m) {
+    model_graph g {.variables = m.literals.size(), .adjacency = {}, .initial_colors = {}};
+    const auto literal_vertices = 2 * g.variables;
+    g.adjacency.resize(literal_vertices + m.clauses.size() + m.cardinalities.size() + m.xors.size());
+    g.initial_colors.resize(g.adjacency.size());
+
+    for (std::uint32_t var = 0; var < g.variables; ++var) {
+        g.adjacency[2 * var].push_back(2 * var + 1);
+        g.adjacency[2 * var + 1].push_back(2 * var);
+        g.initial_colors[2 * var + 1] = 1;
+    }
+
+    // constraints are colored by their kind and bounds, the colors are numbered in the order of the sorted descriptions (canonical)
+    std::vector<std::tuple<std::int64_t, std::size_t, std::int64_t, std::int64_t>> descriptions;
+    auto link = [&g](std::size_t vertex, const std::vector<literal>& literals) {
+        for (const auto& lit : literals) {
+            fabko_assert(lit.value() >= 1 && static_cast<std::size_t>(lit.value()) <= g.variables, "a constraint cannot contains a non-defined literal");
+            g.adjacency[vertex].push_back(vertex_of(lit));
+            g.adjacency[vertex_of(lit)].push_back(static_cast<std::uint32_t>(vertex));
+        }
+    };
+    for (std::size_t i = 0; i < m.clauses.size(); ++i) {
+        link(literal_vertices + i, m.clauses[i]);
+        descriptions.emplace_back(0, m.clauses[i].size(), 0, 0);
+    }
+    for (std::size_t i = 0; i < m.cardinalities.size(); ++i) {
+        const auto& [literals, at_most, at_least] = m.cardinalities[i];
+        link(literal_vertices + m.clauses.size() + i, literals);
+        descriptions.emplace_back(1, literals.size(), static_cast<std::int64_t>(at_most), at_least.has_value() ? static_cast<std::int64_t>(at_least.value()) : -1);
+    }
+    for (std::size_t i = 0; i < m.xors.size(); ++i) {
+        const auto& [literals, parity] = m.xors[i];
+        link(literal_vertices + m.clauses.size() + m.cardinalities.size() + i, literals);
+        descriptions.emplace_back(2, literals.size(), parity ? 1 : 0, 0);
+    }
+
+    auto sorted = descriptions;
+    std::ranges::sort(sorted);
+    const auto [first, last] = std::ranges::unique(sorted);
+    sorted.erase(first, last);
+    for (std::size_t i = 0; i < descriptions.size(); ++i) {
+        g.initial_colors[literal_vertices + i] = static_cast<std::uint32_t>(2 + std::ranges::lower_bound(sorted, descriptions[i]) - sorted.begin());
+    }
+    return g;
+}
+
+std::size_t count_colors(const coloring& left, const coloring& right) {
+    std::vector<std::uint32_t> colors;
+    colors.reserve(left.size() + right.size());
+    colors.insert(colors.end(), left.begin(), left.end());
+    colors.insert(colors.end(), right.begin(), right.end());
+    std::ranges::sort(colors);
+    return static_cast<std::size_t>(std::ranges::distance(colors.begin(), std::ranges::unique(colors).begin()));
+}
+
+/**
+ * @brief refine jointly the colorings of two copies of the graph until they are stable (1-dimensional Weisfeiler-Leman) : a vertex is
+ * re-colored from its color and the colors of its neighbors, the new colors being numbered identically for both copies
+ * @return false if the colorings cannot be mapped onto each other (a color has a different number of vertices in the two copies)
+ */
+bool refine(const model_graph& g, coloring& left, coloring& right) {
+    std::vector<std::uint32_t> neighbors;
+    std::vector<std::pair<std::uint32_t, std::uint64_t>> signatures(2 * left.size());
+    auto signature_of = [&](const coloring& colors, std::size_t vertex) {
+        neighbors.clear();
+        for (const auto neighbor : g.adjacency[vertex]) {
+            neighbors.push_back(colors[neighbor]);
+        }
+        std::ranges::sort(neighbors);
+        std::uint64_t hash = 0xcbf29ce484222325ULL;
+        for (const auto color : neighbors) {
+            hash = (hash ^ color) * 0x100000001b3ULL;
+        }
+        return std::pair {colors[vertex], hash};
+    };
+
+    for (auto colors = count_colors(left, right);;) {
+        for (std::size_t v = 0; v < left.size(); ++v) {
+            signatures[v]               = signature_of(left, v);
+            signatures[left.size() + v] = signature_of(right, v);
+        }
+        auto sorted = signatures;
+        std::ranges::sort(sorted);
+        const auto [first, last] = std::ranges::unique(sorted);
+        sorted.erase(first, last);
+
+        std::vector<std::size_t> left_cells(sorted.size()), right_cells(sorted.size());
+        for (std::size_t v = 0; v < left.size(); ++v) {
+            left[v]  = static_cast<std::uint32_t>(std::ranges::lower_bound(sorted, signatures[v]) - sorted.begin());
+            right[v] = static_cast<std::uint32_t>(std::ranges::lower_bound(sorted, signatures[left.size() + v]) - sorted.begin());
+            ++left_cells[left[v]];
+            ++right_cells[right[v]];
+        }
+        if (left_cells != right_cells) {
+            return false;
+        }
+        if (sorted.size() == colors) {
+            return true;
+        }
+        colors = sorted.size();
+    }
+}
+
+/**
+ * @return the vertices of each color (indexed by color)
+ */
+std::vector<std::vector<std::uint32_t>> cells_of(const coloring& colors) {
+    std::vector<std::vector<std::uint32_t>> cells(*std::ranges::max_element(colors) + 1);
+    for (std::uint32_t v = 0; v < colors.size(); ++v) {
+        cells[colors[v]].push_back(v);
+    }
+    return cells;
+}
+
+/**
+ * @return image of each variable (indexed by variable - 1) of the permutation mapping the left coloring onto the right one, the cells that are
+ * not singletons are mapped identically
+ */
+std::vector<std::int64_t> to_permutation(const model_graph& g, const std::vector<std::vector<std::uint32_t>>& left_cells,
+    const std::vector<std::vector<std::uint32_t>>& right_cells) {
+    std::vector<std::int64_t> image(g.variables);
+    for (std::size_t color = 0; color < left_cells.size(); ++color) {
+        for (std::size_t i = 0; i < left_cells[color].size(); ++i) {
+            const auto from = left_cells[color][i];
+            const auto to   = left_cells[color].size() == 1 ? right_cells[color].front() : from;
+            if (from < 2 * g.variables && from % 2 == 0) {
+                image[from / 2] = to / 2 + 1;
+            }
+        }
+    }
+    return image;
+}
+
+/**
+ * @brief search for a symmetry mapping variable 'from' onto variable 'to' by individualization / refinement : the first vertex of the first
+ * non-singleton cell is individualized in both copies (on itself if possible, which completes the permutation with the identity on the part of
+ * the graph that is not affected), until the colorings are discrete or the non-singleton cells are identical in both copies
+ * @return image of each variable (indexed by variable - 1) if a symmetry has been found
+ */
+std::optional<std::vector<std::int64_t>> search_symmetry(
+    const model& m, const model_graph& g, const std::vector<constraint_key>& keys, const coloring& base, std::int64_t from, std::int64_t to) {
+    coloring left  = base;
+    coloring right = base;
+    auto individualize = [&](std::uint32_t left_vertex, std::uint32_t right_vertex) {
+        const auto color    = static_cast<std::uint32_t>(left.size()); // greater than any color of the refined colorings
+        left[left_vertex]   = color;
+        right[right_vertex] = color;
+        return refine(g, left, right);
+    };
+
+    if (!individualize(vertex_of(literal {from}), vertex_of(literal {to}))) {
+        return std::nullopt;
+    }
+    while (true) {
+        const auto left_cells  = cells_of(left);
+        const auto right_cells = cells_of(right);
+        const bool identical   = std::ranges::all_of(std::views::zip(left_cells, right_cells), [](const auto& cells) {
+            const auto& [left_cell, right_cell] = cells;
+            return left_cell.size() <= 1 || left_cell == right_cell;
+        });
+        if (identical) {
+            auto image = to_permutation(g, left_cells, right_cells);
+            if (maps_constraints(m, keys, image)) {
+                return image;
+            }
+        }
+
+        const auto cell = std::ranges::find_if(left_cells, [](const auto& vertices) { return vertices.size() > 1; });
+        if (cell == left_cells.end()) {
+            return std::nullopt; // discrete coloring that is not a symmetry
+        }
+        const auto vertex  = cell->front();
+        const auto& target = right_cells[static_cast<std::size_t>(cell - left_cells.begin())];
+        if (!individualize(vertex, std::ranges::binary_search(target, vertex) ? vertex : target.front())) {
+            return std::nullopt;
+        }
+    }
+}
+
+std::size_t find_orbit(std::vector<std::size_t>& orbits, std::size_t var) {
+    while (orbits[var] != var) {
+        orbits[var] = orbits[orbits[var]];
+        var         = orbits[var];
+    }
+    return var;
+}
+
+} // namespace
+
+std::vector<symmetry> find_symmetries(const model& m, std::size_t max_symmetries) {
+    std::vector<symmetry> res;
+    if (max_symmetries == 0 || m.literals.empty()) {
+        return res;
+    }
+
+    const auto g = make_graph(m);
+    auto keys    = constraint_keys(m, signed_value);
+    std::ranges::sort(keys);
+
+    coloring base  = g.initial_colors;
+    coloring right = g.initial_colors;
+    [[maybe_unused]] const auto _ = refine(g, base, right);
+
+    // variables known to be in the same orbit are not searched for again : the symmetry would be generated by the ones already found
+    std::vector<std::size_t> orbits(g.variables);
+    std::iota(orbits.begin(), orbits.end(), std::size_t {0});
+
+    for (std::size_t from = 0; from < g.variables; ++from) {
+        for (std::size_t to = from + 1; to < g.variables; ++to) {
+            if (res.size() >= max_symmetries) {
+                return res;
+            }
+            if (base[2 * from] != base[2 * to] || find_orbit(orbits, from) == find_orbit(orbits, to)) {
+                continue;
+            }
+            const auto image = search_symmetry(m, g, keys, base, static_cast<std::int64_t>(from + 1), static_cast<std::int64_t>(to + 1));
+            if (!image.has_value()) {
+                continue;
+            }
+            symmetry found;
+            for (std::size_t var = 0; var < g.variables; ++var) {
+                if (image.value()[var] != static_cast<std::int64_t>(var + 1)) {
+                    found.moved.emplace_back(static_cast<std::int64_t>(var + 1), image.value()[var]);
+                    orbits[find_orbit(orbits, var)] = find_orbit(orbits, static_cast<std::size_t>(image.value()[var] - 1));
+                }
+            }
+            res.push_back(std::move(found));
+        }
+    }
+    return res;
+}
+
+bool is_symmetry(const model& m, const symmetry& s) {
+    std::vector<std::int64_t> image(m.literals.size());
+    std::iota(image.begin(), image.end(), std::int64_t {1});
+    for (const auto& [var, to] : s.moved) {
+        if (var < 1 || to < 1 || static_cast<std::size_t>(var) > image.size() || static_cast<std::size_t>(to) > image.size()) {
+            return false;
+        }
+        image[static_cast<std::size_t>(var - 1)] = to;
+    }
+    auto sorted = image;
+    std::ranges::sort(sorted);
+    if (std::ranges::adjacent_find(sorted) != sorted.end()) {
+        return false; // not a permutation
+    }
+
+    auto keys = constraint_keys(m, signed_value);
+    std::ranges::sort(keys);
+    return maps_constraints(m, keys, image);
+}
+
+std::size_t add_symmetry_breaking(model& m, std::span<const symmetry> symmetries, std::size_t max_length, const std::function<literal()>& new_variable) {
+    const auto clauses_before = m.clauses.size();
+
+    for (const auto& s : symmetries) {
+        // positions compared are the moved variables (the fixed ones are always equal to their image), eq is the auxiliary variable stating
+        // that the previous positions are equal : eq_i <=> eq_{i-1} and x_i == y_i (eq_{-1} is true and omitted)
+        const auto length = std::min(max_length, s.moved.size());
+        std::optional<literal> eq;
+        for (std::size_t i = 0; i < length; ++i) {
+            const literal x {s.moved[i].first};
+            const literal y {s.moved[i].second};
+            auto when_equal = [&eq](std::vector<literal> clause) {
+                if (eq.has_value()) {
+                    clause.insert(clause.begin(), eq->negation());
+                }
+                return clause;
+            };
+
+            // x_i <= y_i if the previous positions are equal
+            m.clauses.push_back(when_equal({x.negation(), y}));
+            if (i + 1 == length) {
+                break;
+            }
+
+            const literal next = new_variable();
+            m.clauses.push_back(when_equal({x.negation(), y.negation(), next}));
+            m.clauses.push_back(when_equal({x, y, next}));
+            // the auxiliary variable is defined as an equivalence : it is a function of the variables of the model
+            if (eq.has_value()) {
+                m.clauses.push_back({next.negation(), eq.value()});
+            }
+            m.clauses.push_back({next.negation(), x.negation(), y});
+            m.clauses.push_back({next.negation(), x, y.negation()});
+            eq = next;
+        }
+    }
+    return m.clauses.size() - clauses_before;
+}
+
+} // namespace fabko::compiler::sat
@@ -0,0 +1,71 @@
+// Dual Licensing Either :
+// - AGPL
+// or
+// - Subscription license for commercial usage (without requirement of licensing propagation).
+//   please contact ballandfys@protonmail.com for additional information about this subscription commercial licensing.
+//
+// Created by FyS on 18/10/26. License 2022-2026
+//
+// In the case no license has been purchased for the use (modification or distribution in any way) of the software stack
+// the APGL license is applying.
+//
+
+#ifndef SYMMETRY_HH
+#define SYMMETRY_HH
+
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "solver.hh"
+
+namespace fabko::compiler::sat {
+
+/**
+ * @brief permutation of the variables of a model that maps the set of constraints (clauses, cardinality and XOR constraints) onto itself
+ */
+struct symmetry {
+    //! variables moved by the permutation and their image, by increasing variable (the other variables are fixed)
+    std::vector<std::pair<std::int64_t, std::int64_t>> moved;
+};
+
+/**
+ * @brief detect symmetries of a model (interchangeable agents, resources, pigeons...)
+ *
+ * The symmetries are the automorphisms of the graph made of a vertex per literal and per constraint (a constraint is linked to its literals,
+ * the two literals of a variable are linked together). Candidate automorphisms mapping a variable to another one are built by
+ * individualization / refinement of the colors of the vertices (as done by graph automorphism tools as saucy or bliss), without backtracking :
+ * the search is incomplete, but every symmetry returned is verified on the constraints of the model.
+ *
+ * @note only permutations of variables are detected (a literal is never mapped to a negated literal)
+ * @param m model on variables densely numbered from 1 (as the model of a solver)
+ * @param max_symmetries maximum number of symmetries returned
+ * @return symmetries found, they are generators of (a subgroup of) the symmetry group of the model
+ */
+[[nodiscard]] std::vector<symmetry> find_symmetries(const model& m, std::size_t max_symmetries);
+
+/**
+ * @return true if the permutation maps every constraint of the model onto a constraint of the model
+ */
+[[nodiscard]] bool is_symmetry(const model& m, const symmetry& s);
+
+/**
+ * @brief add lex-leader symmetry breaking predicates to the model
+ *
+ * For each symmetry σ, the assignments x are restricted to the ones lexicographically smaller or equal to their image (x ≤ σ(x), the variables
+ * being ordered by index, false < true) : among a set of symmetric assignments, only the lexicographically smallest one is kept. The predicate
+ * is encoded linearly with an auxiliary variable per compared position stating that the previous positions are equal.
+ *
+ * @param m model to add the predicates to (its variables are not renumbered)
+ * @param symmetries symmetries of the model
+ * @param max_length maximum number of positions compared for each symmetry (the predicate is weaker, but still sound, if truncated)
+ * @param new_variable allocates a new variable of the model (auxiliary variable of the predicates)
+ * @return number of clauses added
+ */
+std::size_t add_symmetry_breaking(model& m, std::span<const symmetry> symmetries, std::size_t max_length, const std::function<literal()>& new_variable);
+
+} // namespace fabko::compiler::sat
+
+#endif // SYMMETRY_HH
@@ -0,0 +1,221 @@
+// Dual Licensing Either :
+// - AGPL
+// or
+// - Subscription license for commercial usage (without requirement of licensing propagation).
+//   please contact ballandfys@protonmail.com for additional information about this subscription commercial licensing.
+//
+// Created by FyS on 18/10/26. License 2022-2026
+//
+// In the case no license has been purchased for the use (modification or distribution in any way) of the software stack
+// the APGL license is applying.
+//
+
+#include <algorithm>
+#include <bit>
+#include <map>
+#include <ranges>
+
+#include "solver.hh"
+
+#include "xor_engine.hh"
+
+namespace fabko::compiler::sat {
+
+std::vector<xor_constraint> find_xor_constraints(std::span<const std::vector<literal>> clauses, std::size_t max_size) {
+    // clauses grouped by variables, a clause is represented by its sign pattern : bit i set if the i-th variable (by increasing value) is negated
+    std::map<std::vector<std::int64_t>, std::vector<std::uint32_t>> patterns;
+    std::vector<literal> sorted;
+    for (const auto& clause : clauses) {
+        if (clause.size() < 2 || clause.size() > std::min<std::size_t>(max_size, 31)) {
+            continue;
+        }
+        sorted.assign(clause.begin(), clause.end());
+        std::ranges::sort(sorted, [](const literal& lhs, const literal& rhs) { return lhs.value() < rhs.value(); });
+        if (std::ranges::adjacent_find(sorted, [](const literal& lhs, const literal& rhs) { return lhs.value() == rhs.value(); }) != sorted.end()) {
+            continue; // duplicated variable
+        }
+        std::vector<std::int64_t> variables;
+        std::uint32_t pattern = 0;
+        for (std::size_t i = 0; i < sorted.size(); ++i) {
+            variables.push_back(sorted[i].value());
+            pattern |= (sorted[i].is_off() ? 1U : 0U) << i;
+        }
+        patterns[std::move(variables)].push_back(pattern);
+    }
+
+    // a clause forbids the assignment falsifying it (the negated variables true) : the XOR of parity p is encoded by the 2^(k-1) clauses whose
+    // number of negated literals has the parity of not p
+    std::vector<xor_constraint> res;
+    for (auto& [variables, signs] : patterns) {
+        const std::size_t needed = std::size_t {1} << (variables.size() - 1);
+        if (signs.size() < needed) {
+            continue;
+        }
+        std::ranges::sort(signs);
+        signs.erase(std::ranges::unique(signs).begin(), signs.end());
+        for (const std::uint32_t negations_parity : {0U, 1U}) {
+            const auto count = std::ranges::count_if(signs, [negations_parity](std::uint32_t signs_pattern) { //
+                return (std::popcount(signs_pattern) & 1U) == negations_parity;
+            });
+            if (static_cast<std::size_t>(count) == needed) {
+                res.push_back({
+                    .literals = variables | std::views::transform([](std::int64_t var) { return literal {var}; }) | std::ranges::to<std::vector>(),
+                    .parity   = negations_parity == 0,
+                });
+            }
+        }
+    }
+    return res;
+}
+
+std::uint32_t xor_engine::column_of(std::uint32_t variable) {
+    if (variable >= columns_.size()) {
+        columns_.resize(variable + 1, npos);
+        reasons_.resize(variable + 1);
+    }
+    if (columns_[variable] != npos) {
+        return columns_[variable];
+    }
+
+    const auto column = static_cast<std::uint32_t>(variables_.size());
+    variables_.push_back(variable);
+    column_pivot_.push_back(npos);
+    columns_[variable] = column;
+    if (column >= words_ * 64) {
+        // the rows are widened by a word
+        const auto words = words_ + 1;
+        std::vector<std::uint64_t> bits(rows() * words, 0);
+        for (std::size_t index = 0; index < rows(); ++index) {
+            std::copy_n(row(index), words_, bits.data() + index * words);
+        }
+        bits_  = std::move(bits);
+        words_ = words;
+    }
+    return column;
+}
+
+void xor_engine::add(std::span<const std::uint32_t> variables, bool parity) {
+    std::vector<std::uint32_t> row_columns; // columns are added (and the rows widened) before the row is
+    row_columns.reserve(variables.size());
+    for (const auto variable : variables) {
+        row_columns.push_back(column_of(variable));
+    }
+
+    const auto index = rows();
+    bits_.resize(bits_.size() + words_, 0);
+    rhs_.push_back(parity ? 1 : 0);
+    row_pivot_.push_back(npos);
+    for (const auto column : row_columns) {
+        row(index)[column / 64] ^= std::uint64_t {1} << (column % 64);
+    }
+
+    // the pivot columns only appear in their pivot row
+    for (std::uint32_t column = 0; column < columns(); ++column) {
+        if (column_pivot_[column] != npos && has(index, column)) {
+            add_row(index, column_pivot_[column]);
+        }
+    }
+}
+
+void xor_engine::add_row(std::size_t target, std::size_t source) {
+    auto* target_row       = row(target);
+    const auto* source_row = row(source);
+    for (std::size_t word = 0; word < words_; ++word) {
+        target_row[word] ^= source_row[word];
+    }
+    rhs_[target] ^= rhs_[source];
+}
+
+void xor_engine::pivot(std::size_t row_index, std::uint32_t column) {
+    row_pivot_[row_index] = column;
+    column_pivot_[column] = static_cast<std::uint32_t>(row_index);
+    for (std::size_t other = 0; other < rows(); ++other) {
+        if (other != row_index && has(other, column)) {
+            add_row(other, row_index);
+        }
+    }
+    ++eliminations_;
+}
+
+void xor_engine::variables_of(std::size_t row_index, std::uint32_t except_column, std::vector<std::uint32_t>& out) const {
+    out.clear();
+    for (std::size_t word = 0; word < words_; ++word) {
+        for (auto bits = row(row_index)[word]; bits != 0; bits &= bits - 1) {
+            const auto column = static_cast<std::uint32_t>(word * 64 + static_cast<std::size_t>(std::countr_zero(bits)));
+            if (column != except_column) {
+                out.push_back(variables_[column]);
+            }
+        }
+    }
+}
+
+bool xor_engine::propagate(const solver_context& ctx, std::vector<xor_implication>& implied) {
+    implied.clear();
+    if (empty()) {
+        return false;
+    }
+
+    unassigned_.assign(words_, 0);
+    on_.assign(words_, 0);
+    implied_.assign(words_, 0);
+    for (std::uint32_t column = 0; column < columns(); ++column) {
+        const auto value = get<soa_assignment>(ctx.vars_soa_[ctx.var_ids_[variables_[column]]]);
+        const auto bit   = std::uint64_t {1} << (column % 64);
+        if (value == assignment::not_assigned) {
+            unassigned_[column / 64] |= bit;
+        } else if (value == assignment::on) {
+            on_[column / 64] |= bit;
+        }
+    }
+    auto is_unassigned = [this](std::uint32_t column) { return (unassigned_[column / 64] >> (column % 64) & 1) != 0; };
+
+    // the pivots on assigned columns are released, then the unassigned columns that are not pivots are eliminated from the rows (a row without
+    // pivot has no unassigned column left afterward)
+    for (std::uint32_t column = 0; column < columns(); ++column) {
+        if (!is_unassigned(column) && column_pivot_[column] != npos) {
+            row_pivot_[column_pivot_[column]] = npos;
+            column_pivot_[column]             = npos;
+        }
+    }
+    for (std::uint32_t column = 0; column < columns(); ++column) {
+        if (!is_unassigned(column) || column_pivot_[column] != npos) {
+            continue;
+        }
+        for (std::size_t index = 0; index < rows(); ++index) {
+            if (row_pivot_[index] == npos && has(index, column)) {
+                pivot(index, column);
+                break;
+            }
+        }
+    }
+
+    for (std::size_t index = 0; index < rows(); ++index) {
+        const auto* bits                = row(index);
+        std::size_t unassigned_count    = 0;
+        std::uint32_t unassigned_column = npos;
+        std::uint64_t parity            = rhs_[index];
+        for (std::size_t word = 0; word < words_; ++word) {
+            if (const auto free = bits[word] & unassigned_[word]; free != 0) {
+                unassigned_count += static_cast<std::size_t>(std::popcount(free));
+                unassigned_column = static_cast<std::uint32_t>(word * 64 + static_cast<std::size_t>(std::countr_zero(free)));
+            }
+            parity ^= static_cast<std::uint64_t>(std::popcount(bits[word] & on_[word])) & 1;
+        }
+
+        if (unassigned_count == 0 && parity == 1) {
+            variables_of(index, npos, conflict_);
+            implied.clear();
+            return true;
+        }
+        // the variable is equal to the parity left once the assigned variables are taken into account
+        if (unassigned_count == 1 && (implied_[unassigned_column / 64] >> (unassigned_column % 64) & 1) == 0) {
+            implied_[unassigned_column / 64] |= std::uint64_t {1} << (unassigned_column % 64);
+            const auto variable = variables_[unassigned_column];
+            variables_of(index, unassigned_column, reasons_[variable]);
+            implied.push_back({.variable = variable, .value = parity == 1});
+        }
+    }
+    return false;
+}
+
+} // namespace fabko::compiler::sat
@@ -0,0 +1,132 @@
+// Dual Licensing Either :
+// - AGPL
+// or
+// - Subscription license for commercial usage (without requirement of licensing propagation).
+//   please contact ballandfys@protonmail.com for additional information about this subscription commercial licensing.
+//
+// Created by FyS on 18/10/26. License 2022-2026
+//
+// In the case no license has been purchased for the use (modification or distribution in any way) of the software stack
+// the APGL license is applying.
+//
+
+#ifndef XOR_ENGINE_HH
+#define XOR_ENGINE_HH
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace fabko::compiler::sat {
+
+struct solver_context;
+struct xor_constraint;
+class literal;
+
+/**
+ * @return XOR constraints encoded by the clauses : a XOR over k variables is encoded by the 2^(k-1) clauses forbidding each assignment of the
+ * wrong parity (as done by the adders of the cnf_encoder)
+ * @param clauses clauses to look into, the XOR constraints found are implied by them
+ * @param max_size maximum number of variables of the XOR constraints searched for
+ */
+[[nodiscard]] std::vector<xor_constraint> find_xor_constraints(std::span<const std::vector<literal>> clauses, std::size_t max_size);
+
+/**
+ * @brief variable implied by the XOR engine
+ */
+struct xor_implication {
+    std::uint32_t variable; //!< index of the variable in solver_context::var_ids_
+    bool value;             //!< value the variable is implied to
+};
+
+/**
+ * @brief Propagation engine of the XOR constraints of a solver through an incremental Gauss-Jordan elimination
+ *
+ * The XOR constraints form a matrix over GF(2), a row per constraint and a column per variable, packed 64 columns per word : the addition of
+ * two rows is a word-wise XOR. The matrix is kept in reduced row echelon form on the unassigned variables : each pivot column appears in its
+ * pivot row only. When a pivot variable is assigned the row looks for a new pivot among its unassigned variables, the rows are never reset
+ * on backtrack (any combination of rows is implied by the constraints) : the elimination is incremental along the search.
+ *
+ * A row whose variables are all assigned but one implies that variable, a row whose variables are all assigned to the wrong parity is a
+ * conflict. The implications found through a combination of rows are beyond the reach of the clauses (on parity reasoning the clauses only
+ * propagate each constraint on its own) : they are explained to the conflict analysis by the assigned variables of the row.
+ */
+class xor_engine {
+    static constexpr std::uint32_t npos = 0xFFFFFFFF;
+
+  public:
+    /**
+     * @brief add the constraint : the XOR of the variables (indexes in solver_context::var_ids_) is equal to the parity
+     * @note a variable listed twice is cancelled out
+     */
+    void add(std::span<const std::uint32_t> variables, bool parity);
+
+    /**
+     * @brief eliminate the unassigned variables not pivoted yet, then look for the rows implying a variable or in conflict with the assignment
+     * @param ctx solving context the assignment is read from
+     * @param implied buffer filled with the variables implied (cleared first), the explanation of each implication is recorded (see reason)
+     * @return true if a row is in conflict with the assignment (see conflict), the buffer is not filled then
+     */
+    [[nodiscard]] bool propagate(const solver_context& ctx, std::vector<xor_implication>& implied);
+
+    /**
+     * @return variables whose assignment implied the variable, recorded when the implication was found (valid while the variable is assigned)
+     */
+    [[nodiscard]] std::span<const std::uint32_t> reason(std::uint32_t variable) const { return reasons_[variable]; }
+
+    /**
+     * @return variables of the row found in conflict by the last propagation
+     */
+    [[nodiscard]] std::span<const std::uint32_t> conflict() const { return conflict_; }
+
+    [[nodiscard]] bool empty() const { return rhs_.empty(); }
+    [[nodiscard]] std::size_t rows() const { return rhs_.size(); }
+    [[nodiscard]] std::size_t columns() const { return variables_.size(); }
+    [[nodiscard]] std::size_t eliminations() const { return eliminations_; }
+
+  private:
+    [[nodiscard]] std::uint64_t* row(std::size_t index) { return bits_.data() + index * words_; }
+    [[nodiscard]] const std::uint64_t* row(std::size_t index) const { return bits_.data() + index * words_; }
+    [[nodiscard]] bool has(std::size_t row_index, std::size_t column) const { return (row(row_index)[column / 64] >> (column % 64) & 1) != 0; }
+
+    /**
+     * @return column of the variable, added if not existing (the rows are widened if needed)
+     */
+    std::uint32_t column_of(std::uint32_t variable);
+
+    /**
+     * @brief add the source row to the target row
+     */
+    void add_row(std::size_t target, std::size_t source);
+
+    /**
+     * @brief make the row the pivot row of the column : the column is eliminated from every other row
+     */
+    void pivot(std::size_t row_index, std::uint32_t column);
+
+    /**
+     * @brief fill the buffer with the variables of the row except the one provided
+     */
+    void variables_of(std::size_t row_index, std::uint32_t except_column, std::vector<std::uint32_t>& out) const;
+
+    std::size_t words_ {0};                      //!< number of words of a row
+    std::vector<std::uint64_t> bits_ {};         //!< rows of the matrix, packed 64 columns per word
+    std::vector<std::uint8_t> rhs_ {};           //!< right hand side (parity) of each row
+    std::vector<std::uint32_t> row_pivot_ {};    //!< pivot column of each row (npos if none)
+    std::vector<std::uint32_t> column_pivot_ {}; //!< pivot row of each column (npos if none)
+
+    std::vector<std::uint32_t> variables_ {}; //!< variable of each column
+    std::vector<std::uint32_t> columns_ {};   //!< column of each variable (npos if the variable is in no constraint)
+
+    std::vector<std::uint64_t> unassigned_ {}; //!< mask of the unassigned columns (rebuilt on each propagation)
+    std::vector<std::uint64_t> on_ {};         //!< mask of the columns assigned to true (rebuilt on each propagation)
+    std::vector<std::uint64_t> implied_ {};    //!< mask of the columns implied by the current propagation
+
+    std::vector<std::vector<std::uint32_t>> reasons_ {}; //!< explanation of the last implication of each variable (indexed by variable)
+    std::vector<std::uint32_t> conflict_ {};             //!< explanation of the last conflict
+    std::size_t eliminations_ {0};                       //!< number of pivots made
+};
+
+} // namespace fabko::compiler::sat
+
+#endif // XOR_ENGINE_HH
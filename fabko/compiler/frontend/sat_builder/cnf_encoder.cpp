@@ -0,0 +1,616 @@
+// Dual Licensing Either:
+// - AGPL
+// or
+// - Subscription license for commercial usage (without requirement of licensing propagation).
+//   please contact ballandfys@protonmail.com for additional information about this subscription commercial licensing.
+//
+// Created by fys on 18.10.26. @Copyright Licensing 2022-2026
+//
+// In the case no license has been purchased for the use (modification or distribution in any way) of the software stack
+// the APGL license is applying.
+//
+
+#include <algorithm>
+#include <bit>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <optional>
+#include <ranges>
+
+#include "common/exception.hh"
+
+#include "cnf_encoder.hh"
+
+namespace fabko::compiler::sat_builder {
+
+namespace {
+
+/**
+ * @return maximum value representable on the provided number of bits
+ */
+std::uint64_t max_value(std::size_t bits) { return bits >= 64 ? std::numeric_limits<std::uint64_t>::max() : (std::uint64_t {1} << bits) - 1; }
+
+bool bit_at(std::uint64_t value, std::size_t index) { return index < 64 && ((value >> index) & 1) == 1; }
+
+std::vector<sat::literal> negate_all(std::span<const sat::literal> lits) {
+    std::vector<sat::literal> negated;
+    negated.reserve(lits.size());
+    std::ranges::transform(lits, std::back_inserter(negated), [](const sat::literal& l) { return l.negation(); });
+    return negated;
+}
+
+} // namespace
+
+sat::literal cnf_encoder::make_literal() {
+    const sat::literal lit {next_var_++};
+    literals_.push_back(lit);
+    return lit;
+}
+
+sat::literal cnf_encoder::true_literal() {
+    if (!true_literal_.has_value()) {
+        true_literal_ = make_literal();
+        clauses_.push_back({true_literal_.value()});
+    }
+    return true_literal_.value();
+}
+
+void cnf_encoder::add_clause(std::vector<sat::literal> clause) {
+    if (clause.empty()) {
+        clause.push_back(true_literal().negation()); // empty clause : conflicting with the true literal
+    }
+    clauses_.push_back(std::move(clause));
+}
+
+//
+// Cardinality constraints
+//
+
+void cnf_encoder::at_most(std::span<const sat::literal> lits, std::size_t k, cardinality_encoding encoding) {
+    if (k >= lits.size()) {
+        return;
+    }
+    if (k == 0) {
+        std::ranges::for_each(lits, [this](const sat::literal& l) { add_clause({l.negation()}); });
+        return;
+    }
+
+    if (encoding == cardinality_encoding::automatic) {
+        // estimation of the number of clauses of each encoding : the sequential counter is the most compact for very small bounds, the
+        // cardinality network does not depend on the bound and wins for big bounds
+        const std::size_t n              = lits.size();
+        const std::size_t log_n          = std::bit_width(n);
+        const std::size_t network_cost   = n * log_n * log_n;
+        const std::size_t totalizer_cost = n * std::min(k + 1, log_n * log_n);
+
+        if (k <= 2) {
+            encoding = cardinality_encoding::sequential_counter;
+        } else if (totalizer_cost <= network_cost) {
+            encoding = cardinality_encoding::totalizer;
+        } else {
+            encoding = cardinality_encoding::cardinality_network;
+        }
+    }
+
+    switch (encoding) {
+        case cardinality_encoding::native: cardinalities_.push_back({.literals = {lits.begin(), lits.end()}, .at_most = k}); break;
+        case cardinality_encoding::sequential_counter: at_most_sequential_counter(lits, k); break;
+        case cardinality_encoding::totalizer: at_most_totalizer(lits, k); break;
+        default: at_most_cardinality_network(lits, k); break;
+    }
+}
+
+void cnf_encoder::at_least(std::span<const sat::literal> lits, std::size_t k, cardinality_encoding encoding) {
+    if (k == 0) {
+        return;
+    }
+    if (k > lits.size()) {
+        add_clause({});
+        return;
+    }
+    // at least k literals are true <=> at most n - k literals are false
+    const auto negated = negate_all(lits);
+    at_most(negated, lits.size() - k, encoding);
+}
+
+void cnf_encoder::exactly(std::span<const sat::literal> lits, std::size_t k, cardinality_encoding encoding) {
+    at_most(lits, k, encoding);
+    at_least(lits, k, encoding);
+}
+
+void cnf_encoder::at_most_sequential_counter(std::span<const sat::literal> lits, std::size_t k) {
+    const std::size_t n = lits.size();
+
+    // registers[i][j] is true if at least j+1 literals among the i+1 first literals are true
+    std::vector<std::vector<sat::literal>> registers(n - 1);
+    for (auto& reg : registers) {
+        reg.reserve(k);
+        for (std::size_t j = 0; j < k; ++j) {
+            reg.push_back(make_literal());
+        }
+    }
+
+    add_clause({lits[0].negation(), registers[0][0]});
+    for (std::size_t j = 1; j < k; ++j) {
+        add_clause({registers[0][j].negation()});
+    }
+
+    for (std::size_t i = 1; i < n - 1; ++i) {
+        add_clause({lits[i].negation(), registers[i][0]});
+        add_clause({registers[i - 1][0].negation(), registers[i][0]});
+        for (std::size_t j = 1; j < k; ++j) {
+            add_clause({lits[i].negation(), registers[i - 1][j - 1].negation(), registers[i][j]});
+            add_clause({registers[i - 1][j].negation(), registers[i][j]});
+        }
+        add_clause({lits[i].negation(), registers[i - 1][k - 1].negation()});
+    }
+    add_clause({lits[n - 1].negation(), registers[n - 2][k - 1].negation()});
+}
+
+std::vector<sat::literal> cnf_encoder::totalizer(std::span<const sat::literal> lits, std::size_t clamp) {
+    if (lits.size() == 1) {
+        return {lits.front()};
+    }
+
+    const auto half  = lits.size() / 2;
+    const auto left  = totalizer(lits.subspan(0, half), clamp);
+    const auto right = totalizer(lits.subspan(half), clamp);
+
+    std::vector<sat::literal> outputs;
+    const auto output_count = std::min(left.size() + right.size(), clamp);
+    outputs.reserve(output_count);
+    for (std::size_t i = 0; i < output_count; ++i) {
+        outputs.push_back(make_literal());
+    }
+
+    for (std::size_t a = 0; a <= left.size(); ++a) {
+        for (std::size_t b = 0; b <= right.size(); ++b) {
+            if (a + b == 0) {
+                continue;
+            }
+            std::vector<sat::literal> clause;
+            if (a > 0) {
+                clause.push_back(left[a - 1].negation());
+            }
+            if (b > 0) {
+                clause.push_back(right[b - 1].negation());
+            }
+            clause.push_back(outputs[std::min(a + b, output_count) - 1]);
+            add_clause(std::move(clause));
+        }
+    }
+    return outputs;
+}
+
+void cnf_encoder::at_most_totalizer(std::span<const sat::literal> lits, std::size_t k) {
+    const auto outputs = totalizer(lits, k + 1);
+    add_clause({outputs[k].negation()});
+}
+
+std::vector<sat::literal> cnf_encoder::odd_even_merge(std::span<const sat::literal> lhs, std::span<const sat::literal> rhs) {
+    // half comparator : only the implications from the inputs to the outputs are needed to enforce an upper bound
+    auto comparator = [this](sat::literal a, sat::literal b) {
+        const auto max = make_literal();
+        const auto min = make_literal();
+        add_clause({a.negation(), max});
+        add_clause({b.negation(), max});
+        add_clause({a.negation(), b.negation(), min});
+        return std::make_pair(max, min);
+    };
+
+    if (lhs.size() == 1) {
+        const auto [max, min] = comparator(lhs.front(), rhs.front());
+        return {max, min};
+    }
+
+    auto select = [](std::span<const sat::literal> lits, std::size_t start) {
+        std::vector<sat::literal> selected;
+        for (std::size_t i = start; i < lits.size(); i += 2) {
+            selected.push_back(lits[i]);
+        }
+        return selected;
+    };
+
+    const auto even = odd_even_merge(select(lhs, 0), select(rhs, 0));
+    const auto odd  = odd_even_merge(select(lhs, 1), select(rhs, 1));
+
+    std::vector<sat::literal> merged;
+    merged.reserve(lhs.size() + rhs.size());
+    merged.push_back(even.front());
+    for (std::size_t i = 0; i + 1 < even.size(); ++i) {
+        const auto [max, min] = comparator(odd[i], even[i + 1]);
+        merged.push_back(max);
+        merged.push_back(min);
+    }
+    merged.push_back(odd.back());
+    return merged;
+}
+
+std::vector<sat::literal> cnf_encoder::sorting_network(std::span<const sat::literal> lits) {
+    if (lits.size() == 1) {
+        return {lits.front()};
+    }
+    const auto half  = lits.size() / 2;
+    const auto left  = sorting_network(lits.subspan(0, half));
+    const auto right = sorting_network(lits.subspan(half));
+    return odd_even_merge(left, right);
+}
+
+void cnf_encoder::at_most_cardinality_network(std::span<const sat::literal> lits, std::size_t k) {
+    // the odd-even merge requires a power of two inputs : padding with false literals
+    std::vector<sat::literal> inputs {lits.begin(), lits.end()};
+    inputs.resize(std::bit_ceil(lits.size()), true_literal().negation());
+
+    const auto sorted = sorting_network(inputs);
+    add_clause({sorted[k].negation()});
+}
+
+//
+// Pseudo-Boolean constraints
+//
+
+void cnf_encoder::pb_at_most(std::span<const pb_term> terms, std::uint64_t k, pb_encoding encoding) {
+    std::vector<pb_term> kept;
+    kept.reserve(terms.size());
+    for (const auto& term : terms) {
+        if (term.weight == 0) {
+            continue;
+        }
+        if (term.weight > k) {
+            add_clause({term.lit.negation()}); // the term alone exceeds the bound
+            continue;
+        }
+        kept.push_back(term);
+    }
+
+    const auto total = std::ranges::fold_left(kept, std::uint64_t {0}, [](std::uint64_t sum, const pb_term& t) { return sum + t.weight; });
+    if (total <= k) {
+        return;
+    }
+
+    // same weight for all the terms : this is a cardinality constraint
+    if (std::ranges::all_of(kept, [w = kept.front().weight](const pb_term& t) { return t.weight == w; })) {
+        std::vector<sat::literal> lits;
+        lits.reserve(kept.size());
+        std::ranges::transform(kept, std::back_inserter(lits), &pb_term::lit);
+        at_most(lits, static_cast<std::size_t>(k / kept.front().weight));
+        return;
+    }
+
+    if (encoding == pb_encoding::automatic) {
+        // a level of the BDD has at most one node per budget left (k + 1) and per distinct partial sum of the terms above it : bounded by the
+        // product of (count + 1) over the distinct weights
+        std::map<std::uint64_t, std::uint64_t> weight_counts;
+        for (const auto& term : kept) {
+            ++weight_counts[term.weight];
+        }
+        static constexpr std::uint64_t BDD_MAX_NODES = 1 << 16;
+        std::uint64_t partial_sums                   = 1;
+        for (const auto& count : weight_counts | std::views::values) {
+            partial_sums = partial_sums > BDD_MAX_NODES / (count + 1) ? BDD_MAX_NODES + 1 : partial_sums * (count + 1);
+        }
+        const auto nodes_per_level = std::min(partial_sums, k < BDD_MAX_NODES ? k + 1 : BDD_MAX_NODES + 1);
+        encoding                   = nodes_per_level <= BDD_MAX_NODES / kept.size() ? pb_encoding::bdd : pb_encoding::adder;
+    }
+
+    if (encoding == pb_encoding::bdd) {
+        pb_at_most_bdd(kept, k);
+    } else {
+        pb_at_most_adder(kept, k);
+    }
+}
+
+void cnf_encoder::pb_at_least(std::span<const pb_term> terms, std::uint64_t k, pb_encoding encoding) {
+    const auto total = std::ranges::fold_left(terms, std::uint64_t {0}, [](std::uint64_t sum, const pb_term& t) { return sum + t.weight; });
+    if (k == 0) {
+        return;
+    }
+    if (k > total) {
+        add_clause({});
+        return;
+    }
+    // sum(w.l) >= k <=> sum(w.~l) <= total - k
+    std::vector<pb_term> negated;
+    negated.reserve(terms.size());
+    std::ranges::transform(terms, std::back_inserter(negated), [](const pb_term& t) { return pb_term {.lit = t.lit.negation(), .weight = t.weight}; });
+    pb_at_most(negated, total - k, encoding);
+}
+
+void cnf_encoder::pb_at_most_bdd(std::span<const pb_term> terms, std::uint64_t k) {
+    std::vector<pb_term> sorted {terms.begin(), terms.end()};
+    std::ranges::sort(sorted, std::greater {}, &pb_term::weight);
+
+    std::vector<std::uint64_t> suffix_sum(sorted.size() + 1, 0);
+    for (std::size_t i = sorted.size(); i > 0; --i) {
+        suffix_sum[i - 1] = suffix_sum[i] + sorted[i - 1].weight;
+    }
+
+    // node(i, budget) is true if the terms from i are constrained to a sum lesser or equal to budget. The budgets leading to the same node form
+    // an interval [lower, upper] : a node is shared by every budget of its interval (the BDD is reduced), std::nullopt stands for the true node
+    struct bdd_node {
+        std::uint64_t lower;
+        std::uint64_t upper;
+        std::optional<sat::literal> lit;
+    };
+    constexpr auto infinity = std::numeric_limits<std::uint64_t>::max();
+    auto shift              = [infinity](std::uint64_t bound, std::uint64_t weight) { return bound > infinity - weight ? infinity : bound + weight; };
+
+    std::vector<std::map<std::uint64_t, bdd_node>> levels(sorted.size()); // nodes of each level by lower bound of their interval
+    auto node = [&](this auto&& self, std::size_t i, std::uint64_t budget) -> bdd_node {
+        if (suffix_sum[i] <= budget) {
+            return {.lower = suffix_sum[i], .upper = infinity, .lit = std::nullopt};
+        }
+        if (auto it = levels[i].upper_bound(budget); it != levels[i].begin() && std::prev(it)->second.upper >= budget) {
+            return std::prev(it)->second;
+        }
+
+        const auto& [lit, weight] = sorted[i];
+        const auto low            = self(i + 1, budget);
+        // the high child is the false node for the budgets lesser than the weight
+        const auto high           = weight > budget ? std::optional<bdd_node> {} : std::optional {self(i + 1, budget - weight)};
+        const auto high_lower     = high.has_value() ? shift(high->lower, weight) : 0;
+        const auto high_upper     = high.has_value() ? shift(high->upper, weight) : weight - 1;
+
+        bdd_node res {.lower = std::max(low.lower, high_lower), .upper = std::min(low.upper, high_upper), .lit = std::nullopt};
+        if (high.has_value() && low.lit.has_value() && high->lit.has_value() && low.lit->value() == high->lit->value()) {
+            res.lit = low.lit; // both children are the same node : the term does not matter
+        } else {
+            const auto n = make_literal();
+            if (low.lit.has_value()) {
+                add_clause({n.negation(), low.lit.value()});
+            }
+            if (!high.has_value()) {
+                add_clause({n.negation(), lit.negation()});
+            } else if (high->lit.has_value()) {
+                add_clause({n.negation(), lit.negation(), high->lit.value()});
+            }
+            res.lit = n;
+        }
+        levels[i].emplace(res.lower, res);
+        return res;
+    };
+
+    if (const auto root = node(0, k); root.lit.has_value()) {
+        add_clause({root.lit.value()});
+    }
+}
+
+void cnf_encoder::pb_at_most_adder(std::span<const pb_term> terms, std::uint64_t k) {
+    // buckets of literals by bit position : a term contributes its literal at every position where its weight has a bit set
+    std::vector<std::vector<sat::literal>> buckets;
+    for (const auto& [lit, weight] : terms) {
+        for (std::size_t bit = 0; bit < 64; ++bit) {
+            if (bit_at(weight, bit)) {
+                if (buckets.size() <= bit) {
+                    buckets.resize(bit + 1);
+                }
+                buckets[bit].push_back(lit);
+            }
+        }
+    }
+
+    std::vector<sat::literal> sum_bits;
+    for (std::size_t bit = 0; bit < buckets.size(); ++bit) {
+        while (buckets[bit].size() >= 2) {
+            std::pair<sat::literal, sat::literal> res = [&] {
+                auto& bucket = buckets[bit];
+                const auto a = bucket.back();
+                bucket.pop_back();
+                const auto b = bucket.back();
+                bucket.pop_back();
+                if (bucket.empty()) {
+                    return half_adder(a, b);
+                }
+                const auto c = bucket.back();
+                bucket.pop_back();
+                return full_adder(a, b, c);
+            }();
+            if (buckets.size() <= bit + 1) {
+                buckets.resize(bit + 2);
+            }
+            buckets[bit].push_back(res.first);
+            buckets[bit + 1].push_back(res.second);
+        }
+        sum_bits.push_back(buckets[bit].empty() ? true_literal().negation() : buckets[bit].front());
+    }
+    less_or_equal_constant(sum_bits, k);
+}
+
+std::pair<sat::literal, sat::literal> cnf_encoder::half_adder(sat::literal a, sat::literal b) {
+    const auto sum   = make_literal();
+    const auto carry = make_literal();
+
+    // sum <=> a xor b
+    add_clause({a.negation(), b.negation(), sum.negation()});
+    add_clause({a, b, sum.negation()});
+    add_clause({a, b.negation(), sum});
+    add_clause({a.negation(), b, sum});
+
+    // carry <=> a and b
+    add_clause({carry.negation(), a});
+    add_clause({carry.negation(), b});
+    add_clause({a.negation(), b.negation(), carry});
+    return {sum, carry};
+}
+
+std::pair<sat::literal, sat::literal> cnf_encoder::full_adder(sat::literal a, sat::literal b, sat::literal c) {
+    const auto sum   = make_literal();
+    const auto carry = make_literal();
+
+    // sum <=> a xor b xor c
+    add_clause({a.negation(), b.negation(), c.negation(), sum});
+    add_clause({a.negation(), b, c, sum});
+    add_clause({a, b.negation(), c, sum});
+    add_clause({a, b, c.negation(), sum});
+    add_clause({a, b, c, sum.negation()});
+    add_clause({a.negation(), b.negation(), c, sum.negation()});
+    add_clause({a.negation(), b, c.negation(), sum.negation()});
+    add_clause({a, b.negation(), c.negation(), sum.negation()});
+
+    // carry <=> majority(a, b, c)
+    add_clause({a.negation(), b.negation(), carry});
+    add_clause({a.negation(), c.negation(), carry});
+    add_clause({b.negation(), c.negation(), carry});
+    add_clause({a, b, carry.negation()});
+    add_clause({a, c, carry.negation()});
+    add_clause({b, c, carry.negation()});
+    return {sum, carry};
+}
+
+//
+// Integers
+//
+
+std::vector<sat::literal> cnf_encoder::make_integer(std::size_t bits) {
+    std::vector<sat::literal> integer;
+    integer.reserve(bits);
+    for (std::size_t i = 0; i < bits; ++i) {
+        integer.push_back(make_literal());
+    }
+    return integer;
+}
+
+std::vector<sat::literal> cnf_encoder::constant_integer(std::size_t bits, std::uint64_t value) {
+    std::vector<sat::literal> integer;
+    integer.reserve(bits);
+    for (std::size_t i = 0; i < bits; ++i) {
+        integer.push_back(bit_at(value, i) ? true_literal() : true_literal().negation());
+    }
+    return integer;
+}
+
+void cnf_encoder::less_or_equal_constant(std::span<const sat::literal> bits, std::uint64_t value) {
+    if (value >= max_value(bits.size())) {
+        return;
+    }
+    // the integer is greater than the value if, at the first bit (from the most significant) where they differ, the integer has a bit set.
+    // for each bit not set in the value : the bit cannot be set if all the higher bits set in the value are set in the integer
+    for (std::size_t i = 0; i < bits.size(); ++i) {
+        if (bit_at(value, i)) {
+            continue;
+        }
+        std::vector<sat::literal> clause {bits[i].negation()};
+        for (std::size_t j = i + 1; j < bits.size(); ++j) {
+            if (bit_at(value, j)) {
+                clause.push_back(bits[j].negation());
+            }
+        }
+        add_clause(std::move(clause));
+    }
+}
+
+void cnf_encoder::compare(std::span<const sat::literal> bits, fabl::ir::constraint_operation op, std::uint64_t value) {
+    using fabl::ir::constraint_operation;
+    const auto max = max_value(bits.size());
+
+    switch (op) {
+        case constraint_operation::EQUAL:
+            if (value > max) {
+                add_clause({});
+                return;
+            }
+            for (std::size_t i = 0; i < bits.size(); ++i) {
+                add_clause({bit_at(value, i) ? bits[i] : bits[i].negation()});
+            }
+            return;
+        case constraint_operation::DIFFERENT: {
+            if (value > max) {
+                return;
+            }
+            std::vector<sat::literal> clause;
+            for (std::size_t i = 0; i < bits.size(); ++i) {
+                clause.push_back(bit_at(value, i) ? bits[i].negation() : bits[i]);
+            }
+            add_clause(std::move(clause));
+            return;
+        }
+        case constraint_operation::LESS_THAN_OR_EQUAL: less_or_equal_constant(bits, value); return;
+        case constraint_operation::LESS_THAN:
+            if (value == 0) {
+                add_clause({});
+                return;
+            }
+            less_or_equal_constant(bits, value - 1);
+            return;
+        case constraint_operation::GREATER_THAN_OR_EQUAL: {
+            if (value == 0) {
+                return;
+            }
+            if (value > max) {
+                add_clause({});
+                return;
+            }
+            // x >= value <=> ~x <= max - value (where ~x is the bitwise complement of x)
+            const auto complement = negate_all(bits);
+            less_or_equal_constant(complement, max - value);
+            return;
+        }
+        case constraint_operation::GREATER_THAN:
+            if (value >= max) {
+                add_clause({});
+                return;
+            }
+            compare(bits, constraint_operation::GREATER_THAN_OR_EQUAL, value + 1);
+            return;
+        default: fabko_assert(false, "invalid constraint operation to encode");
+    }
+}
+
+std::pair<std::vector<sat::literal>, sat::literal> cnf_encoder::ripple_carry_adder(std::span<const sat::literal> lhs, std::span<const sat::literal> rhs) {
+    fabko_assert(lhs.size() == rhs.size() && !lhs.empty(), "ripple carry adder requires two integers of the same (non null) width");
+
+    std::vector<sat::literal> sum;
+    sum.reserve(lhs.size());
+
+    auto [first_sum, carry] = half_adder(lhs[0], rhs[0]);
+    sum.push_back(first_sum);
+    for (std::size_t i = 1; i < lhs.size(); ++i) {
+        const auto [bit_sum, bit_carry] = full_adder(lhs[i], rhs[i], carry);
+        sum.push_back(bit_sum);
+        carry = bit_carry;
+    }
+    return {std::move(sum), carry};
+}
+
+std::vector<sat::literal> cnf_encoder::add(std::span<const sat::literal> lhs, std::span<const sat::literal> rhs) {
+    const auto width = std::max(lhs.size(), rhs.size());
+    std::vector<sat::literal> padded_lhs {lhs.begin(), lhs.end()};
+    std::vector<sat::literal> padded_rhs {rhs.begin(), rhs.end()};
+    padded_lhs.resize(width, true_literal().negation());
+    padded_rhs.resize(width, true_literal().negation());
+
+    auto [sum, carry] = ripple_carry_adder(padded_lhs, padded_rhs);
+    add_clause({carry.negation()}); // overflow is forbidden
+    return sum;
+}
+
+std::vector<sat::literal> cnf_encoder::add_constant(std::span<const sat::literal> bits, std::uint64_t value) {
+    if (value == 0) {
+        return {bits.begin(), bits.end()};
+    }
+    if (value > max_value(bits.size())) {
+        add_clause({}); // overflow whatever the value of the integer
+        return {bits.begin(), bits.end()};
+    }
+    return add(bits, constant_integer(bits.size(), value));
+}
+
+std::vector<sat::literal> cnf_encoder::subtract_constant(std::span<const sat::literal> bits, std::uint64_t value) {
+    if (value == 0) {
+        return {bits.begin(), bits.end()};
+    }
+    const auto max = max_value(bits.size());
+    if (value > max) {
+        add_clause({}); // underflow whatever the value of the integer
+        return {bits.begin(), bits.end()};
+    }
+
+    // x - value = x + (2^n - value) modulo 2^n, there is no borrow (x >= value) if and only if the addition carries out
+    auto [difference, carry] = ripple_carry_adder(bits, constant_integer(bits.size(), (max - value) + 1));
+    add_clause({carry});
+    return difference;
+}
+
+} // namespace fabko::compiler::sat_builder
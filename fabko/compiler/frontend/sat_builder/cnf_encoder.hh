@@ -0,0 +1,204 @@
+// Dual Licensing Either:
+// - AGPL
+// or
+// - Subscription license for commercial usage (without requirement of licensing propagation).
+//   please contact ballandfys@protonmail.com for additional information about this subscription commercial licensing.
+//
+// Created by fys on 18.10.26. @Copyright Licensing 2022-2026
+//
+// In the case no license has been purchased for the use (modification or distribution in any way) of the software stack
+// the APGL license is applying.
+//
+
+#ifndef FABKO_CNF_ENCODER_HH
+#define FABKO_CNF_ENCODER_HH
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "compiler/backend/sat/solver.hh"
+#include "compiler/frontend/ir/fabl_ir.hh"
+#include "compiler/frontend/sat_builder/sat_builder.hh"
+
+namespace fabko::compiler::sat_builder {
+
+enum class cardinality_encoding {
+    automatic,           //!< choose the encoding depending on the size of the constraint and the bound
+    sequential_counter,  //!< Sinz sequential counter : O(n.k) clauses and auxiliary variables
+    totalizer,           //!< Bailleux-Boufkhad totalizer (unary outputs clamped at k+1) : O(n.k) clauses, O(n.log(n)) variables
+    cardinality_network, //!< odd-even merge sorting network with half comparators : O(n.log²(n)) clauses, independent of k
+    native               //!< no clause generated : the constraint is propagated natively by the solver (see sat::cardinality)
+};
+
+enum class pb_encoding {
+    automatic, //!< choose the encoding depending on the weights of the constraint
+    bdd,       //!< reduced decision diagram (a node per interval of budgets) over the terms sorted by decreasing weight : O(n.k) nodes at most
+    adder      //!< binary adder network and comparator : O(n.log(max weight)) clauses, independent of the bound
+};
+
+/**
+ * @brief weighted literal of a pseudo-Boolean constraint
+ */
+struct pb_term {
+    sat::literal lit;
+    std::uint64_t weight;
+};
+
+/**
+ * @brief Generator of CNF encodings for the constraints of the FABL language
+ *
+ * The encoder allocates the literals of the model (starting from the first free variable) and collects the clauses generated by the encodings.
+ * Cardinality constraints (at most / at least / exactly k literals are true) and pseudo-Boolean constraints (weighted sum of literals compared
+ * to a bound) are encoded with the encoding requested, or an encoding chosen depending on the constraint when automatic.
+ *
+ * Integers are represented as unsigned bit-vectors of literals (least significant bit first), on which comparisons with constants (FABL
+ * preconditions as `user.money > 100`) and additions / subtractions (FABL resource transfers as `user.money --100--> self.money`) are encoded.
+ */
+class cnf_encoder {
+  public:
+    explicit cnf_encoder(std::int64_t first_free_variable = 1)
+        : next_var_(first_free_variable) {}
+
+    /**
+     * @return literal on a new variable of the model
+     */
+    [[nodiscard]] sat::literal make_literal();
+
+    /**
+     * @brief add a clause to the encoded model, an empty clause makes the model unsatisfiable
+     */
+    void add_clause(std::vector<sat::literal> clause);
+
+    //
+    // Cardinality constraints
+
+    void at_most(std::span<const sat::literal> lits, std::size_t k, cardinality_encoding encoding = cardinality_encoding::automatic);
+    void at_least(std::span<const sat::literal> lits, std::size_t k, cardinality_encoding encoding = cardinality_encoding::automatic);
+    void exactly(std::span<const sat::literal> lits, std::size_t k, cardinality_encoding encoding = cardinality_encoding::automatic);
+
+    //
+    // Pseudo-Boolean constraints
+
+    void pb_at_most(std::span<const pb_term> terms, std::uint64_t k, pb_encoding encoding = pb_encoding::automatic);
+    void pb_at_least(std::span<const pb_term> terms, std::uint64_t k, pb_encoding encoding = pb_encoding::automatic);
+
+    //
+    // Integers (unsigned bit-vectors, least significant bit first)
+
+    /**
+     * @return bit-vector of new literals representing an integer of the provided width
+     */
+    [[nodiscard]] std::vector<sat::literal> make_integer(std::size_t bits);
+
+    /**
+     * @brief constraint the integer to be compared to a constant (as a FABL precondition)
+     * @param bits integer to constraint
+     * @param op comparison operation
+     * @param value constant to compare the integer to
+     */
+    void compare(std::span<const sat::literal> bits, fabl::ir::constraint_operation op, std::uint64_t value);
+
+    /**
+     * @return integer equal to the sum of the two integers (of the width of the widest one), overflow is forbidden
+     */
+    [[nodiscard]] std::vector<sat::literal> add(std::span<const sat::literal> lhs, std::span<const sat::literal> rhs);
+
+    /**
+     * @return integer equal to the sum of the integer and the constant, overflow is forbidden
+     */
+    [[nodiscard]] std::vector<sat::literal> add_constant(std::span<const sat::literal> bits, std::uint64_t value);
+
+    /**
+     * @return integer equal to the integer minus the constant, the integer is constrained to be greater or equal to the constant
+     */
+    [[nodiscard]] std::vector<sat::literal> subtract_constant(std::span<const sat::literal> bits, std::uint64_t value);
+
+    /**
+     * @return literals allocated by the encoder
+     */
+    [[nodiscard]] const std::vector<sat::literal>& literals() const { return literals_; }
+
+    /**
+     * @return clauses generated by the encoder
+     */
+    [[nodiscard]] const std::vector<std::vector<sat::literal>>& clauses() const { return clauses_; }
+
+    /**
+     * @return cardinality constraints left to the native propagation of the solver
+     */
+    [[nodiscard]] const std::vector<sat::cardinality_constraint>& cardinalities() const { return cardinalities_; }
+
+    /**
+     * @return next variable that is going to be allocated
+     */
+    [[nodiscard]] std::int64_t next_variable() const { return next_var_; }
+
+    /**
+     * @return atom made of the literals and clauses generated by the encoder, to be added to a sat_model_builder
+     */
+    [[nodiscard]] sat_build_atom to_atom(fabl::compiler_generation_context ctx) && {
+        return sat_build_atom {
+            .literals      = std::move(literals_),
+            .cnf_clauses   = std::move(clauses_),
+            .cardinalities = std::move(cardinalities_),
+            .ctx           = std::move(ctx),
+        };
+    }
+
+  private:
+    void at_most_sequential_counter(std::span<const sat::literal> lits, std::size_t k);
+    void at_most_totalizer(std::span<const sat::literal> lits, std::size_t k);
+    void at_most_cardinality_network(std::span<const sat::literal> lits, std::size_t k);
+
+    void pb_at_most_bdd(std::span<const pb_term> terms, std::uint64_t k);
+    void pb_at_most_adder(std::span<const pb_term> terms, std::uint64_t k);
+
+    /**
+     * @brief encode that the integer is lesser or equal to the constant with a lexicographic comparator
+     */
+    void less_or_equal_constant(std::span<const sat::literal> bits, std::uint64_t value);
+
+    /**
+     * @return totalizer unary outputs (output i is true if at least i+1 inputs are true), clamped to 'clamp' outputs
+     */
+    std::vector<sat::literal> totalizer(std::span<const sat::literal> lits, std::size_t clamp);
+
+    /**
+     * @return inputs sorted in decreasing order by an odd-even merge sorting network
+     */
+    std::vector<sat::literal> sorting_network(std::span<const sat::literal> lits);
+    std::vector<sat::literal> odd_even_merge(std::span<const sat::literal> lhs, std::span<const sat::literal> rhs);
+
+    /**
+     * @return bits of the sum of two integers of the same width, and the carry out of the most significant bit
+     */
+    std::pair<std::vector<sat::literal>, sat::literal> ripple_carry_adder(std::span<const sat::literal> lhs, std::span<const sat::literal> rhs);
+
+    /**
+     * @return integer of the provided width whose bits are constant literals representing the value
+     */
+    std::vector<sat::literal> constant_integer(std::size_t bits, std::uint64_t value);
+
+    /**
+     * @return pair of sum and carry literals of the addition of the provided literals (2 for a half adder, 3 for a full adder)
+     */
+    std::pair<sat::literal, sat::literal> half_adder(sat::literal a, sat::literal b);
+    std::pair<sat::literal, sat::literal> full_adder(sat::literal a, sat::literal b, sat::literal c);
+
+    /**
+     * @return literal constrained to be true (allocated once)
+     */
+    sat::literal true_literal();
+
+    std::int64_t next_var_;
+    std::optional<sat::literal> true_literal_ {};
+    std::vector<sat::literal> literals_ {};
+    std::vector<std::vector<sat::literal>> clauses_ {};
+    std::vector<sat::cardinality_constraint> cardinalities_ {};
+};
+
+} // namespace fabko::compiler::sat_builder
+
+#endif // FABKO_CNF_ENCODER_HH
@@ -16,19 +16,17 @@ namespace fabko::compiler::sat_builder {
 
 namespace {
 
-sat::literal negate(sat::literal lit) { return sat::literal {-lit.value()}; }
-
 std::pair<std::vector<sat::literal>, std::vector<std::vector<sat::literal>>> make_integer_size_sat(std::int64_t value) {
-    static constexpr sat::literal bits16 {0};
-    static constexpr sat::literal bits32 {1};
-    static constexpr sat::literal bits64 {2};
-    static constexpr sat::literal bits_negative {3};
+    static constexpr sat::literal bits16 {1};
+    static constexpr sat::literal bits32 {2};
+    static constexpr sat::literal bits64 {3};
+    static constexpr sat::literal bits_negative {4};
 
     std::vector<std::vector<sat::literal>> clauses {};
-    clauses.push_back(value > std::numeric_limits<std::uint8_t>::max() ? std::vector {bits16} : std::vector {negate(bits16)});
-    clauses.push_back(value > std::numeric_limits<std::uint16_t>::max() ? std::vector {bits32} : std::vector {negate(bits32)});
-    clauses.push_back(value > std::numeric_limits<std::uint32_t>::max() ? std::vector {bits64} : std::vector {negate(bits64)});
-    clauses.push_back(value >= 0 ? std::vector {negate(bits32)} : std::vector {bits32});
+    clauses.push_back(value > std::numeric_limits<std::uint8_t>::max() ? std::vector {bits16} : std::vector {bits16.negation()});
+    clauses.push_back(value > std::numeric_limits<std::uint16_t>::max() ? std::vector {bits32} : std::vector {bits32.negation()});
+    clauses.push_back(value > std::numeric_limits<std::uint32_t>::max() ? std::vector {bits64} : std::vector {bits64.negation()});
+    clauses.push_back(value >= 0 ? std::vector {bits_negative.negation()} : std::vector {bits_negative});
 
     return {
         std::vector {bits16, bits32, bits64, bits_negative},
@@ -60,6 +58,7 @@ sat_build_atom integer_sat_builder::generate_model() {
     return sat_build_atom {
         .literals    = std::move(literals),
         .cnf_clauses = std::move(cnf_clauses),
+        .ctx         = ctx_,
     };
 }
 
@@ -0,0 +1,85 @@
+// Dual Licensing Either:
+// - AGPL
+// or
+// - Subscription license for commercial usage (without requirement of licensing propagation).
+//   please contact ballandfys@protonmail.com for additional information about this subscription commercial licensing.
+//
+// Created by fys on 18.10.26. @Copyright Licensing 2022-2026
+//
+// In the case no license has been purchased for the use (modification or distribution in any way) of the software stack
+// the APGL license is applying.
+//
+
+#include <algorithm>
+#include <ranges>
+#include <utility>
+
+#include "sat_builder.hh"
+
+namespace fabko::compiler::sat_builder {
+
+sat_model_builder& sat_model_builder::enrich(const sat_build_atom& atom) {
+    const auto offset = static_cast<std::int64_t>(literal_counts_);
+    std::int64_t highest_variable {0};
+
+    auto renumber = [offset, &highest_variable](const sat::literal& lit) {
+        fabko_assert(lit.value() > 0, "atom literal variables are numbered from 1");
+        highest_variable = std::max(highest_variable, lit.value());
+        const auto variable = offset + lit.value();
+        return lit.is_off() ? sat::literal {-variable} : sat::literal {variable};
+    };
+
+    for (const auto& lit : atom.literals) {
+        const auto renumbered = renumber(lit);
+        model_.literals.push_back(renumbered);
+        model_.literal_context.insert_or_assign(renumbered, atom.ctx);
+    }
+    for (const auto& clause : atom.cnf_clauses) {
+        model_.clauses.push_back(clause | std::views::transform(renumber) | std::ranges::to<std::vector>());
+    }
+    for (const auto& [literals, at_most, at_least] : atom.cardinalities) {
+        model_.cardinalities.push_back(sat::cardinality_constraint {
+            .literals = literals | std::views::transform(renumber) | std::ranges::to<std::vector>(),
+            .at_most  = at_most,
+            .at_least = at_least,
+        });
+    }
+    for (const auto& [literals, parity] : atom.xors) {
+        model_.xors.push_back(sat::xor_constraint {
+            .literals = literals | std::views::transform(renumber) | std::ranges::to<std::vector>(),
+            .parity   = parity,
+        });
+    }
+
+    literal_counts_ += static_cast<std::size_t>(highest_variable);
+    return *this;
+}
+
+sat::model sat_model_builder::build() {
+    literal_counts_ = 0;
+    return std::exchange(model_, {});
+}
+
+sat::solver sat_model_builder::build_solver(sat::solver_context::configuration conf) {
+    auto m = build();
+
+    sat::solver_builder builder {std::move(conf)};
+    builder.reserve(m.literals.size(), m.clauses.size());
+    for (const auto& lit : m.literals) {
+        const auto context = m.literal_context.find(lit);
+        builder.add_variable(lit, context != m.literal_context.end() ? std::optional {std::move(context->second)} : std::nullopt);
+    }
+    for (auto& clause : m.clauses) {
+        builder.add_clause(clause);
+        clause = {}; // released as soon as it is stored in the solver
+    }
+    for (auto& constraint : m.cardinalities) {
+        builder.add_cardinality(std::move(constraint));
+    }
+    for (auto& constraint : m.xors) {
+        builder.add_xor(std::move(constraint));
+    }
+    return std::move(builder).build();
+}
+
+} // namespace fabko::compiler::sat_builder
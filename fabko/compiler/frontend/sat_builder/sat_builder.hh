@@ -16,24 +16,45 @@
 #include <vector>
 
 #include "compiler/backend/sat/solver.hh"
+#include "compiler/metadata.hh"
 
 namespace fabko::compiler::sat_builder {
 
+/**
+ * @brief Element of SAT model generated for a FABL construct
+ *
+ * The literals of an atom are local to it (variables numbered from 1), they are renumbered when the atom is added to the model builder.
+ */
 struct sat_build_atom {
     std::vector<sat::literal> literals;
     std::vector<std::vector<sat::literal>> cnf_clauses;
+    std::vector<sat::cardinality_constraint> cardinalities {};
+    std::vector<sat::xor_constraint> xors {}; //!< parity constraints, propagated natively instead of being encoded into clauses
 
     fabl::compiler_generation_context ctx;
 };
 
 class sat_model_builder {
   public:
-    sat_model_builder& enrich(const sat_build_atom& atom) { return *this; }
-
-    std::vector<sat::literal> build();
+    /**
+     * @brief add the atom to the model, its literals are renumbered on new variables of the model
+     */
+    sat_model_builder& enrich(const sat_build_atom& atom);
+
+    /**
+     * @return SAT model made of all the atoms the builder has been enriched with
+     */
+    sat::model build();
+
+    /**
+     * @return solver of the model made of all the atoms the builder has been enriched with, the clauses are moved into the clause storage of
+     * the solver (see sat::solver_builder) instead of being copied from a model
+     */
+    sat::solver build_solver(sat::solver_context::configuration conf = {});
 
   private:
     std::size_t literal_counts_ = 0;
+    sat::model model_ {};
 };
 
 } // namespace fabko::compiler::sat_builder
@@ -16,6 +16,7 @@
 #include <cstdint>
 #include <optional>
 #include <string>
+#include <utility>
 
 namespace fabko::compiler {
 namespace fabl {
@@ -35,6 +36,17 @@ class solving_generation_context {}; //@todo transform into a forward declaratio
 namespace fabko::compiler {
 
 class metadata {
+  public:
+    metadata() = default;
+    explicit metadata(std::optional<fabl::compiler_generation_context> fabl_ctx)
+        : fabl_generation_ctx(std::move(fabl_ctx)) {}
+
+    /**
+     * @return FABL construct this element has been generated for, if generated by the fabl compiler
+     */
+    [[nodiscard]] const std::optional<fabl::compiler_generation_context>& fabl_context() const { return fabl_generation_ctx; }
+
+  private:
     std::optional<fabl::compiler_generation_context> fabl_generation_ctx; //!< set if the fabl compiler generated this context
     std::optional<sat::solving_generation_context> sat_generation_ctx;    //!< set if the sat generation generated this context
 };
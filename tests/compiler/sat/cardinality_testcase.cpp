@@ -0,0 +1,119 @@
+// Dual Licensing Either :
+// - AGPL
+// or
+// - Subscription license for commercial usage (without requirement of licensing propagation).
+//   please contact ballandfys@protonmail.com for additional information about this subscription commercial licensing.
+//
+// Created by FyS on 18/10/26. License 2022-2026
+//
+// In the case no license has been purchased for the use (modification or distribution in any way) of the software stack
+// the APGL license is applying.
+//
+
+#include <algorithm>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "common/logging.hh"
+#include "compiler/backend/sat/solver.hh"
+
+using namespace fabko::compiler::sat;
+
+namespace {
+
+bool is_on(const solver::result& res, std::int64_t var) {
+    const auto it = std::ranges::find(res.literals, literal {var});
+    return it != res.literals.end() && it->is_on();
+}
+
+} // namespace
+
+TEST_CASE("test native cardinality constraints", "[compiler][backend][sat]") {
+    fabko::init_logger(spdlog::level::warn);
+
+    SECTION("4-queens :: exactly one queen per row and column, at most one per diagonal") {
+        static constexpr std::int64_t N = 4;
+        auto cell                       = [](std::int64_t row, std::int64_t col) { return literal {row * N + col + 1}; };
+
+        model m;
+        for (std::int64_t i = 0; i < N * N; ++i) {
+            m.literals.emplace_back(i + 1);
+        }
+        for (std::int64_t i = 0; i < N; ++i) {
+            cardinality_constraint row {.at_most = 1, .at_least = 1};
+            cardinality_constraint col {.at_most = 1, .at_least = 1};
+            for (std::int64_t j = 0; j < N; ++j) {
+                row.literals.push_back(cell(i, j));
+                col.literals.push_back(cell(j, i));
+            }
+            m.cardinalities.push_back(std::move(row));
+            m.cardinalities.push_back(std::move(col));
+        }
+        for (std::int64_t d = -(N - 1); d < N; ++d) {
+            cardinality_constraint diagonal {.at_most = 1};
+            cardinality_constraint anti_diagonal {.at_most = 1};
+            for (std::int64_t row = 0; row < N; ++row) {
+                if (const auto col = row + d; col >= 0 && col < N) {
+                    diagonal.literals.push_back(cell(row, col));
+                }
+                if (const auto col = N - 1 - row + d; col >= 0 && col < N) {
+                    anti_diagonal.literals.push_back(cell(row, col));
+                }
+            }
+            m.cardinalities.push_back(std::move(diagonal));
+            m.cardinalities.push_back(std::move(anti_diagonal));
+        }
+
+        solver s {std::move(m)};
+        const auto res = s.solve_next();
+        REQUIRE(res.has_value());
+
+        std::vector<std::pair<std::int64_t, std::int64_t>> queens;
+        for (std::int64_t row = 0; row < N; ++row) {
+            for (std::int64_t col = 0; col < N; ++col) {
+                if (is_on(res.value(), cell(row, col).value())) {
+                    queens.emplace_back(row, col);
+                }
+            }
+        }
+        REQUIRE(queens.size() == N);
+        for (std::size_t i = 0; i < queens.size(); ++i) {
+            for (std::size_t j = i + 1; j < queens.size(); ++j) {
+                const auto [ri, ci] = queens[i];
+                const auto [rj, cj] = queens[j];
+                CHECK(ri != rj);
+                CHECK(ci != cj);
+                CHECK(std::abs(ri - rj) != std::abs(ci - cj));
+            }
+        }
+    }
+
+    SECTION("pigeonhole :: 3 pigeons cannot fit in 2 holes") {
+        // variable (pigeon * 2 + hole + 1) is true if the pigeon is in the hole
+        model m {
+            .literals = {literal {1}, literal {2}, literal {3}, literal {4}, literal {5}, literal {6}},
+            .clauses  = {{literal {1}, literal {2}}, {literal {3}, literal {4}}, {literal {5}, literal {6}}},
+            .cardinalities = {
+                cardinality_constraint {.literals = {literal {1}, literal {3}, literal {5}}, .at_most = 1},
+                cardinality_constraint {.literals = {literal {2}, literal {4}, literal {6}}, .at_most = 1},
+            },
+        };
+
+        solver s {std::move(m)};
+        const auto res = s.solve_next();
+        REQUIRE_FALSE(res.has_value());
+        CHECK(res.error() == sat_error::unsatisfiable);
+    }
+
+    SECTION("incremental :: at least two literals under assumptions") {
+        solver s {model {.literals = {literal {1}, literal {2}, literal {3}}, .clauses = {{literal {1}, literal {2}, literal {3}}}}};
+        s.add_cardinality({.literals = {literal {1}, literal {2}, literal {3}}, .at_most = 2, .at_least = 2});
+
+        const std::vector assumptions {literal {-1}, literal {-2}};
+        CHECK_FALSE(s.solve_with_assumptions(assumptions).has_value());
+
+        const auto res = s.solve_with_assumptions(std::vector {literal {3}});
+        REQUIRE(res.has_value());
+        CHECK(std::ranges::count_if(res->literals, [](const literal& l) { return l.is_on(); }) == 2);
+    }
+}
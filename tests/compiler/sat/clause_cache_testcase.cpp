@@ -0,0 +1,119 @@
+// Dual Licensing Either :
+// - AGPL
+// or
+// - Subscription license for commercial usage (without requirement of licensing propagation).
+//   please contact ballandfys@protonmail.com for additional information about this subscription commercial licensing.
+//
+// Created by FyS on 18/10/26. License 2022-2026
+//
+// In the case no license has been purchased for the use (modification or distribution in any way) of the software stack
+// the APGL license is applying.
+//
+
+#include <algorithm>
+#include <map>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "common/logging.hh"
+#include "compiler/backend/sat/clause_cache.hh"
+
+#include "sat_testcase_helpers.hh"
+
+using namespace fabko::compiler::sat;
+using namespace fabko::compiler::sat::testcase;
+
+namespace {
+
+/**
+ * @brief in-memory key-value store (a missing key is an empty value)
+ */
+struct memory_store {
+    std::string get(const std::string& key) { return data[key]; }
+    std::vector<fabko::key_value> multi_get(const std::vector<std::string>& keys) {
+        return keys | std::views::transform([this](const std::string& key) { return fabko::key_value {key, data[key]}; }) | std::ranges::to<std::vector>();
+    }
+    bool set(const fabko::key_value& kv) {
+        data[kv.first] = kv.second;
+        return true;
+    }
+    bool multi_set(const std::vector<fabko::key_value>& kvs) { return std::ranges::all_of(kvs, [this](const auto& kv) { return set(kv); }); }
+
+    std::map<std::string, std::string> data;
+};
+
+} // namespace
+
+TEST_CASE("test model fingerprint", "[compiler][backend][sat]") {
+    const model m {
+        .literals = {literal {1}, literal {2}, literal {3}},
+        .clauses  = {{literal {1}, literal {-2}}, {literal {2}, literal {3}}},
+    };
+    const model reordered {
+        .literals = {literal {3}, literal {2}, literal {1}},
+        .clauses  = {{literal {3}, literal {2}}, {literal {-2}, literal {1}}},
+    };
+    const model negated {
+        .literals = {literal {1}, literal {2}, literal {3}},
+        .clauses  = {{literal {1}, literal {2}}, {literal {2}, literal {3}}},
+    };
+    auto superset = m;
+    superset.clauses.push_back({literal {-3}});
+
+    CHECK(make_fingerprint(m).hash == make_fingerprint(reordered).hash);
+    CHECK(make_fingerprint(m).hash != make_fingerprint(negated).hash);
+    CHECK(make_fingerprint(m).is_subset_of(make_fingerprint(superset)));
+    CHECK_FALSE(make_fingerprint(superset).is_subset_of(make_fingerprint(m)));
+}
+
+TEST_CASE("test clause cache", "[compiler][backend][sat]") {
+    fabko::init_logger(spdlog::level::warn);
+
+    memory_store store;
+    clause_cache cache {store, clause_cache_configuration {.max_lbd = 100}};
+
+    const auto m = make_pigeonhole(5, 4);
+    solver s {m};
+    REQUIRE_FALSE(s.solve_next().has_value());
+    REQUIRE_FALSE(s.learned_clauses().empty());
+    cache.store(m, s);
+
+    SECTION("serialization round trip") {
+        const cached_solver_state state {.fingerprint = make_fingerprint(m), .learned = s.learned_clauses(), .phases = s.saved_phases()};
+        const auto restored = deserialize_cached_state(serialize(state));
+        REQUIRE(restored.has_value());
+        CHECK(restored->fingerprint.constraints == state.fingerprint.constraints);
+        CHECK(restored->learned.size() == state.learned.size());
+        CHECK(restored->phases.size() == 20);
+        CHECK_FALSE(deserialize_cached_state(serialize(state).substr(0, 20)).has_value());
+    }
+
+    SECTION("same model is seeded") {
+        solver warm {m};
+        CHECK(cache.seed(m, warm) == s.learned_clauses().size());
+        const auto res = warm.solve_next();
+        REQUIRE_FALSE(res.has_value());
+        CHECK(res.error() == sat_error::unsatisfiable);
+    }
+
+    SECTION("superset model is seeded") {
+        auto superset = m;
+        superset.clauses.push_back({literal {-1}, literal {-2}, literal {42}});
+        superset.literals.emplace_back(42);
+        const auto state = cache.lookup(superset);
+        REQUIRE(state.has_value());
+        CHECK(state->fingerprint.hash == make_fingerprint(m).hash);
+
+        solver warm {superset};
+        CHECK(warm.seed(state->learned, state->phases) > 0);
+        CHECK_FALSE(warm.solve_next().has_value());
+    }
+
+    SECTION("unrelated model is not seeded") {
+        const auto other = make_pigeonhole(4, 4);
+        CHECK_FALSE(cache.lookup(other).has_value());
+        solver cold {other};
+        CHECK(cache.seed(other, cold) == 0);
+        CHECK(cold.solve_next().has_value());
+    }
+}
@@ -0,0 +1,68 @@
+// Dual Licensing Either :
+// - AGPL
+// or
+// - Subscription license for commercial usage (without requirement of licensing propagation).
+//   please contact ballandfys@protonmail.com for additional information about this subscription commercial licensing.
+//
+// Created by FyS on 18/10/26. License 2022-2026
+//
+// In the case no license has been purchased for the use (modification or distribution in any way) of the software stack
+// the APGL license is applying.
+//
+
+#include <random>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include "compiler/backend/sat/clause_kernels.hh"
+
+using namespace fabko::compiler::sat;
+
+TEST_CASE("test clause kernels", "[compiler][backend][sat]") {
+
+    const auto level = GENERATE(simd_level::scalar, simd_level::sse4, simd_level::avx2);
+    if (level > detected_simd_level()) {
+        SKIP("instruction set " << to_string(level) << " not supported by the CPU");
+    }
+
+    SECTION("single literals") {
+        // x0 is on, x1 is off and x2 is unassigned
+        const std::vector<std::uint8_t> values {packed_on, packed_off, packed_unassigned, 0, 0, 0};
+        const std::vector<std::uint32_t> x0 {0 << 1}, not_x0 {(0 << 1) | 1}, x1 {1 << 1}, not_x1 {(1 << 1) | 1}, x2 {2 << 1}, not_x2 {(2 << 1) | 1};
+
+        CHECK(any_satisfied(x0, values.data(), level));
+        CHECK_FALSE(any_satisfied(not_x0, values.data(), level));
+        CHECK_FALSE(any_satisfied(x1, values.data(), level));
+        CHECK(any_satisfied(not_x1, values.data(), level));
+        CHECK_FALSE(any_satisfied(x2, values.data(), level));
+        CHECK_FALSE(any_satisfied(not_x2, values.data(), level));
+
+        CHECK_FALSE(all_falsified(x0, values.data(), level));
+        CHECK(all_falsified(not_x0, values.data(), level));
+        CHECK(all_falsified(x1, values.data(), level));
+        CHECK_FALSE(all_falsified(not_x1, values.data(), level));
+        CHECK_FALSE(all_falsified(x2, values.data(), level));
+        CHECK_FALSE(all_falsified(not_x2, values.data(), level));
+    }
+
+    SECTION("random clauses :: same evaluation as the scalar kernels") {
+        static constexpr std::uint32_t variables = 64;
+        std::mt19937 random {42};
+
+        for (int round = 0; round < 500; ++round) {
+            std::vector<std::uint8_t> values(variables + packed_assignment_padding, packed_unassigned);
+            for (std::uint32_t var = 0; var < variables; ++var) {
+                values[var] = static_cast<std::uint8_t>(random() % 3);
+            }
+            // long clauses are needed to exercise the vectorized loops as well as their scalar tail
+            std::vector<std::uint32_t> clause(random() % 40);
+            for (auto& lit : clause) {
+                lit = ((random() % variables) << 1) | (random() % 2);
+            }
+            CHECK(any_satisfied(clause, values.data(), level) == any_satisfied(clause, values.data(), simd_level::scalar));
+            CHECK(all_falsified(clause, values.data(), level) == all_falsified(clause, values.data(), simd_level::scalar));
+        }
+    }
+}
@@ -0,0 +1,115 @@
+// Dual Licensing Either :
+// - AGPL
+// or
+// - Subscription license for commercial usage (without requirement of licensing propagation).
+//   please contact ballandfys@protonmail.com for additional information about this subscription commercial licensing.
+//
+// Created by FyS on 18/10/26. License 2022-2026
+//
+// In the case no license has been purchased for the use (modification or distribution in any way) of the software stack
+// the APGL license is applying.
+//
+
+#include <algorithm>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include "common/logging.hh"
+#include "compiler/backend/sat/local_search.hh"
+
+#include "sat_testcase_helpers.hh"
+
+using namespace fabko::compiler::sat;
+using namespace fabko::compiler::sat::testcase;
+
+namespace {
+
+model make_chain_model() {
+    // x1 -> x2 -> ... -> x8, (x1 or x8), (not x8 or not x7 or x3)
+    model m;
+    for (std::int64_t i = 1; i <= 8; ++i) {
+        m.literals.emplace_back(i);
+    }
+    for (std::int64_t i = 1; i < 8; ++i) {
+        m.clauses.push_back({literal {-i}, literal {i + 1}});
+    }
+    m.clauses.push_back({literal {1}, literal {8}});
+    m.clauses.push_back({literal {-8}, literal {-7}, literal {3}});
+    return m;
+}
+
+} // namespace
+
+TEST_CASE("test local search", "[compiler][backend][sat]") {
+    fabko::init_logger(spdlog::level::warn);
+
+    const auto strategy = GENERATE(local_search_strategy::probsat, local_search_strategy::walksat);
+
+    SECTION("standalone :: satisfiable model") {
+        const auto m = make_chain_model();
+        local_search search {m, local_search_configuration {.strategy = strategy}};
+
+        const auto res = search.search();
+        REQUIRE(res.has_value());
+        CHECK(satisfies(res.value(), m));
+        CHECK(search.best_falsified_count() == 0);
+        CHECK(search.best_phase(literal {8}) == assignment::on);
+    }
+
+    SECTION("standalone :: unsatisfiable model is unknown") {
+        const model m {
+            .literals = {literal {1}, literal {2}},
+            .clauses  = {{literal {1}, literal {2}}, {literal {-1}, literal {2}}, {literal {1}, literal {-2}}, {literal {-1}, literal {-2}}},
+        };
+        local_search search {m, local_search_configuration {.strategy = strategy, .max_flips = 1000, .max_tries = 2}};
+
+        const auto res = search.search();
+        REQUIRE_FALSE(res.has_value());
+        CHECK(res.error() == sat_error::unknown);
+        CHECK(search.best_falsified_count() == 1);
+    }
+
+    SECTION("standalone :: the XOR constraints are checked") {
+        const model m {
+            .literals = {literal {1}, literal {2}},
+            .clauses  = {{literal {1}}, {literal {2}}},
+            .xors     = {{.literals = {literal {1}, literal {2}}, .parity = true}},
+        };
+        local_search search {m, local_search_configuration {.strategy = strategy, .max_flips = 1000, .max_tries = 2}};
+
+        const auto res = search.search();
+        REQUIRE_FALSE(res.has_value());
+        CHECK(res.error() == sat_error::unknown);
+    }
+
+    SECTION("standalone :: variables only known by the constraints") {
+        const model m {
+            .literals      = {literal {1}},
+            .clauses       = {{literal {1}}},
+            .cardinalities = {{.literals = {literal {3}, literal {4}}, .at_most = 1}},
+            .xors          = {{.literals = {literal {1}, literal {3}}, .parity = true}},
+        };
+        local_search search {m, local_search_configuration {.strategy = strategy}};
+
+        const std::vector<literal> phases {literal {-3}, literal {-4}};
+        const auto res = search.search(phases);
+        REQUIRE(res.has_value());
+        CHECK(std::ranges::find(res->literals, literal {1})->is_on());
+        CHECK(std::ranges::find(res->literals, literal {3})->is_off());
+    }
+}
+
+TEST_CASE("test local search rephasing", "[compiler][backend][sat]") {
+    fabko::init_logger(spdlog::level::warn);
+
+    auto m                        = make_chain_model();
+    m.conf.local_search_rephasing = true;
+    const auto clauses            = m.clauses;
+
+    solver s {std::move(m)};
+    const auto res = s.solve_next();
+    REQUIRE(res.has_value());
+    CHECK(satisfies(res.value(), model {.literals = {}, .clauses = clauses}));
+    CHECK(s.statistics().rephases >= 1);
+}
@@ -0,0 +1,152 @@
+// Dual Licensing Either :
+// - AGPL
+// or
+// - Subscription license for commercial usage (without requirement of licensing propagation).
+//   please contact ballandfys@protonmail.com for additional information about this subscription commercial licensing.
+//
+// Created by FyS on 18/10/26. License 2022-2026
+//
+// In the case no license has been purchased for the use (modification or distribution in any way) of the software stack
+// the APGL license is applying.
+//
+
+#include <algorithm>
+#include <random>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "common/logging.hh"
+#include "compiler/backend/sat/model_counter.hh"
+
+using namespace fabko::compiler::sat;
+
+namespace {
+
+model make_variables(std::int64_t variables) {
+    model m;
+    for (std::int64_t var = 1; var <= variables; ++var) {
+        m.literals.emplace_back(var);
+    }
+    return m;
+}
+
+/**
+ * @return number of assignments of the variables (1 to variables) satisfying every clause of the model
+ */
+std::uint64_t brute_force_count(const model& m, std::int64_t variables) {
+    std::uint64_t count = 0;
+    for (std::uint64_t assignment = 0; assignment < (std::uint64_t {1} << variables); ++assignment) {
+        count += std::ranges::all_of(m.clauses, [assignment](const std::vector<literal>& clause) {
+            return std::ranges::any_of(clause, [assignment](const literal& lit) { return ((assignment >> (lit.value() - 1) & 1) == 1) == lit.is_on(); });
+        });
+    }
+    return count;
+}
+
+} // namespace
+
+TEST_CASE("test model counter exact", "[compiler][backend][sat]") {
+    fabko::init_logger(spdlog::level::warn);
+
+    SECTION("free variables") {
+        model_counter counter {make_variables(10)};
+        CHECK(counter.count_exact().value() == 1024);
+    }
+
+    SECTION("independent components are multiplied") {
+        // (1 or 2) and (3 or 4) : 3 solutions each, 5 is free
+        auto m    = make_variables(5);
+        m.clauses = {{literal {1}, literal {2}}, {literal {3}, literal {4}}};
+        model_counter counter {std::move(m)};
+        CHECK(counter.count_exact().value() == 18);
+    }
+
+    SECTION("pigeonhole :: one solution per permutation") {
+        auto m  = make_variables(9);
+        auto at = [](std::int64_t pigeon, std::int64_t hole) { return pigeon * 3 + hole + 1; };
+        for (std::int64_t pigeon = 0; pigeon < 3; ++pigeon) {
+            m.clauses.push_back({literal {at(pigeon, 0)}, literal {at(pigeon, 1)}, literal {at(pigeon, 2)}});
+        }
+        for (std::int64_t hole = 0; hole < 3; ++hole) {
+            m.cardinalities.push_back({.literals = {literal {at(0, hole)}, literal {at(1, hole)}, literal {at(2, hole)}}, .at_most = 1});
+        }
+        model_counter counter {std::move(m)};
+        CHECK(counter.count_exact().value() == 6);
+    }
+
+    SECTION("native constraints") {
+        auto m          = make_variables(6);
+        m.cardinalities = {{.literals = {literal {1}, literal {2}, literal {3}}, .at_most = 2, .at_least = 2}};
+        m.xors          = {{.literals = {literal {4}, literal {-5}, literal {6}}, .parity = true}};
+        model_counter counter {std::move(m)};
+        CHECK(counter.count_exact().value() == 3 * 4);
+    }
+
+    SECTION("unsatisfiable") {
+        auto m    = make_variables(3);
+        m.clauses = {{literal {1}, literal {2}}, {literal {-1}}, {literal {-2}}};
+        model_counter counter {std::move(m)};
+        CHECK(counter.count_exact().value() == 0);
+    }
+
+    SECTION("random 3-SAT :: same count as the brute force") {
+        std::mt19937_64 random {7};
+        std::uniform_int_distribution<std::int64_t> variable {1, 14};
+        std::bernoulli_distribution negated {0.5};
+        for (int instance = 0; instance < 5; ++instance) {
+            auto m = make_variables(14);
+            for (int clause = 0; clause < 40; ++clause) {
+                std::vector<literal> literals;
+                for (int lit = 0; lit < 3; ++lit) {
+                    const auto var = variable(random);
+                    literals.emplace_back(negated(random) ? -var : var);
+                }
+                m.clauses.push_back(std::move(literals));
+            }
+            const auto expected = brute_force_count(m, 14);
+            model_counter counter {std::move(m)};
+            CHECK(counter.count_exact().value() == expected);
+        }
+    }
+
+    SECTION("count overflowing 64 bits") {
+        model_counter counter {make_variables(70), {.mode = counting_mode::exact}};
+        CHECK(counter.count_exact().error() == sat_error::unknown);
+
+        model_counter automatic {make_variables(70), {.exact_max_variables = 100, .iterations = 3}};
+        const auto res = automatic.count();
+        REQUIRE(res.has_value());
+        CHECK_FALSE(res->exact.has_value());
+        CHECK(res->estimate > 0x1p69 / 1.8);
+        CHECK(res->estimate < 0x1p70 * 1.8);
+    }
+}
+
+TEST_CASE("test model counter approximate", "[compiler][backend][sat]") {
+    fabko::init_logger(spdlog::level::warn);
+
+    SECTION("few solutions are enumerated") {
+        auto m    = make_variables(4);
+        m.clauses = {{literal {1}, literal {2}}, {literal {3}}};
+        model_counter counter {std::move(m), {.mode = counting_mode::approximate}};
+        const auto res = counter.count();
+        REQUIRE(res.has_value());
+        CHECK(res->exact == 6);
+        CHECK(res->estimate == 6.0);
+    }
+
+    SECTION("estimate within the tolerance") {
+        // (1 or 2) and (3 or 4) ... (15 or 16) : 3^8 solutions
+        auto m = make_variables(16);
+        for (std::int64_t var = 1; var < 16; var += 2) {
+            m.clauses.push_back({literal {var}, literal {var + 1}});
+        }
+        model_counter counter {std::move(m), {.mode = counting_mode::approximate, .iterations = 5}};
+        const auto res = counter.count();
+        REQUIRE(res.has_value());
+        CHECK_FALSE(res->exact.has_value());
+        CHECK(res->estimate >= 6561 / 1.8);
+        CHECK(res->estimate <= 6561 * 1.8);
+        CHECK(counter.statistics().hash_constraints > 0);
+    }
+}
@@ -0,0 +1,128 @@
+// Dual Licensing Either :
+// - AGPL
+// or
+// - Subscription license for commercial usage (without requirement of licensing propagation).
+//   please contact ballandfys@protonmail.com for additional information about this subscription commercial licensing.
+//
+// Created by FyS on 18/10/26. License 2022-2026
+//
+// In the case no license has been purchased for the use (modification or distribution in any way) of the software stack
+// the APGL license is applying.
+//
+
+#include <algorithm>
+#include <functional>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include "common/logging.hh"
+#include "compiler/backend/sat/optimizer.hh"
+
+using namespace fabko::compiler::sat;
+
+TEST_CASE("test optimizer", "[compiler][backend][sat]") {
+    fabko::init_logger(spdlog::level::warn);
+
+    const auto strategy = GENERATE(optimization_strategy::linear_sat_unsat, optimization_strategy::core_guided);
+
+    SECTION("weighted soft clauses :: the cheapest soft clause is violated") {
+        optimization_model m {
+            .hard =
+                model {
+                       .literals = {literal {1}, literal {2}},
+                       .clauses  = {{literal {1}, literal {2}}},
+                       },
+            .soft = {
+                       soft_clause {.literals = {literal {-1}}, .weight = 3},
+                       soft_clause {.literals = {literal {-2}}, .weight = 2},
+                       },
+        };
+
+        std::vector<std::uint64_t> improvements;
+        optimizer opti {std::move(m), strategy};
+        const auto res = opti.optimize([&improvements](const optimization_result& r) { improvements.push_back(r.cost); });
+
+        REQUIRE(res.has_value());
+        CHECK(res->optimal);
+        CHECK(res->cost == 2);
+        CHECK(opti.cost_of(res->solution) == 2);
+        REQUIRE_FALSE(improvements.empty());
+        CHECK(improvements.back() == 2);
+        CHECK(std::ranges::is_sorted(improvements, std::greater {}));
+    }
+
+    SECTION("integer objective :: minimize") {
+        const std::vector bits {literal {1}, literal {2}, literal {3}};
+        optimization_model m {
+            .hard =
+                model {
+                       .literals = bits,
+                       .clauses  = {{literal {1}, literal {2}, literal {3}}, {literal {-1}, literal {3}}},
+                       },
+            .soft = make_integer_objective(bits, optimization_direction::minimize),
+        };
+
+        optimizer opti {std::move(m), strategy};
+        const auto res = opti.optimize();
+
+        REQUIRE(res.has_value());
+        CHECK(res->optimal);
+        CHECK(res->cost == 2); // smallest value is 0b010
+    }
+
+    SECTION("integer objective :: maximize") {
+        const std::vector bits {literal {1}, literal {2}, literal {3}};
+        optimization_model m {
+            .hard =
+                model {
+                       .literals = bits,
+                       .clauses  = {{literal {-3}}},
+                       },
+            .soft = make_integer_objective(bits, optimization_direction::maximize),
+        };
+
+        optimizer opti {std::move(m), strategy};
+        const auto res = opti.optimize();
+
+        REQUIRE(res.has_value());
+        CHECK(res->optimal);
+        CHECK(res->cost == 4); // biggest value is 0b011, the most significant bit is missing
+    }
+
+    SECTION("unsatisfiable hard clauses") {
+        optimization_model m {
+            .hard =
+                model {
+                       .literals = {literal {1}},
+                       .clauses  = {{literal {1}}, {literal {-1}}},
+                       },
+            .soft = {soft_clause {.literals = {literal {1}}, .weight = 1}},
+        };
+
+        optimizer opti {std::move(m), strategy};
+        const auto res = opti.optimize();
+
+        REQUIRE_FALSE(res.has_value());
+        CHECK(res.error() == sat_error::unsatisfiable);
+    }
+
+    SECTION("variable only known by a cardinality constraint") {
+        optimization_model m {
+            .hard =
+                model {
+                       .literals      = {literal {1}},
+                       .clauses       = {{literal {1}}},
+                       .cardinalities = {{.literals = {literal {1}, literal {2}}, .at_most = 1}},
+                       },
+            .soft = {soft_clause {.literals = {literal {-1}}, .weight = 1}},
+        };
+
+        optimizer opti {std::move(m), strategy};
+        const auto res = opti.optimize();
+
+        REQUIRE(res.has_value()); // the relaxation literal of the soft clause is not the variable 2 of the cardinality constraint
+        CHECK(res->optimal);
+        CHECK(res->cost == 1);
+    }
+}
@@ -0,0 +1,109 @@
+// Dual Licensing Either :
+// - AGPL
+// or
+// - Subscription license for commercial usage (without requirement of licensing propagation).
+//   please contact ballandfys@protonmail.com for additional information about this subscription commercial licensing.
+//
+// Created by FyS on 18/10/26. License 2022-2026
+//
+// In the case no license has been purchased for the use (modification or distribution in any way) of the software stack
+// the APGL license is applying.
+//
+
+#include <algorithm>
+#include <random>
+#include <ranges>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include "common/logging.hh"
+#include "compiler/backend/sat/parallel_solver.hh"
+
+#include "sat_testcase_helpers.hh"
+
+using namespace fabko::compiler::sat;
+using namespace fabko::compiler::sat::testcase;
+
+namespace {
+
+/**
+ * @return random 3-SAT model of 3.8 clauses per variable : hard, yet below the satisfiability threshold (4.26 clauses per variable)
+ */
+model make_random_3sat(std::int64_t variables, std::uint64_t seed) {
+    std::mt19937_64 random {seed};
+    std::uniform_int_distribution<std::int64_t> variable {1, variables};
+    std::bernoulli_distribution negated {0.5};
+
+    model m;
+    for (std::int64_t var = 1; var <= variables; ++var) {
+        m.literals.emplace_back(var);
+    }
+    for (std::int64_t clause = 0; clause < variables * 19 / 5; ++clause) {
+        std::vector<literal> literals;
+        for (int lit = 0; lit < 3; ++lit) {
+            const auto var = variable(random);
+            literals.emplace_back(negated(random) ? -var : var);
+        }
+        m.clauses.push_back(std::move(literals));
+    }
+    return m;
+}
+
+} // namespace
+
+TEST_CASE("test parallel solver", "[compiler][backend][sat]") {
+    fabko::init_logger(spdlog::level::warn);
+
+    const auto threads = GENERATE(std::size_t {1}, std::size_t {2}, std::size_t {4});
+
+    SECTION("same answer on every run") {
+        const auto m = make_random_3sat(150, 11);
+        const parallel_configuration config {.threads = threads, .barrier_interval = 2000};
+
+        parallel_solver first {m, config};
+        const auto reference = first.solve();
+        REQUIRE(reference.has_value());
+        CHECK(satisfies(reference.value(), m));
+        CHECK(first.worker_count() == threads);
+
+        for (int run = 0; run < 3; ++run) {
+            parallel_solver again {m, config};
+            const auto res = again.solve();
+            REQUIRE(res.has_value());
+            CHECK(signed_values(res.value()) == signed_values(reference.value()));
+            CHECK(again.statistics().barriers == first.statistics().barriers);
+            CHECK(again.statistics().winner == first.statistics().winner);
+            CHECK(again.statistics().shared_clauses == first.statistics().shared_clauses);
+        }
+    }
+
+    SECTION("unsatisfiable :: clauses are shared at the barriers") {
+        parallel_solver s {make_pigeonhole(7, 6), {.threads = threads, .barrier_interval = 1000}};
+        const auto res = s.solve();
+        REQUIRE_FALSE(res.has_value());
+        CHECK(res.error() == sat_error::unsatisfiable);
+        CHECK(s.statistics().barriers > 1);
+        if (threads > 1) {
+            CHECK(s.statistics().shared_clauses > 0);
+        }
+    }
+
+    SECTION("budget counted over the workers") {
+        parallel_solver s {make_pigeonhole(9, 8), {.threads = threads, .barrier_interval = 1000}};
+        const auto res = s.solve({.propagation_budget = 5000});
+        REQUIRE_FALSE(res.has_value());
+        CHECK(res.error() == sat_error::unknown);
+        CHECK(s.statistics().barriers <= (5000 + threads * 1000 - 1) / (threads * 1000)); // each worker propagates at least 1000 times an epoch
+    }
+
+    SECTION("unknown if a worker stops before the end of its epoch") {
+        auto m              = make_pigeonhole(7, 6);
+        m.conf.memory_limit = 1; // the workers stop at the beginning of each epoch, the budgets never advance
+        parallel_solver s {std::move(m), {.threads = threads, .barrier_interval = 1000}};
+        const auto res = s.solve();
+        REQUIRE_FALSE(res.has_value());
+        CHECK(res.error() == sat_error::unknown);
+        CHECK(s.statistics().barriers == 1);
+    }
+}
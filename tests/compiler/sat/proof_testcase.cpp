@@ -0,0 +1,272 @@
+// Dual Licensing Either :
+// - AGPL
+// or
+// - Subscription license for commercial usage (without requirement of licensing propagation).
+//   please contact ballandfys@protonmail.com for additional information about this subscription commercial licensing.
+//
+// Created by FyS on 18/10/26. License 2022-2026
+//
+// In the case no license has been purchased for the use (modification or distribution in any way) of the software stack
+// the APGL license is applying.
+//
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <sstream>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include "common/logging.hh"
+#include "compiler/backend/sat/solver.hh"
+
+using namespace fabko::compiler::sat;
+
+namespace {
+
+using dimacs_clause = std::vector<std::int64_t>;
+
+struct proof_step {
+    bool deletion;
+    dimacs_clause clause;
+};
+
+/**
+ * @return pigeonhole formula with sparse variables (to exercise the renumbering of the solver) : 100 + pigeon * holes + hole
+ */
+std::vector<dimacs_clause> make_pigeonhole(std::int64_t pigeons, std::int64_t holes) {
+    auto var = [holes](std::int64_t pigeon, std::int64_t hole) { return 100 + pigeon * holes + hole; };
+    std::vector<dimacs_clause> formula;
+    for (std::int64_t p = 0; p < pigeons; ++p) {
+        dimacs_clause somewhere;
+        for (std::int64_t h = 0; h < holes; ++h) {
+            somewhere.push_back(var(p, h));
+        }
+        formula.push_back(std::move(somewhere));
+    }
+    for (std::int64_t h = 0; h < holes; ++h) {
+        for (std::int64_t p = 0; p < pigeons; ++p) {
+            for (std::int64_t q = p + 1; q < pigeons; ++q) {
+                formula.push_back({-var(p, h), -var(q, h)});
+            }
+        }
+    }
+    return formula;
+}
+
+model to_model(const std::vector<dimacs_clause>& formula) {
+    model m;
+    for (const auto& clause : formula) {
+        for (const auto lit : clause) {
+            if (std::ranges::none_of(m.literals, [lit](const literal& known) { return known.value() == std::abs(lit); })) {
+                m.literals.emplace_back(std::abs(lit));
+            }
+        }
+        m.clauses.push_back(clause | std::views::transform([](std::int64_t lit) { return literal {lit}; }) | std::ranges::to<std::vector>());
+    }
+    return m;
+}
+
+std::string read_file(const std::filesystem::path& path) {
+    std::ifstream in {path, std::ios::binary};
+    return std::string {std::istreambuf_iterator<char> {in}, std::istreambuf_iterator<char> {}};
+}
+
+std::vector<proof_step> parse_drat(const std::string& data) {
+    std::vector<proof_step> steps;
+    std::istringstream in {data};
+    std::string line;
+    while (std::getline(in, line)) {
+        std::istringstream line_in {line};
+        proof_step step {.deletion = line.starts_with("d "), .clause = {}};
+        if (step.deletion) {
+            line_in.ignore(2);
+        }
+        for (std::int64_t lit; line_in >> lit && lit != 0;) {
+            step.clause.push_back(lit);
+        }
+        steps.push_back(std::move(step));
+    }
+    return steps;
+}
+
+std::vector<proof_step> parse_binary_drat(const std::string& data) {
+    std::vector<proof_step> steps;
+    std::size_t index = 0;
+    while (index < data.size()) {
+        proof_step step {.deletion = data[index++] == 'd', .clause = {}};
+        while (true) {
+            std::uint64_t encoded = 0;
+            int shift             = 0;
+            std::uint8_t byte     = 0;
+            do {
+                byte = static_cast<std::uint8_t>(data[index++]);
+                encoded |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+                shift += 7;
+            } while ((byte & 0x80) != 0);
+            if (encoded == 0) {
+                break;
+            }
+            const auto var = static_cast<std::int64_t>(encoded >> 1);
+            step.clause.push_back((encoded & 1) != 0 ? -var : var);
+        }
+        steps.push_back(std::move(step));
+    }
+    return steps;
+}
+
+/**
+ * @return true if unit propagation over the clauses, with the lemma assumed false, leads to a conflict (RUP : Reverse Unit Propagation)
+ */
+bool is_rup(const std::vector<dimacs_clause>& clauses, const dimacs_clause& lemma) {
+    std::map<std::int64_t, bool> values;
+    for (const auto lit : lemma) {
+        values[std::abs(lit)] = lit < 0;
+    }
+    auto value_of = [&values](std::int64_t lit) -> std::optional<bool> {
+        const auto it = values.find(std::abs(lit));
+        return it == values.end() ? std::nullopt : std::optional {it->second == (lit > 0)};
+    };
+
+    for (bool propagated = true; propagated;) {
+        propagated = false;
+        for (const auto& clause : clauses) {
+            if (std::ranges::any_of(clause, [&](std::int64_t lit) { return value_of(lit) == true; })) {
+                continue;
+            }
+            const auto unassigned = std::ranges::count_if(clause, [&](std::int64_t lit) { return !value_of(lit).has_value(); });
+            if (unassigned == 0) {
+                return true;
+            }
+            if (unassigned == 1) {
+                const auto unit        = *std::ranges::find_if(clause, [&](std::int64_t lit) { return !value_of(lit).has_value(); });
+                values[std::abs(unit)] = unit > 0;
+                propagated             = true;
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief stand-in of a DRAT checker (as drat-trim) : every lemma has to be RUP, and the proof has to conclude with the empty clause
+ * @note the checker is a naive forward checker that does not handle RAT lemmas (the solver only produces RUP lemmas)
+ */
+bool check_proof(std::vector<dimacs_clause> clauses, const std::vector<proof_step>& proof) {
+    for (const auto& [deletion, clause] : proof) {
+        if (deletion) {
+            auto sorted = clause;
+            std::ranges::sort(sorted);
+            const auto it = std::ranges::find_if(clauses, [&sorted](dimacs_clause candidate) {
+                std::ranges::sort(candidate);
+                return candidate == sorted;
+            });
+            if (it != clauses.end()) {
+                clauses.erase(it);
+            }
+            continue;
+        }
+        if (!is_rup(clauses, clause)) {
+            return false;
+        }
+        if (clause.empty()) {
+            return true;
+        }
+        clauses.push_back(clause);
+    }
+    return false;
+}
+
+} // namespace
+
+TEST_CASE("test solver proof", "[compiler][backend][sat]") {
+    fabko::init_logger(spdlog::level::warn);
+
+    const auto format = GENERATE(proof_format::drat, proof_format::binary_drat);
+    const auto parse  = [format](const std::string& data) { return format == proof_format::drat ? parse_drat(data) : parse_binary_drat(data); };
+    const auto path   = std::filesystem::temp_directory_path() / "fabko_solver_proof_testcase.drat";
+
+    SECTION("unsatisfiable :: the proof is accepted by the checker") {
+        const auto formula = make_pigeonhole(5, 4);
+        solver s {to_model(formula)};
+        REQUIRE(s.start_proof(path, format).has_value());
+
+        const auto res = s.solve_next();
+        REQUIRE_FALSE(res.has_value());
+        CHECK(res.error() == sat_error::unsatisfiable);
+        REQUIRE(s.close_proof().has_value());
+
+        const auto proof = parse(read_file(path));
+        REQUIRE_FALSE(proof.empty());
+        CHECK(proof.back().clause.empty());
+        CHECK(check_proof(formula, proof));
+
+        // a lemma that is not implied by the formula is rejected by the checker
+        auto tampered = proof;
+        tampered.insert(tampered.begin(), proof_step {.deletion = false, .clause = {100}});
+        CHECK_FALSE(check_proof(formula, tampered));
+    }
+
+    SECTION("unsatisfiable with reductions :: the deleted learned clauses are written into the proof") {
+        const auto formula     = make_pigeonhole(5, 4);
+        auto m                 = to_model(formula);
+        m.conf.reduce_interval = 10;
+        m.conf.reduce_glue_lbd = 1;
+        solver s {std::move(m)};
+        REQUIRE(s.start_proof(path, format).has_value());
+
+        REQUIRE(s.solve_next().error() == sat_error::unsatisfiable);
+        REQUIRE(s.close_proof().has_value());
+        REQUIRE(s.statistics().conflicts >= 10);
+        CHECK(s.statistics().reductions > 0);
+        CHECK(s.statistics().deleted_clause > 0);
+
+        const auto proof = parse(read_file(path));
+        CHECK(static_cast<std::size_t>(std::ranges::count_if(proof, &proof_step::deletion)) == s.statistics().deleted_clause);
+        CHECK(check_proof(formula, proof));
+    }
+
+    SECTION("satisfiable :: the proof is not concluded by the empty clause") {
+        const auto formula = make_pigeonhole(4, 4);
+        solver s {to_model(formula)};
+        REQUIRE(s.start_proof(path, format).has_value());
+
+        REQUIRE(s.solve_next().has_value());
+        REQUIRE(s.close_proof().has_value());
+        CHECK_FALSE(check_proof(formula, parse(read_file(path))));
+    }
+
+    SECTION("writer :: clauses submitted through several buffers are written in order") {
+        auto writer = proof_writer::open(path, format, 16); // small buffers : the writer thread writes while clauses are added
+        REQUIRE(writer.has_value());
+
+        std::vector<proof_step> expected;
+        for (std::int64_t i = 1; i <= 1000; ++i) {
+            proof_step step {.deletion = i % 7 == 0, .clause = {i, -(i + 1), i * 1000}};
+            if (step.deletion) {
+                writer.value()->remove(step.clause);
+            } else {
+                writer.value()->add(step.clause);
+            }
+            expected.push_back(std::move(step));
+        }
+        CHECK(writer.value()->lemmas() + writer.value()->deletions() == expected.size());
+        REQUIRE(writer.value()->close().has_value());
+
+        const auto written = parse(read_file(path));
+        REQUIRE(written.size() == expected.size());
+        for (std::size_t i = 0; i < expected.size(); ++i) {
+            CHECK(written[i].deletion == expected[i].deletion);
+            CHECK(written[i].clause == expected[i].clause);
+        }
+    }
+
+    SECTION("invalid path") {
+        solver s {to_model(make_pigeonhole(2, 2))};
+        CHECK(s.start_proof("/non/existing/directory/proof.drat", format).error() == proof_error::io_error);
+    }
+
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,72 @@
+// Dual Licensing Either :
+// - AGPL
+// or
+// - Subscription license for commercial usage (without requirement of licensing propagation).
+//   please contact ballandfys@protonmail.com for additional information about this subscription commercial licensing.
+//
+// Created by FyS on 18/10/26. License 2022-2026
+//
+// In the case no license has been purchased for the use (modification or distribution in any way) of the software stack
+// the APGL license is applying.
+//
+
+#ifndef SAT_TESTCASE_HELPERS_HH
+#define SAT_TESTCASE_HELPERS_HH
+
+#include <algorithm>
+#include <cstdint>
+#include <ranges>
+#include <vector>
+
+#include "compiler/backend/sat/solver.hh"
+
+namespace fabko::compiler::sat::testcase {
+
+/**
+ * @return pigeonhole model : 'pigeons' pigeons in 'holes' holes, variable (pigeon * holes + hole + 1) is true if the pigeon is in the hole
+ */
+inline model make_pigeonhole(std::int64_t pigeons, std::int64_t holes) {
+    auto var = [holes](std::int64_t pigeon, std::int64_t hole) { return literal {pigeon * holes + hole + 1}; };
+    model m;
+    for (std::int64_t p = 0; p < pigeons; ++p) {
+        std::vector<literal> somewhere;
+        for (std::int64_t h = 0; h < holes; ++h) {
+            m.literals.push_back(var(p, h));
+            somewhere.push_back(var(p, h));
+        }
+        m.clauses.push_back(std::move(somewhere));
+    }
+    for (std::int64_t h = 0; h < holes; ++h) {
+        for (std::int64_t p = 0; p < pigeons; ++p) {
+            for (std::int64_t q = p + 1; q < pigeons; ++q) {
+                m.clauses.push_back({var(p, h).negation(), var(q, h).negation()});
+            }
+        }
+    }
+    return m;
+}
+
+/**
+ * @return signed values of the literals of a result (negative if the literal is off), literals are compared on their variable only
+ */
+inline std::vector<std::int64_t> signed_values(const solver::result& res) {
+    return res.literals | std::views::transform([](const literal& l) { return l.is_on() ? l.value() : -l.value(); }) | std::ranges::to<std::vector>();
+}
+
+/**
+ * @return true if every clause has a literal assigned to its polarity in the solution
+ */
+inline bool satisfies(const std::vector<std::vector<literal>>& clauses, const std::vector<literal>& solution) {
+    return std::ranges::all_of(clauses, [&solution](const std::vector<literal>& clause) {
+        return std::ranges::any_of(clause, [&solution](const literal& lit) {
+            const auto it = std::ranges::find(solution, lit); // literals are compared on their variable
+            return it != solution.end() && it->is_on() == lit.is_on();
+        });
+    });
+}
+
+inline bool satisfies(const solver::result& res, const model& m) { return satisfies(m.clauses, res.literals); }
+
+} // namespace fabko::compiler::sat::testcase
+
+#endif // SAT_TESTCASE_HELPERS_HH
@@ -0,0 +1,144 @@
+// Dual Licensing Either :
+// - AGPL
+// or
+// - Subscription license for commercial usage (without requirement of licensing propagation).
+//   please contact ballandfys@protonmail.com for additional information about this subscription commercial licensing.
+//
+// Created by FyS on 18/10/26. License 2022-2026
+//
+// In the case no license has been purchased for the use (modification or distribution in any way) of the software stack
+// the APGL license is applying.
+//
+
+#include <algorithm>
+#include <limits>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include "common/logging.hh"
+#include "compiler/backend/sat/solver.hh"
+
+#include "sat_testcase_helpers.hh"
+
+using namespace fabko::compiler::sat;
+using namespace fabko::compiler::sat::testcase;
+
+TEST_CASE("test solver profiles", "[compiler][backend][sat]") {
+    fabko::init_logger(spdlog::level::warn);
+
+    const auto profile = GENERATE(solver_profile::dynamic, solver_profile::planning, solver_profile::unsat_heavy, solver_profile::minimal);
+
+    SECTION("unsatisfiable") {
+        auto m         = make_pigeonhole(5, 4);
+        m.conf.profile = profile;
+        solver s {std::move(m)};
+        CHECK(s.solve_next().error() == sat_error::unsatisfiable);
+    }
+
+    SECTION("satisfiable :: every solution is enumerated") {
+        // 3 pigeons in 3 holes : one solution per permutation
+        auto m             = make_pigeonhole(3, 3);
+        const auto clauses = m.clauses;
+        m.conf.profile     = profile;
+        solver s {std::move(m)};
+
+        const auto results = s.solve();
+        CHECK(results.size() == 6);
+        CHECK(std::ranges::all_of(results, [&clauses](const solver::result& res) { return satisfies(clauses, res.literals); }));
+    }
+
+    SECTION("assumptions") {
+        auto m         = make_pigeonhole(3, 3);
+        m.conf.profile = profile;
+        solver s {std::move(m)};
+
+        const std::vector<literal> same_hole {literal {1}, literal {4}}; // pigeons 0 and 1 in hole 0
+        CHECK(s.solve_with_assumptions(same_hole).error() == sat_error::unsatisfiable);
+        const std::vector<literal> distinct_holes {literal {1}, literal {5}};
+        CHECK(s.solve_with_assumptions(distinct_holes).has_value());
+    }
+}
+
+TEST_CASE("test solver profile names", "[compiler][backend][sat]") {
+    CHECK(profile_from_name("dynamic") == solver_profile::dynamic);
+    CHECK(profile_from_name("planning") == solver_profile::planning);
+    CHECK(profile_from_name("unsat-heavy") == solver_profile::unsat_heavy);
+    CHECK(profile_from_name("minimal") == solver_profile::minimal);
+    CHECK_FALSE(profile_from_name("unsat_heavy").has_value());
+}
+
+TEST_CASE("test learned clause reduction", "[compiler][backend][sat]") {
+    fabko::init_logger(spdlog::level::warn);
+
+    SECTION("the answer is kept while the learned clauses are deleted") {
+        auto reduced                 = make_pigeonhole(6, 5);
+        reduced.conf.reduce_interval = 5;
+        solver s {std::move(reduced)};
+
+        CHECK(s.solve_next().error() == sat_error::unsatisfiable);
+        CHECK(s.statistics().reductions > 0);
+        CHECK(s.statistics().deleted_clause > 0);
+        CHECK(s.learned_clauses().size() + s.statistics().deleted_clause == s.statistics().learned_clause);
+    }
+
+    SECTION("glue clauses are never deleted") {
+        auto reduced                 = make_pigeonhole(6, 5);
+        reduced.conf.reduce_interval = 5;
+        reduced.conf.reduce_glue_lbd = std::numeric_limits<std::uint32_t>::max();
+        solver s {std::move(reduced)};
+
+        CHECK(s.solve_next().error() == sat_error::unsatisfiable);
+        CHECK(s.statistics().deleted_clause == 0);
+    }
+}
+
+TEST_CASE("test solver memory limit", "[compiler][backend][sat]") {
+    fabko::init_logger(spdlog::level::warn);
+
+    // memory of the solver before any conflict (the resolution is stopped right away by the conflict budget)
+    auto model_memory = [] {
+        auto m              = make_pigeonhole(6, 5);
+        m.conf.memory_limit = std::numeric_limits<std::size_t>::max();
+        solver s {std::move(m)};
+        CHECK(s.solve_next({.conflict_budget = 0}).error() == sat_error::unknown);
+        return s.statistics().memory_bytes;
+    };
+
+    SECTION("memory accounted by category") {
+        auto m                       = make_pigeonhole(6, 5);
+        m.conf.memory_limit          = std::numeric_limits<std::size_t>::max();
+        m.conf.memory_check_interval = 10;
+        solver s {std::move(m)};
+
+        CHECK(s.solve_next().error() == sat_error::unsatisfiable);
+        const auto& stats = s.statistics();
+        CHECK(stats.clause_bytes > 0);
+        CHECK(stats.learned_clause_bytes > 0);
+        CHECK(stats.watcher_bytes > 0);
+        CHECK(stats.memory_bytes > stats.clause_bytes + stats.learned_clause_bytes + stats.watcher_bytes + stats.trail_bytes);
+        CHECK(stats.peak_memory_bytes >= stats.memory_bytes);
+        CHECK(stats.memory_reductions == 0);
+    }
+
+    SECTION("learned clauses reduced above the limit") {
+        auto m                       = make_pigeonhole(6, 5);
+        m.conf.memory_limit          = model_memory() + 2048;
+        m.conf.memory_check_interval = 1;
+        solver s {std::move(m)};
+
+        CHECK_FALSE(s.solve_next().has_value()); // unsatisfiable, or unknown if the reductions cannot keep the memory under the limit
+        CHECK(s.statistics().memory_reductions > 0);
+        CHECK(s.statistics().deleted_clause > 0);
+    }
+
+    SECTION("unknown if the model alone exceeds the limit") {
+        auto m              = make_pigeonhole(6, 5);
+        m.conf.memory_limit = model_memory() / 2;
+        solver s {std::move(m)};
+
+        CHECK(s.solve_next().error() == sat_error::unknown);
+        CHECK(s.statistics().conflicts == 0);
+        CHECK(s.statistics().memory_reductions == 0);
+    }
+}
@@ -0,0 +1,466 @@
+// Dual Licensing Either :
+// - AGPL
+// or
+// - Subscription license for commercial usage (without requirement of licensing propagation).
+//   please contact ballandfys@protonmail.com for additional information about this subscription commercial licensing.
+//
+// Created by FyS on 18/10/26. License 2022-2026
+//
+// In the case no license has been purchased for the use (modification or distribution in any way) of the software stack
+// the APGL license is applying.
+//
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <ranges>
+#include <stop_token>
+#include <thread>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include "common/logging.hh"
+#include "compiler/backend/sat/solver.hh"
+
+#include "sat_testcase_helpers.hh"
+
+using namespace fabko::compiler::sat;
+using namespace fabko::compiler::sat::testcase;
+
+TEST_CASE("test solver backtracking strategies", "[compiler][backend][sat]") {
+    fabko::init_logger(spdlog::level::warn);
+
+    // chronological backtracking on every backjump of more than one level, and frequent restarts to exercise the trail reuse
+    const auto chrono_threshold = GENERATE(std::size_t {0}, std::size_t {1});
+    const auto trail_reuse      = GENERATE(false, true);
+
+    auto configure = [&](model m) {
+        m.conf.chrono_backtrack_threshold = chrono_threshold;
+        m.conf.restart_trail_reuse        = trail_reuse;
+        m.conf.restart_threshold          = 2;
+        m.conf.restart_multiplier         = 1;
+        return m;
+    };
+
+    SECTION("pigeonhole :: 5 pigeons in 4 holes is unsatisfiable") {
+        solver s {configure(make_pigeonhole(5, 4))};
+        const auto res = s.solve_next();
+        REQUIRE_FALSE(res.has_value());
+        CHECK(res.error() == sat_error::unsatisfiable);
+    }
+
+    SECTION("pigeonhole :: 4 pigeons in 4 holes is satisfiable") {
+        const auto m = configure(make_pigeonhole(4, 4));
+        solver s {m};
+        const auto res = s.solve_next();
+        REQUIRE(res.has_value());
+        CHECK(satisfies(res.value(), m));
+    }
+}
+
+TEST_CASE("test solver statistics", "[compiler][backend][sat]") {
+    fabko::init_logger(spdlog::level::warn);
+
+    SECTION("measured at the end of the resolution") {
+        auto m                   = make_pigeonhole(4, 4);
+        m.conf.progress_interval = 0;
+        solver s {std::move(m)};
+
+        REQUIRE(s.solve_next().has_value());
+        const auto& stats = s.statistics();
+        CHECK(stats.trail_depth == 16); // every variable is assigned in a solution
+        CHECK(stats.max_trail_depth == 16);
+        CHECK(stats.memory_bytes > 0);
+        CHECK(stats.peak_memory_bytes >= stats.memory_bytes);
+    }
+
+    SECTION("progress reported every progress interval") {
+        auto m                     = make_pigeonhole(5, 4);
+        m.conf.progress_interval   = 10;
+        std::size_t reports        = 0;
+        std::size_t last_conflicts = 0;
+        m.conf.progress_callback   = [&](const solver_context::Statistics& stats) {
+            ++reports;
+            last_conflicts = stats.conflicts;
+            CHECK(stats.memory_bytes > 0);
+        };
+        solver s {std::move(m)};
+
+        CHECK(s.solve_next().error() == sat_error::unsatisfiable);
+        CHECK(reports == s.statistics().conflicts / 10);
+        CHECK(last_conflicts == reports * 10);
+    }
+}
+
+TEST_CASE("test solver limits", "[compiler][backend][sat]") {
+    fabko::init_logger(spdlog::level::warn);
+
+    // far beyond the reach of the solver in the time of a test : only the limits can end the resolution
+    solver s {make_pigeonhole(12, 11)};
+
+    SECTION("stop requested before the resolution") {
+        std::stop_source stop;
+        stop.request_stop();
+        CHECK(s.solve_next({.stop_token = stop.get_token()}).error() == sat_error::unknown);
+    }
+
+    SECTION("stop requested during the resolution") {
+        std::stop_source stop;
+        std::jthread canceller {[&stop] {
+            std::this_thread::sleep_for(std::chrono::milliseconds {50});
+            stop.request_stop();
+        }};
+        CHECK(s.solve_next({.stop_token = stop.get_token()}).error() == sat_error::unknown);
+        CHECK(s.statistics().conflicts > 0);
+    }
+
+    SECTION("deadline") {
+        const auto start = std::chrono::steady_clock::now();
+        CHECK(s.solve_next(solve_limits::with_time_limit(std::chrono::milliseconds {50})).error() == sat_error::unknown);
+        CHECK(std::chrono::steady_clock::now() - start < std::chrono::seconds {10});
+    }
+
+    SECTION("conflict budget") {
+        CHECK(s.solve_next({.conflict_budget = 100}).error() == sat_error::unknown);
+        CHECK(s.statistics().conflicts == 100);
+    }
+}
+
+TEST_CASE("test solver variable renumbering", "[compiler][backend][sat]") {
+    fabko::init_logger(spdlog::level::warn);
+
+    // sparse variable identifiers, variable 7 is only referenced by a clause
+    const model m {
+        .literals = {literal {1000}, literal {42}, literal {1'000'000}},
+        .clauses  = {{literal {-1000}, literal {42}}, {literal {1000}}, {literal {-42}, literal {-1'000'000}, literal {7}}, {literal {1'000'000}}},
+    };
+    solver s {m};
+
+    const auto res = s.solve_next();
+    REQUIRE(res.has_value());
+    CHECK(res->literals.size() == 4);
+    CHECK(satisfies(res.value(), m));
+    CHECK(std::ranges::contains(res->literals, literal {7}));
+
+    SECTION("assumptions and unsat core are expressed with the model variables") {
+        const std::vector assumptions {literal {-7}};
+        CHECK_FALSE(s.solve_with_assumptions(assumptions).has_value());
+        REQUIRE(s.unsat_core().size() == 1);
+        CHECK(s.unsat_core().front().value() == 7);
+        CHECK(s.unsat_core().front().is_off());
+    }
+
+    SECTION("added clauses on new variables") {
+        s.add_clause({literal {-7}, literal {-123456}});
+        const auto next = s.solve_next();
+        REQUIRE(next.has_value());
+        const auto it = std::ranges::find(next->literals, literal {123456});
+        REQUIRE(it != next->literals.end());
+        CHECK(it->is_off());
+    }
+}
+
+TEST_CASE("test solver backbone", "[compiler][backend][sat]") {
+    fabko::init_logger(spdlog::level::warn);
+
+    auto signed_values = [](const std::vector<literal>& literals) {
+        return literals | std::views::transform([](const literal& l) { return l.is_off() ? -l.value() : l.value(); }) | std::ranges::to<std::vector>();
+    };
+
+    SECTION("forced literals are found without enumerating the solutions") {
+        // 10 is forced by the two first clauses (not by unit propagation), 30 and -60 follow from it, 70 is a unit clause
+        const model m {
+            .literals = {literal {10}, literal {20}, literal {30}, literal {40}, literal {50}, literal {60}, literal {70}},
+            .clauses  = {{literal {10}, literal {20}},
+                         {literal {10}, literal {-20}},
+                         {literal {-10}, literal {30}},
+                         {literal {-30}, literal {-60}},
+                         {literal {40}, literal {50}},
+                         {literal {70}}},
+        };
+        solver s {m};
+
+        const auto backbone = s.backbone();
+        REQUIRE(backbone.has_value());
+        CHECK(signed_values(backbone.value()) == std::vector<std::int64_t> {10, 30, -60, 70});
+
+        const std::vector subset {literal {40}, literal {50}, literal {60}, literal {12345}};
+        const auto subset_backbone = s.backbone(subset);
+        REQUIRE(subset_backbone.has_value());
+        CHECK(signed_values(subset_backbone.value()) == std::vector<std::int64_t> {-60});
+
+        // the solver is still usable : the backbone holds in its solutions
+        const auto res = s.solve_next();
+        REQUIRE(res.has_value());
+        CHECK(satisfies(res.value(), m));
+        CHECK(std::ranges::find(res->literals, literal {10})->is_on());
+    }
+
+    SECTION("pigeonhole :: no literal is forced until a pigeon is placed") {
+        auto m = make_pigeonhole(3, 3);
+        solver s {m};
+        const auto free_backbone = s.backbone();
+        REQUIRE(free_backbone.has_value());
+        CHECK(free_backbone->empty());
+
+        s.add_clause({literal {1}}); // pigeon 0 in hole 0 : the other pigeons are not in hole 0, pigeon 0 is in no other hole
+        const auto backbone = s.backbone();
+        REQUIRE(backbone.has_value());
+        CHECK(signed_values(backbone.value()) == std::vector<std::int64_t> {1, -2, -3, -4, -7});
+    }
+
+    SECTION("unsatisfiable") {
+        solver s {make_pigeonhole(4, 3)};
+        CHECK(s.backbone().error() == sat_error::unsatisfiable);
+    }
+}
+
+TEST_CASE("test solver minimal unsat core", "[compiler][backend][sat]") {
+    fabko::init_logger(spdlog::level::warn);
+
+    auto signed_values = [](const std::vector<literal>& literals) {
+        return literals | std::views::transform([](const literal& l) { return l.is_off() ? -l.value() : l.value(); }) | std::ranges::to<std::vector>();
+    };
+
+    SECTION("clauses out of the conflict are not part of the core") {
+        // {10}, {-10, 20} and {-20} clash, the other clauses are satisfiable with them (and {10, 30} is implied by {10})
+        const std::vector<std::vector<literal>> clauses {
+            {literal {10}, literal {30}},
+            {literal {10}},
+            {literal {40}, literal {50}},
+            {literal {-10}, literal {20}},
+            {literal {-40}, literal {60}},
+            {literal {-20}},
+        };
+        solver s {model {.literals = {literal {10}, literal {20}, literal {30}, literal {40}, literal {50}, literal {60}}, .clauses = clauses}};
+
+        const auto core = s.minimal_unsat_core();
+        REQUIRE(core.has_value());
+        REQUIRE(core->size() == 3);
+        const auto core_literals = core.value() | std::views::transform([&](const core_clause& c) {
+            auto values = signed_values(c.literals);
+            std::ranges::sort(values);
+            return values;
+        }) | std::ranges::to<std::vector>();
+        CHECK(std::ranges::contains(core_literals, std::vector<std::int64_t> {10}));
+        CHECK(std::ranges::contains(core_literals, std::vector<std::int64_t> {-10, 20}));
+        CHECK(std::ranges::contains(core_literals, std::vector<std::int64_t> {-20}));
+
+        // minimal : removing any clause of the core makes it satisfiable
+        for (std::size_t removed = 0; removed < core->size(); ++removed) {
+            model sub {.literals = {literal {10}, literal {20}}, .clauses = {}};
+            for (std::size_t index = 0; index < core->size(); ++index) {
+                if (index != removed) {
+                    sub.clauses.push_back((*core)[index].literals);
+                }
+            }
+            solver sub_solver {std::move(sub)};
+            CHECK(sub_solver.solve_next().has_value());
+        }
+    }
+
+    SECTION("pigeonhole :: every clause is necessary") {
+        auto m             = make_pigeonhole(3, 2);
+        const auto clauses = m.clauses.size();
+        solver s {std::move(m)};
+        const auto core = s.minimal_unsat_core();
+        REQUIRE(core.has_value());
+        CHECK(core->size() == clauses);
+    }
+
+    SECTION("clauses of the core are mapped to their FABL construct") {
+        model m {
+            .literals        = {literal {1}, literal {2}, literal {3}},
+            .clauses         = {{literal {1}}, {literal {-1}, literal {2}}, {literal {3}}, {literal {-2}}},
+            .literal_context = {
+                {literal {1}, {.lexeme = "capability", .unit = "agent.fabl", .line = 3}},
+                {literal {2}, {.lexeme = "precondition", .unit = "agent.fabl", .line = 7}},
+            },
+        };
+        solver s {std::move(m)};
+        const auto core = s.minimal_unsat_core();
+        REQUIRE(core.has_value());
+        REQUIRE(core->size() == 3);
+        for (const auto& [literals, origin] : core.value()) {
+            REQUIRE(origin.has_value());
+            CHECK(origin->unit == "agent.fabl");
+            CHECK(origin->line == (std::ranges::contains(literals, literal {1}) ? 3U : 7U));
+        }
+    }
+
+    SECTION("satisfiable :: no core") {
+        solver s {model {.literals = {literal {1}, literal {2}}, .clauses = {{literal {1}, literal {2}}, {literal {-1}}}}};
+        const auto core = s.minimal_unsat_core();
+        REQUIRE(core.has_value());
+        CHECK(core->empty());
+    }
+}
+
+TEST_CASE("test solver snapshot", "[compiler][backend][sat]") {
+    fabko::init_logger(spdlog::level::warn);
+
+    const auto path = std::filesystem::temp_directory_path() / "fabko_solver_snapshot_testcase.bin";
+
+    SECTION("resume an interrupted resolution") {
+        solver s {make_pigeonhole(6, 5)};
+        const auto interrupted = s.solve_next(solve_limits {.conflict_budget = 10});
+        REQUIRE_FALSE(interrupted.has_value());
+        CHECK(interrupted.error() == sat_error::unknown);
+        REQUIRE(s.save_snapshot(path).has_value());
+
+        auto snap = snapshot::open(path);
+        REQUIRE(snap.has_value());
+        CHECK(snap->header().variable_count == 30);
+        CHECK(snap->header().statistics.conflicts == s.statistics().conflicts);
+        const auto learned = std::ranges::count(snap->constraints(), snapshot_constraint_kind::learned_clause, &snapshot_constraint::kind);
+        CHECK(learned == static_cast<std::ptrdiff_t>(s.statistics().learned_clause));
+
+        solver resumed {snap.value()};
+        CHECK(resumed.statistics().conflicts == s.statistics().conflicts);
+        const auto res = resumed.solve_next();
+        REQUIRE_FALSE(res.has_value());
+        CHECK(res.error() == sat_error::unsatisfiable);
+    }
+
+    SECTION("reduction and memory statistics are restored") {
+        auto m                 = make_pigeonhole(6, 5);
+        m.conf.reduce_interval = 5;
+        solver s {std::move(m)};
+        REQUIRE(s.solve_next(solve_limits {.conflict_budget = 50}).error() == sat_error::unknown);
+        REQUIRE(s.statistics().deleted_clause > 0);
+        REQUIRE(s.save_snapshot(path).has_value());
+
+        auto snap = snapshot::open(path);
+        REQUIRE(snap.has_value());
+        solver resumed {snap.value()};
+        CHECK(resumed.statistics().reductions == s.statistics().reductions);
+        CHECK(resumed.statistics().deleted_clause == s.statistics().deleted_clause);
+        CHECK(resumed.learned_clauses().size() + resumed.statistics().deleted_clause == resumed.statistics().learned_clause);
+        CHECK(resumed.statistics().peak_memory_bytes == s.statistics().peak_memory_bytes);
+        CHECK(resumed.statistics().memory_reductions == s.statistics().memory_reductions);
+    }
+
+    SECTION("sparse variables and incremental clauses are restored") {
+        const model m {
+            .literals = {literal {1000}, literal {42}},
+            .clauses  = {{literal {-1000}, literal {42}}},
+        };
+        solver s {m};
+        s.add_clause({literal {1000}});
+        s.add_cardinality({.literals = {literal {42}, literal {77}, literal {78}}, .at_most = 1});
+        REQUIRE(s.save_snapshot(path).has_value());
+
+        auto snap = snapshot::open(path);
+        REQUIRE(snap.has_value());
+        solver resumed {snap.value()};
+        const auto res = resumed.solve_next();
+        REQUIRE(res.has_value());
+        CHECK(std::ranges::find(res->literals, literal {1000})->is_on());
+        CHECK(std::ranges::find(res->literals, literal {42})->is_on());
+        CHECK(std::ranges::find(res->literals, literal {77})->is_off());
+        CHECK(std::ranges::find(res->literals, literal {78})->is_off());
+    }
+
+    SECTION("invalid snapshot file") {
+        std::ofstream {path, std::ios::binary | std::ios::trunc} << "not a snapshot";
+        const auto snap = snapshot::open(path);
+        REQUIRE_FALSE(snap.has_value());
+        CHECK(snap.error() == snapshot_error::invalid_format);
+    }
+
+    SECTION("literal of an undefined variable") {
+        const std::vector<snapshot_variable> variables {{.external = 1}, {.external = 2}};
+        const std::vector<snapshot_constraint> constraints {{.first_literal = 0, .size = 2, .kind = snapshot_constraint_kind::learned_clause}};
+        for (const auto& literals : {std::vector<std::int64_t> {1, 3}, std::vector<std::int64_t> {-3, 2}, std::vector<std::int64_t> {0, 2}}) {
+            REQUIRE(write_snapshot(path, {}, variables, constraints, literals).has_value());
+
+            const auto snap = snapshot::open(path);
+            REQUIRE_FALSE(snap.has_value());
+            CHECK(snap.error() == snapshot_error::invalid_format);
+        }
+    }
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("test solver builder", "[compiler][backend][sat]") {
+    fabko::init_logger(spdlog::level::warn);
+
+    SECTION("clauses are ingested from a re-used buffer") {
+        const auto m = make_pigeonhole(4, 4);
+        solver_builder builder;
+        builder.reserve(m.literals.size(), m.clauses.size());
+
+        std::vector<literal> buffer;
+        for (const auto& clause : m.clauses) {
+            buffer.assign(clause.begin(), clause.end());
+            builder.add_clause(buffer);
+        }
+        auto s         = std::move(builder).build();
+        const auto res = s.solve_next();
+        REQUIRE(res.has_value());
+        CHECK(satisfies(res.value(), m));
+    }
+
+    SECTION("cnf file is parsed into the solver") {
+        const auto path = std::filesystem::temp_directory_path() / "fabko_solver_builder_testcase.cnf";
+        std::ofstream {path} << "c pigeonhole 3 pigeons in 2 holes\n"
+                                "p cnf 6 9\n"
+                                "1 2 0\n3 4 0\n5 6 0\n"
+                                "-1 -3 0\n-1 -5 0\n-3 -5 0\n"
+                                "-2 -4 0\n-2 -6 0\n-4 -6 0\n";
+        auto s         = make_solver_from_cnf_file(path);
+        const auto res = s.solve_next();
+        REQUIRE_FALSE(res.has_value());
+        CHECK(res.error() == sat_error::unsatisfiable);
+        std::filesystem::remove(path);
+    }
+
+    SECTION("cnf file is parsed in parallel chunks") {
+        const auto m    = make_pigeonhole(4, 4);
+        const auto path = std::filesystem::temp_directory_path() / "fabko_solver_builder_parallel_testcase.cnf";
+        {
+            // every other clause spans over two lines, with a comment in between : the chunks are split in the middle of the clauses
+            std::ofstream file {path};
+            file << "c pigeonhole 4 pigeons in 4 holes\np cnf " << m.literals.size() << " " << m.clauses.size() << "\n";
+            for (std::size_t index = 0; index < m.clauses.size(); ++index) {
+                for (const auto& lit : m.clauses[index]) {
+                    file << (lit.is_on() ? lit.value() : -lit.value()) << (index % 2 == 0 ? " " : "\nc spanning clause\n");
+                }
+                file << "0\n";
+            }
+        }
+
+        auto sequential           = make_solver_from_cnf_file(path, {}, 1);
+        const auto sequential_res = sequential.solve_next();
+        REQUIRE(sequential_res.has_value());
+        CHECK(satisfies(sequential_res.value(), m));
+
+        const auto threads = GENERATE(std::size_t {2}, std::size_t {3}, std::size_t {16});
+        auto parallel      = make_solver_from_cnf_file(path, {}, threads);
+        const auto res     = parallel.solve_next();
+        REQUIRE(res.has_value());
+        CHECK(signed_values(res.value()) == signed_values(sequential_res.value())); // same variable numbering as a sequential parsing
+        std::filesystem::remove(path);
+    }
+
+    SECTION("cnf file header is validated once") {
+        const auto path = std::filesystem::temp_directory_path() / "fabko_solver_builder_header_testcase.cnf";
+        std::ofstream {path} << "p cnf 2 2\n1 2 0\np cnf 2 2\n-1 -2 0\n";
+        CHECK_THROWS_AS(make_solver_from_cnf_file(path, {}, 4), std::runtime_error);
+        std::filesystem::remove(path);
+    }
+
+    SECTION("cnf file literals are validated against the header") {
+        const auto path = std::filesystem::temp_directory_path() / "fabko_solver_builder_variables_testcase.cnf";
+        std::ofstream {path} << "p cnf 2 2\n1 2 0\n-1 -3 0\n";
+        CHECK_THROWS_AS(make_solver_from_cnf_file(path, {}, 1), std::runtime_error);
+        CHECK_THROWS_AS(make_solver_from_cnf_file(path, {}, 2), std::runtime_error);
+        std::filesystem::remove(path);
+    }
+
+    SECTION("missing cnf file") {
+        CHECK_THROWS_AS(make_solver_from_cnf_file(std::filesystem::temp_directory_path() / "fabko_solver_builder_missing.cnf"), std::runtime_error);
+    }
+}
@@ -0,0 +1,145 @@
+// Dual Licensing Either :
+// - AGPL
+// or
+// - Subscription license for commercial usage (without requirement of licensing propagation).
+//   please contact ballandfys@protonmail.com for additional information about this subscription commercial licensing.
+//
+// Created by FyS on 18/10/26. License 2022-2026
+//
+// In the case no license has been purchased for the use (modification or distribution in any way) of the software stack
+// the APGL license is applying.
+//
+
+#include <algorithm>
+#include <ranges>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "common/logging.hh"
+#include "compiler/backend/sat/symmetry.hh"
+
+#include "sat_testcase_helpers.hh"
+
+using namespace fabko::compiler::sat;
+using namespace fabko::compiler::sat::testcase;
+
+TEST_CASE("test symmetry detection", "[compiler][backend][sat]") {
+    fabko::init_logger(spdlog::level::warn);
+
+    SECTION("pigeonhole :: pigeons and holes are interchangeable") {
+        const auto m          = make_pigeonhole(4, 3);
+        const auto symmetries = find_symmetries(m, 64);
+        REQUIRE_FALSE(symmetries.empty());
+        for (const auto& s : symmetries) {
+            CHECK_FALSE(s.moved.empty());
+            CHECK(is_symmetry(m, s));
+        }
+
+        // every variable is in the same orbit : the generators move every variable
+        std::vector<bool> moved(m.literals.size());
+        for (const auto& s : symmetries) {
+            for (const auto& [var, image] : s.moved) {
+                moved[static_cast<std::size_t>(var - 1)] = true;
+            }
+        }
+        CHECK(std::ranges::all_of(moved, std::identity {}));
+        CHECK(find_symmetries(m, 1).size() == 1);
+    }
+
+    SECTION("no symmetry") {
+        model m {.literals = {literal {1}, literal {2}, literal {3}}, .clauses = {{literal {1}, literal {2}}, {literal {-2}, literal {3}}}};
+        CHECK(find_symmetries(m, 64).empty());
+
+        // swapping 1 and 2 maps (1 v 2) onto itself but not (-2 v 3)
+        CHECK_FALSE(is_symmetry(m, symmetry {.moved = {{1, 2}, {2, 1}}}));
+        CHECK_FALSE(is_symmetry(m, symmetry {.moved = {{1, 2}}})); // not a permutation
+    }
+
+    SECTION("breaking predicates :: only the lex-leader assignments are kept") {
+        model m {.literals = {literal {1}, literal {2}}, .clauses = {{literal {1}, literal {2}}}};
+        const auto symmetries = find_symmetries(m, 64);
+        REQUIRE(symmetries.size() == 1);
+
+        std::int64_t next_var = 2;
+        CHECK(add_symmetry_breaking(m, symmetries, 32, [&] {
+            m.literals.emplace_back(++next_var);
+            return m.literals.back();
+        }) > 0);
+
+        solver s {m};
+        const std::vector<literal> larger {literal {1}, literal {-2}}; // symmetric to {-1, 2}, which is lexicographically smaller
+        CHECK(s.solve_with_assumptions(larger).error() == sat_error::unsatisfiable);
+        const std::vector<literal> smaller {literal {-1}, literal {2}};
+        CHECK(s.solve_with_assumptions(smaller).has_value());
+    }
+}
+
+TEST_CASE("test solver symmetry breaking", "[compiler][backend][sat]") {
+    fabko::init_logger(spdlog::level::warn);
+
+    SECTION("unsatisfiable :: the breaking predicates preserve the answer") {
+        auto symmetric                   = make_pigeonhole(6, 5);
+        auto plain                       = symmetric;
+        symmetric.conf.symmetry_breaking = true;
+
+        solver broken {std::move(symmetric)};
+        solver reference {std::move(plain)};
+        const auto res = broken.solve_next();
+        REQUIRE_FALSE(res.has_value());
+        CHECK(res.error() == sat_error::unsatisfiable);
+        CHECK(reference.solve_next().error() == sat_error::unsatisfiable);
+    }
+
+    SECTION("warm start :: nothing derived from the predicates is exported") {
+        auto m                   = make_pigeonhole(5, 5);
+        m.conf.symmetry_breaking = true;
+        m.conf.restart_threshold = 2;
+
+        solver s {std::move(m)};
+        REQUIRE(s.solve_next().has_value());
+        CHECK(s.learned_clauses().empty());
+        const auto phases = s.saved_phases();
+        CHECK(phases.size() == 25); // the auxiliary variables of the predicates are not part of the phases
+        CHECK(std::ranges::all_of(phases, [](const literal& lit) { return lit.value() <= 25; }));
+    }
+
+    SECTION("warm start :: the predicates are known by a solver built through the solver_builder") {
+        const auto m = make_pigeonhole(5, 5);
+        solver_context::configuration conf {};
+        conf.symmetry_breaking = true;
+        conf.restart_threshold = 2;
+
+        solver_builder builder {conf};
+        for (const auto& clause : m.clauses) {
+            builder.add_clause(clause);
+        }
+        auto s = std::move(builder).build(); // the solver is moved out of the builder once the predicates are added
+        REQUIRE(s.solve_next().has_value());
+        CHECK(s.learned_clauses().empty());
+    }
+
+    SECTION("satisfiable :: the solution found satisfies the model") {
+        auto m                   = make_pigeonhole(4, 4);
+        const auto clauses       = m.clauses;
+        m.conf.symmetry_breaking = true;
+
+        solver s {std::move(m)};
+        const auto res = s.solve_next();
+        REQUIRE(res.has_value());
+        CHECK(satisfies(clauses, res->literals));
+        // auxiliary variables of the predicates are numbered after the variables of the model
+        CHECK(res->literals.size() > 16);
+        CHECK(std::ranges::all_of(res->literals | std::views::drop(16), [](const literal& lit) { return lit.value() > 16; }));
+    }
+
+    SECTION("detection skipped on large models") {
+        auto m                        = make_pigeonhole(3, 3);
+        m.conf.symmetry_breaking      = true;
+        m.conf.symmetry_max_variables = 8;
+
+        solver s {std::move(m)};
+        const auto res = s.solve_next();
+        REQUIRE(res.has_value());
+        CHECK(res->literals.size() == 9);
+    }
+}
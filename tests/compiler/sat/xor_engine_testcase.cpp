@@ -0,0 +1,172 @@
+// Dual Licensing Either :
+// - AGPL
+// or
+// - Subscription license for commercial usage (without requirement of licensing propagation).
+//   please contact ballandfys@protonmail.com for additional information about this subscription commercial licensing.
+//
+// Created by FyS on 18/10/26. License 2022-2026
+//
+// In the case no license has been purchased for the use (modification or distribution in any way) of the software stack
+// the APGL license is applying.
+//
+
+#include <algorithm>
+#include <bit>
+#include <ranges>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "common/logging.hh"
+#include "compiler/backend/sat/solver.hh"
+
+using namespace fabko::compiler::sat;
+
+namespace {
+
+/**
+ * @return clauses encoding the XOR constraint : every assignment of the wrong parity is forbidden by a clause
+ */
+std::vector<std::vector<literal>> encode_xor(const std::vector<std::int64_t>& variables, bool parity) {
+    std::vector<std::vector<literal>> clauses;
+    for (std::uint32_t negated = 0; negated < (1U << variables.size()); ++negated) {
+        if ((std::popcount(negated) % 2 == 0) != parity) {
+            continue;
+        }
+        std::vector<literal> clause;
+        for (std::size_t i = 0; i < variables.size(); ++i) {
+            clause.emplace_back((negated >> i & 1) != 0 ? -variables[i] : variables[i]);
+        }
+        clauses.push_back(std::move(clause));
+    }
+    return clauses;
+}
+
+/**
+ * @return XOR constraints over overlapping triples of variables, the last one is the sum of all the others with the opposite parity : the
+ * system is inconsistent, which only a combination of all the constraints can show
+ */
+std::vector<xor_constraint> make_inconsistent_system(std::int64_t variables) {
+    std::vector<xor_constraint> system;
+    std::vector<std::int64_t> sum_count(static_cast<std::size_t>(variables + 1), 0);
+    bool sum_parity = false;
+    for (std::int64_t first = 1; first + 2 <= variables; ++first) {
+        const bool parity = first % 3 == 0;
+        system.push_back({.literals = {literal {first}, literal {first + 1}, literal {first + 2}}, .parity = parity});
+        sum_parity ^= parity;
+        for (std::int64_t var = first; var <= first + 2; ++var) {
+            ++sum_count[static_cast<std::size_t>(var)];
+        }
+    }
+    xor_constraint sum {.literals = {}, .parity = !sum_parity};
+    for (std::int64_t var = 1; var <= variables; ++var) {
+        if (sum_count[static_cast<std::size_t>(var)] % 2 == 1) {
+            sum.literals.emplace_back(var);
+        }
+    }
+    system.push_back(std::move(sum));
+    return system;
+}
+
+bool satisfies(const xor_constraint& constraint, const std::vector<literal>& solution) {
+    bool parity = false;
+    for (const auto& lit : constraint.literals) {
+        const auto it = std::ranges::find_if(solution, [&lit](const literal& assigned) { return assigned.value() == lit.value(); });
+        parity ^= it != solution.end() && it->is_on() == lit.is_on();
+    }
+    return parity == constraint.parity;
+}
+
+} // namespace
+
+TEST_CASE("test xor recognition", "[compiler][backend][sat]") {
+    fabko::init_logger(spdlog::level::warn);
+
+    SECTION("full adder sum") {
+        // sum <=> a xor b xor c as encoded by the cnf_encoder : a xor b xor c xor sum == 0
+        const auto clauses = encode_xor({1, 2, 3, 4}, false);
+        REQUIRE(clauses.size() == 8);
+
+        const auto xors = find_xor_constraints(clauses, 6);
+        REQUIRE(xors.size() == 1);
+        CHECK(xors[0].literals == std::vector {literal {1}, literal {2}, literal {3}, literal {4}});
+        CHECK_FALSE(xors[0].parity);
+    }
+
+    SECTION("incomplete encoding is not a XOR constraint") {
+        auto clauses = encode_xor({1, 2, 3}, true);
+        clauses.pop_back();
+        CHECK(find_xor_constraints(clauses, 6).empty());
+    }
+
+    SECTION("larger than the maximum size") {
+        CHECK(find_xor_constraints(encode_xor({1, 2, 3, 4, 5}, true), 4).empty());
+        CHECK(find_xor_constraints(encode_xor({1, 2, 3, 4, 5}, true), 5).size() == 1);
+    }
+}
+
+TEST_CASE("test xor gauss jordan propagation", "[compiler][backend][sat]") {
+    fabko::init_logger(spdlog::level::warn);
+
+    SECTION("native constraints :: inconsistent system found without any decision") {
+        model m {.literals = {}, .clauses = {}, .xors = make_inconsistent_system(12)};
+        for (std::int64_t var = 1; var <= 12; ++var) {
+            m.literals.emplace_back(var);
+        }
+        solver s {std::move(m)};
+        CHECK(s.solve_next().error() == sat_error::unsatisfiable);
+        CHECK(s.statistics().decisions == 0);
+    }
+
+    SECTION("recognized constraints :: inconsistent system found without any decision") {
+        model m;
+        for (std::int64_t var = 1; var <= 12; ++var) {
+            m.literals.emplace_back(var);
+        }
+        for (const auto& [literals, parity] : make_inconsistent_system(12)) {
+            const auto variables = literals | std::views::transform([](const literal& l) { return l.value(); }) | std::ranges::to<std::vector>();
+            auto clauses         = encode_xor(variables, parity);
+            m.clauses.insert(m.clauses.end(), clauses.begin(), clauses.end());
+        }
+        m.conf.xor_recognition = true;
+        m.conf.xor_max_size    = 12;
+
+        solver s {std::move(m)};
+        CHECK(s.solve_next().error() == sat_error::unsatisfiable);
+        CHECK(s.statistics().decisions == 0);
+    }
+
+    SECTION("satisfiable :: the solution satisfies the constraints and the clauses") {
+        std::vector<xor_constraint> xors {
+            {.literals = {literal {1}, literal {2}, literal {3}},  .parity = true },
+            {.literals = {literal {2}, literal {-4}, literal {5}}, .parity = false},
+            {.literals = {literal {1}, literal {5}, literal {6}},  .parity = true },
+            {.literals = {literal {3}, literal {4}, literal {6}},  .parity = true },
+        };
+        solver s {model {.literals = {}, .clauses = {{literal {1}, literal {4}}, {literal {-2}, literal {-6}}}}};
+        for (const auto& constraint : xors) {
+            s.add_xor(constraint);
+        }
+
+        const auto res = s.solve_next();
+        REQUIRE(res.has_value());
+        for (const auto& constraint : xors) {
+            CHECK(satisfies(constraint, res->literals));
+        }
+        const auto value_of = [&res](std::int64_t var) {
+            return std::ranges::find_if(res->literals, [var](const literal& assigned) { return assigned.value() == var; })->is_on();
+        };
+        CHECK((value_of(1) || value_of(4)));
+        CHECK((!value_of(2) || !value_of(6)));
+    }
+
+    SECTION("conflict analysis :: learned clauses from XOR explanations keep the answer sound") {
+        // the parity of the constraints forbids the clauses to be all satisfied together : the search has to learn through XOR explanations
+        solver s {model {
+            .literals = {},
+            .clauses  = {{literal {1}, literal {2}}, {literal {3}, literal {4}}, {literal {-1}, literal {-3}}},
+            .xors     = {{.literals = {literal {1}, literal {2}}, .parity = false}, {.literals = {literal {3}, literal {4}}, .parity = false},
+                         {.literals = {literal {2}, literal {4}}, .parity = false}},
+        }};
+        CHECK(s.solve_next().error() == sat_error::unsatisfiable);
+    }
+}
@@ -0,0 +1,167 @@
+// Dual Licensing Either :
+// - AGPL
+// or
+// - Subscription license for commercial usage (without requirement of licensing propagation).
+//   please contact ballandfys@protonmail.com for additional information about this subscription commercial licensing.
+//
+// Created by FyS on 18/10/26. License 2022-2026
+//
+// In the case no license has been purchased for the use (modification or distribution in any way) of the software stack
+// the APGL license is applying.
+//
+
+#include <algorithm>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include "common/logging.hh"
+#include "compiler/frontend/sat_builder/cnf_encoder.hh"
+
+using namespace fabko::compiler;
+using namespace fabko::compiler::sat_builder;
+
+namespace {
+
+sat::model to_model(const cnf_encoder& encoder) {
+    return sat::model {.literals = encoder.literals(), .clauses = encoder.clauses(), .cardinalities = encoder.cardinalities()};
+}
+
+bool is_satisfiable_with(const cnf_encoder& encoder, std::vector<sat::literal> assumptions) {
+    sat::solver s {to_model(encoder)};
+    return s.solve_with_assumptions(assumptions).has_value();
+}
+
+std::uint64_t integer_value(const sat::solver::result& res, std::span<const sat::literal> bits) {
+    std::uint64_t value {0};
+    for (std::size_t i = 0; i < bits.size(); ++i) {
+        const auto it = std::ranges::find(res.literals, bits[i]);
+        if (it != res.literals.end() && it->is_on()) {
+            value |= std::uint64_t {1} << i;
+        }
+    }
+    return value;
+}
+
+} // namespace
+
+TEST_CASE("test cnf_encoder cardinality", "[compiler][frontend][sat_builder]") {
+    fabko::init_logger(spdlog::level::warn);
+
+    const auto encoding = GENERATE(cardinality_encoding::sequential_counter,
+        cardinality_encoding::totalizer,
+        cardinality_encoding::cardinality_network,
+        cardinality_encoding::native);
+
+    cnf_encoder encoder;
+    const std::vector lits {encoder.make_literal(), encoder.make_literal(), encoder.make_literal(), encoder.make_literal(), encoder.make_literal()};
+
+    SECTION("at most") {
+        encoder.at_most(lits, 2, encoding);
+
+        CHECK(is_satisfiable_with(encoder, {lits[0], lits[3]}));
+        CHECK(is_satisfiable_with(encoder, {lits[1], lits[4], lits[0].negation(), lits[2].negation()}));
+        CHECK_FALSE(is_satisfiable_with(encoder, {lits[0], lits[2], lits[4]}));
+    }
+
+    SECTION("at least") {
+        encoder.at_least(lits, 3, encoding);
+
+        CHECK(is_satisfiable_with(encoder, {lits[0].negation(), lits[1].negation()}));
+        CHECK_FALSE(is_satisfiable_with(encoder, {lits[0].negation(), lits[1].negation(), lits[2].negation()}));
+    }
+
+    SECTION("exactly") {
+        encoder.exactly(lits, 1, encoding);
+
+        CHECK(is_satisfiable_with(encoder, {lits[2]}));
+        CHECK_FALSE(is_satisfiable_with(encoder, {lits[2], lits[3]}));
+        CHECK_FALSE(is_satisfiable_with(encoder, {lits[0].negation(), lits[1].negation(), lits[2].negation(), lits[3].negation(), lits[4].negation()}));
+    }
+}
+
+TEST_CASE("test cnf_encoder pseudo-Boolean", "[compiler][frontend][sat_builder]") {
+    fabko::init_logger(spdlog::level::warn);
+
+    const auto encoding = GENERATE(pb_encoding::bdd, pb_encoding::adder);
+
+    cnf_encoder encoder;
+    const std::vector<pb_term> terms {
+        {.lit = encoder.make_literal(), .weight = 5},
+        {.lit = encoder.make_literal(), .weight = 3},
+        {.lit = encoder.make_literal(), .weight = 3},
+        {.lit = encoder.make_literal(), .weight = 1},
+    };
+
+    SECTION("at most") {
+        encoder.pb_at_most(terms, 6, encoding);
+
+        CHECK(is_satisfiable_with(encoder, {terms[0].lit, terms[3].lit}));
+        CHECK(is_satisfiable_with(encoder, {terms[1].lit, terms[2].lit}));
+        CHECK_FALSE(is_satisfiable_with(encoder, {terms[0].lit, terms[1].lit}));
+        CHECK_FALSE(is_satisfiable_with(encoder, {terms[1].lit, terms[2].lit, terms[3].lit}));
+    }
+
+    SECTION("at least") {
+        encoder.pb_at_least(terms, 8, encoding);
+
+        CHECK(is_satisfiable_with(encoder, {terms[1].lit.negation()}));
+        CHECK_FALSE(is_satisfiable_with(encoder, {terms[0].lit.negation()}));
+    }
+}
+
+TEST_CASE("test cnf_encoder pseudo-Boolean size", "[compiler][frontend][sat_builder]") {
+    fabko::init_logger(spdlog::level::warn);
+
+    // distinct weights close to the powers of two : every partial sum is distinct, a decision diagram would be exponential in the terms
+    cnf_encoder encoder;
+    std::vector<pb_term> terms;
+    std::uint64_t total = 0;
+    for (std::uint64_t i = 0; i < 40; ++i) {
+        terms.push_back({.lit = encoder.make_literal(), .weight = (std::uint64_t {1} << i) + i});
+        total += terms.back().weight;
+    }
+    encoder.pb_at_most(terms, total / 2);
+
+    CHECK(encoder.clauses().size() < 10000);
+    CHECK(is_satisfiable_with(encoder, {terms[39].lit}));                 // the heaviest term alone is about the half of the total
+    CHECK_FALSE(is_satisfiable_with(encoder, {terms[39].lit, terms[38].lit})); // three quarters of the total
+}
+
+TEST_CASE("test cnf_encoder integer", "[compiler][frontend][sat_builder]") {
+    fabko::init_logger(spdlog::level::warn);
+
+    cnf_encoder encoder;
+    const auto money = encoder.make_integer(4);
+
+    SECTION("comparisons with constants") {
+        encoder.compare(money, fabl::ir::constraint_operation::GREATER_THAN, 9);
+        encoder.compare(money, fabl::ir::constraint_operation::LESS_THAN_OR_EQUAL, 11);
+        encoder.compare(money, fabl::ir::constraint_operation::DIFFERENT, 10);
+
+        sat::solver s {to_model(encoder)};
+        const auto res = s.solve_next();
+        REQUIRE(res.has_value());
+        CHECK(integer_value(res.value(), money) == 11);
+    }
+
+    SECTION("resource transfer") {
+        encoder.compare(money, fabl::ir::constraint_operation::EQUAL, 12);
+        const auto remaining = encoder.subtract_constant(money, 5);
+        const auto refunded  = encoder.add_constant(remaining, 2);
+
+        sat::solver s {to_model(encoder)};
+        const auto res = s.solve_next();
+        REQUIRE(res.has_value());
+        CHECK(integer_value(res.value(), remaining) == 7);
+        CHECK(integer_value(res.value(), refunded) == 9);
+    }
+
+    SECTION("transfer exceeding the resource") {
+        encoder.compare(money, fabl::ir::constraint_operation::LESS_THAN, 4);
+        std::ignore = encoder.subtract_constant(money, 4);
+
+        sat::solver s {to_model(encoder)};
+        CHECK_FALSE(s.solve_next().has_value());
+    }
+}
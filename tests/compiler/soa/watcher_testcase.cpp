@@ -24,9 +24,9 @@ TEST_CASE("test watcher", "[compiler][backend][sat]") {
         fabko::compiler::sat::literal l2 {2};
         fabko::compiler::sat::literal l3 {3};
 
-        auto var_id1 = vars.insert(l1, fabko::compiler::sat::assignment::off, fabko::compiler::sat::assignment_context {}, fabko::compiler::metadata {});
-        auto var_id2 = vars.insert(l2, fabko::compiler::sat::assignment::off, fabko::compiler::sat::assignment_context {}, fabko::compiler::metadata {});
-        auto var_id3 = vars.insert(l3, fabko::compiler::sat::assignment::off, fabko::compiler::sat::assignment_context {}, fabko::compiler::metadata {});
+        auto var_id1 = vars.insert(l1, fabko::compiler::sat::assignment::off, fabko::compiler::sat::assignment_context {}, fabko::compiler::sat::variable_heuristics {}, fabko::compiler::metadata {});
+        auto var_id2 = vars.insert(l2, fabko::compiler::sat::assignment::off, fabko::compiler::sat::assignment_context {}, fabko::compiler::sat::variable_heuristics {}, fabko::compiler::metadata {});
+        auto var_id3 = vars.insert(l3, fabko::compiler::sat::assignment::off, fabko::compiler::sat::assignment_context {}, fabko::compiler::sat::variable_heuristics {}, fabko::compiler::metadata {});
 
         fabko::compiler::sat::clause clause {
             {l1,      l2,      l3     },
@@ -42,9 +42,9 @@ TEST_CASE("test watcher", "[compiler][backend][sat]") {
         fabko::compiler::sat::literal l2 {2};
         fabko::compiler::sat::literal l3 {3};
 
-        auto var_id1 = vars.insert(l1, fabko::compiler::sat::assignment::off, fabko::compiler::sat::assignment_context {}, fabko::compiler::metadata {});
-        auto var_id2 = vars.insert(l2, fabko::compiler::sat::assignment::not_assigned, fabko::compiler::sat::assignment_context {}, fabko::compiler::metadata {});
-        auto var_id3 = vars.insert(l3, fabko::compiler::sat::assignment::off, fabko::compiler::sat::assignment_context {}, fabko::compiler::metadata {});
+        auto var_id1 = vars.insert(l1, fabko::compiler::sat::assignment::off, fabko::compiler::sat::assignment_context {}, fabko::compiler::sat::variable_heuristics {}, fabko::compiler::metadata {});
+        auto var_id2 = vars.insert(l2, fabko::compiler::sat::assignment::not_assigned, fabko::compiler::sat::assignment_context {}, fabko::compiler::sat::variable_heuristics {}, fabko::compiler::metadata {});
+        auto var_id3 = vars.insert(l3, fabko::compiler::sat::assignment::off, fabko::compiler::sat::assignment_context {}, fabko::compiler::sat::variable_heuristics {}, fabko::compiler::metadata {});
 
         fabko::compiler::sat::clause clause {
             {l1,      l2,      l3     },
@@ -62,9 +62,9 @@ TEST_CASE("test watcher", "[compiler][backend][sat]") {
         fabko::compiler::sat::literal l2 {2};
         fabko::compiler::sat::literal l3 {3};
 
-        auto var_id1 = vars.insert(l1, fabko::compiler::sat::assignment::off, fabko::compiler::sat::assignment_context {}, fabko::compiler::metadata {});
-        auto var_id2 = vars.insert(l2, fabko::compiler::sat::assignment::not_assigned, fabko::compiler::sat::assignment_context {}, fabko::compiler::metadata {});
-        auto var_id3 = vars.insert(l3, fabko::compiler::sat::assignment::not_assigned, fabko::compiler::sat::assignment_context {}, fabko::compiler::metadata {});
+        auto var_id1 = vars.insert(l1, fabko::compiler::sat::assignment::off, fabko::compiler::sat::assignment_context {}, fabko::compiler::sat::variable_heuristics {}, fabko::compiler::metadata {});
+        auto var_id2 = vars.insert(l2, fabko::compiler::sat::assignment::not_assigned, fabko::compiler::sat::assignment_context {}, fabko::compiler::sat::variable_heuristics {}, fabko::compiler::metadata {});
+        auto var_id3 = vars.insert(l3, fabko::compiler::sat::assignment::not_assigned, fabko::compiler::sat::assignment_context {}, fabko::compiler::sat::variable_heuristics {}, fabko::compiler::metadata {});
 
         fabko::compiler::sat::clause clause {
             {l1,      l2,      l3     },
@@ -84,9 +84,9 @@ TEST_CASE("test watcher", "[compiler][backend][sat]") {
         fabko::compiler::sat::literal l2 {2};
         fabko::compiler::sat::literal l3 {3};
 
-        auto var_id1 = vars.insert(l1, fabko::compiler::sat::assignment::not_assigned, fabko::compiler::sat::assignment_context {}, fabko::compiler::metadata {});
-        auto var_id2 = vars.insert(l2, fabko::compiler::sat::assignment::not_assigned, fabko::compiler::sat::assignment_context {}, fabko::compiler::metadata {});
-        auto var_id3 = vars.insert(l3, fabko::compiler::sat::assignment::not_assigned, fabko::compiler::sat::assignment_context {}, fabko::compiler::metadata {});
+        auto var_id1 = vars.insert(l1, fabko::compiler::sat::assignment::not_assigned, fabko::compiler::sat::assignment_context {}, fabko::compiler::sat::variable_heuristics {}, fabko::compiler::metadata {});
+        auto var_id2 = vars.insert(l2, fabko::compiler::sat::assignment::not_assigned, fabko::compiler::sat::assignment_context {}, fabko::compiler::sat::variable_heuristics {}, fabko::compiler::metadata {});
+        auto var_id3 = vars.insert(l3, fabko::compiler::sat::assignment::not_assigned, fabko::compiler::sat::assignment_context {}, fabko::compiler::sat::variable_heuristics {}, fabko::compiler::metadata {});
 
         fabko::compiler::sat::clause clause {
             {l1,      l2,      l3     },
@@ -147,7 +147,7 @@ TEST_CASE("test watcher", "[compiler][backend][sat]") {
     SECTION("test single element in clause : size 1 if not assigned") {
         fabko::compiler::sat::literal l1 {1};
 
-        auto var_id1 = vars.insert(l1, fabko::compiler::sat::assignment::not_assigned, fabko::compiler::sat::assignment_context {}, fabko::compiler::metadata {});
+        auto var_id1 = vars.insert(l1, fabko::compiler::sat::assignment::not_assigned, fabko::compiler::sat::assignment_context {}, fabko::compiler::sat::variable_heuristics {}, fabko::compiler::metadata {});
 
         fabko::compiler::sat::clause clause {{l1}, {var_id1}};
         fabko::compiler::sat::clause_watcher watcher {vars, clause};
@@ -157,4 +157,27 @@ TEST_CASE("test watcher", "[compiler][backend][sat]") {
         CHECK(watcher.get_watched().size() == 1);
         CHECK(watcher.get_watched()[0].offset == var_id1.offset);
     }
+
+    SECTION("test blocker :: first literal of the clause until a satisfied literal is recorded") {
+        fabko::compiler::sat::literal l1 {1};
+        fabko::compiler::sat::literal l2 {-2};
+
+        auto var_id1 = vars.insert(l1, fabko::compiler::sat::assignment::off, fabko::compiler::sat::assignment_context {}, fabko::compiler::sat::variable_heuristics {}, fabko::compiler::metadata {});
+        auto var_id2 = vars.insert(l2, fabko::compiler::sat::assignment::off, fabko::compiler::sat::assignment_context {}, fabko::compiler::sat::variable_heuristics {}, fabko::compiler::metadata {});
+
+        fabko::compiler::sat::clause clause {
+            {l1,      l2     },
+            {var_id1, var_id2}
+        };
+        fabko::compiler::sat::clause_watcher watcher {vars, clause};
+
+        CHECK(watcher.size() == 0);
+        CHECK(watcher.blocker().first.value() == 1);
+        CHECK(watcher.blocker().second.offset == var_id1.offset);
+
+        watcher.set_blocker(clause.get_literals()[1]);
+
+        CHECK(watcher.blocker().first.is_off());
+        CHECK(watcher.blocker().second.offset == var_id2.offset);
+    }
 }
\ No newline at end of file